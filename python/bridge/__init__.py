@@ -42,5 +42,5 @@ def load(name, win_lib=None, linux_lib=None, osx_lib=None):
         print("lib \"{0}\" not found".format(libfile))
 
 
-load('bridge_wrapper', win_lib='BridgeLib.dll')
+load('bridge_wrapper', win_lib='BridgeLib.dll', linux_lib='libBridgeLib.so', osx_lib='libBridgeLib.dylib')
 load('oculus_legacy_base', win_lib='OculusVR.dll', linux_lib='libOculusVR.so', osx_lib='libOculusVR.dylib')
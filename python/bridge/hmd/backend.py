@@ -11,9 +11,15 @@ from . import HMD as baseHMD
 import bridge_wrapper as bridge
 
 from ctypes import (
+        byref,
+        c_char_p,
+        c_double,
         c_float,
+        c_int,
         c_long,
+        c_uint,
         POINTER,
+        Structure,
         )
 
 
@@ -24,6 +30,119 @@ class Backend:
     OSVR = 3
     OPENVR = 4
     OPENHMD = 5
+    SIMULATED = 6
+    REPLAY = 7
+
+
+class Predictor:
+    NONE = 0
+    CONSTANT_VELOCITY = 1
+    CONSTANT_ACCELERATION = 2
+    ANGULAR_VELOCITY = 3
+
+
+class FrameState(Structure):
+    """
+    Mirror of HMD_FrameState (HMD_Bridge_API.h)
+    """
+    ORIENTATION = 1 << 0
+    YAW_PITCH_ROLL = 1 << 1
+    POSITION = 1 << 2
+    VIEW_MATRIX = 1 << 3
+    LEFT_HANDED = 1 << 4
+    INVERSE_VIEW_MATRIX = 1 << 5
+
+    _fields_ = [
+            ('flags', c_uint),
+            ('frame', c_uint),
+            ('display_time', c_double),
+            ('status', c_uint),
+            ('orientation', (c_float * 4) * 2),
+            ('yaw_pitch_roll', (c_float * 3) * 2),
+            ('position', (c_float * 3) * 2),
+            ('view_matrix', (c_float * 16) * 2),
+            ('inverse_view_matrix', (c_float * 16) * 2),
+            ]
+
+
+class FrameTiming(Structure):
+    """
+    Mirror of HMD_FrameTiming (HMD_Bridge_API.h), times in seconds
+    """
+    _fields_ = [
+            ('frame', c_uint),
+            ('should_render', c_int),
+            ('predicted_display_time', c_double),
+            ('period', c_double),
+            ]
+
+
+class SubmitStats(Structure):
+    """
+    Mirror of HMD_SubmitStats (HMD_Bridge_API.h), times in seconds
+    """
+    _fields_ = [
+            ('frames', c_uint),
+            ('stalls', c_uint),
+            ('wait_time', c_double),
+            ('submit_time', c_double),
+            ('submit_time_average', c_double),
+            ('submit_interval', c_double),
+            ]
+
+
+class GPUTiming(Structure):
+    """
+    Mirror of HMD_GPUTiming (HMD_Bridge_API.h), times in seconds
+    """
+    _fields_ = [
+            ('last', c_double),
+            ('average', c_double),
+            ('p99', c_double),
+            ]
+
+
+class GPUStats(Structure):
+    """
+    Mirror of HMD_GPUStats (HMD_Bridge_API.h)
+    """
+    _fields_ = [
+            ('frames', c_uint),
+            ('dropped', c_uint),
+            ('eye', GPUTiming * 2),
+            ('submit', GPUTiming),
+            ]
+
+
+class ResolutionConfig(Structure):
+    """
+    Mirror of HMD_ResolutionConfig (HMD_Bridge_API.h)
+    """
+    _fields_ = [
+            ('min_scale', c_float),
+            ('max_scale', c_float),
+            ('utilization', c_float),
+            ('target_frame_time', c_double),
+            ]
+
+
+class LayerDesc(Structure):
+    """
+    Mirror of HMD_LayerDesc (HMD_Bridge_API.h)
+    """
+    QUAD = 0
+    STATIC = 1
+
+    _fields_ = [
+            ('type', c_uint),
+            ('width', c_uint),
+            ('height', c_uint),
+            ('size', c_float * 2),
+            ('orientation', c_float * 4),
+            ('position', c_float * 3),
+            ('is_head_locked', c_int),
+            ('update_rate', c_float),
+            ]
 
 
 class HMD(baseHMD):
@@ -36,7 +155,10 @@ class HMD(baseHMD):
         if self._backend is None:
             assert False, "Backend not fully implemented"
 
-        self._device = bridge.HMD_new(self._backend)
+        self._device = self._new()
+
+    def _new(self):
+        return bridge.HMD_new(self._backend)
 
     def __del__(self):
         bridge.HMD_del(self._device)
@@ -57,23 +179,19 @@ class HMD(baseHMD):
     def height_right(self):
         return bridge.HMD_heightRight(self._device)
 
-    def _getProjectionMatrix(self, near, far, bridge_func):
-        arr = (c_float * 16)(*range(16))
-        bridge_func(self._device, c_float(near), c_float(far), arr)
-        return [i for i in arr]
-
     def _updateProjectionMatrix(self, near, far):
-        self.projection_matrix_left = self._getProjectionMatrix(
-                near, far, bridge.HMD_projectionMatrixLeft)
+        matrix_ptr = [(c_float * 16)(), (c_float * 16)()]
+        bridge.HMD_projectionMatrices(self._device, c_float(near), c_float(far), matrix_ptr[0], matrix_ptr[1])
 
-        self.projection_matrix_right = self._getProjectionMatrix(
-                near, far, bridge.HMD_projectionMatrixRight)
+        self.projection_matrix_left = list(matrix_ptr[0])
+        self.projection_matrix_right = list(matrix_ptr[1])
 
-    def setup(self, color_texture_left, color_texture_right):
+    def setup(self, color_texture_left=0, color_texture_right=0):
         """
         Initialize device
 
-        :param color_texture_left: color texture created externally with the framebuffer object data
+        :param color_texture_left: color texture created externally with the framebuffer object data,
+                                   0 to render directly into the device textures (see acquireEyeTexture)
         :type color_texture_left: GLuint
         :param color_texture_right: color texture created externally with the framebuffer object data
         :type color_texture_right: GLuint
@@ -82,6 +200,186 @@ class HMD(baseHMD):
         """
         return bridge.HMD_setup(self._device, color_texture_left, color_texture_right)
 
+    def setupSideBySide(self, color_texture=0):
+        """
+        Initialize device with both eyes side by side in a single texture, see eyeViewport
+
+        :param color_texture: color texture created externally with the framebuffer object data,
+                              0 to render directly into the device texture (see acquireEyeTexture)
+        :type color_texture: GLuint
+        :return: return True if the device was properly initialized
+        :rtype: bool
+        """
+        return bridge.HMD_setupSideBySide(self._device, color_texture)
+
+    def samplesSet(self, samples):
+        """
+        Multisampled eye textures, before setup. In copy mode the color textures are
+        GL_TEXTURE_2D_MULTISAMPLE (GL_SRGB8_ALPHA8), in direct mode acquireEyeTexture returns
+        multisampled textures. frameReady resolves them in its copy to the device
+
+        :param samples: per pixel, 1 for none
+        :type samples: int
+        :return: False if the backend can't have that many samples
+        :rtype: bool
+        """
+        return bridge.HMD_samplesSet(self._device, samples)
+
+    def samplesGet(self):
+        """
+        :rtype: int
+        """
+        return bridge.HMD_samplesGet(self._device)
+
+    def eyeViewport(self, eye):
+        """
+        Region of the eye texture the eye is rendered in
+
+        :param eye: 0 for left, 1 for right
+        :type eye: int
+        :return: x, y, width, height
+        :rtype: tuple(int, int, int, int)
+        """
+        viewport = (c_int * 4)()
+        bridge.HMD_eyeViewport(self._device, eye, viewport)
+        return tuple(viewport)
+
+    def resolutionStart(self, min_scale, max_scale=1.0, utilization=0.0, target_frame_time=0.0):
+        """
+        Dynamic resolution, before setup. The eye textures are allocated at max_scale,
+        and eyeViewport shrinks when the frames take too long
+
+        :param min_scale: lowest pixel density, relative to the recommended one
+        :type min_scale: float
+        :param max_scale: highest pixel density
+        :type max_scale: float
+        :param utilization: share of the frame time a frame may take, 0.9 if 0
+        :type utilization: float
+        :param target_frame_time: in seconds, 0 for the refresh period of the device
+        :type target_frame_time: float
+        :rtype: bool
+        """
+        config = ResolutionConfig(min_scale, max_scale, utilization, target_frame_time)
+        return bridge.HMD_resolutionStart(self._device, byref(config))
+
+    def resolutionStop(self):
+        """
+        The viewports cover the eye textures again
+        """
+        bridge.HMD_resolutionStop(self._device)
+
+    def resolutionScale(self):
+        """
+        :return: current pixel density
+        :rtype: float
+        """
+        return bridge.HMD_resolutionScale(self._device)
+
+    def resolutionGPUTime(self, time):
+        """
+        GPU time of the current frame, taken into account by the next frameReady
+
+        :param time: in seconds
+        :type time: float
+        """
+        bridge.HMD_resolutionGPUTime(self._device, c_double(time))
+
+    def layerCreate(self, desc):
+        """
+        Compositor layer drawn over the eyes
+
+        :param desc: type, texture size, quad size and pose, update rate
+        :type desc: LayerDesc
+        :return: layer id, or -1
+        :rtype: int
+        """
+        return bridge.HMD_layerCreate(self._device, byref(desc))
+
+    def layerDestroy(self, layer):
+        """
+        :rtype: bool
+        """
+        return bridge.HMD_layerDestroy(self._device, layer)
+
+    def layerPose(self, layer, orientation, position):
+        """
+        Move the layer, in the units of the poses
+
+        :param orientation: w, x, y, z
+        :type orientation: list(float)
+        :param position: x, y, z
+        :type position: list(float)
+        :rtype: bool
+        """
+        return bridge.HMD_layerPose(self._device, layer, (c_float * 4)(*orientation), (c_float * 3)(*position))
+
+    def layerDue(self, layer):
+        """
+        Whether the update rate of the layer asks for a new texture
+
+        :rtype: bool
+        """
+        return bridge.HMD_layerDue(self._device, layer)
+
+    def layerAcquireTexture(self, layer):
+        """
+        Texture to render the layer into
+
+        :return: texture name, 0 for a static layer already rendered
+        :rtype: int
+        """
+        return bridge.HMD_layerAcquireTexture(self._device, layer)
+
+    def layerReleaseTexture(self, layer):
+        """
+        The layer is rendered, it is displayed from the next frame on
+
+        :rtype: bool
+        """
+        return bridge.HMD_layerReleaseTexture(self._device, layer)
+
+    def acquireEyeTexture(self, eye):
+        """
+        Texture to render the eye into for the current frame, when setup had no color textures
+
+        :param eye: 0 for left, 1 for right
+        :type eye: int
+        :return: return the texture, or 0 if the device has no direct rendering
+        :rtype: GLuint
+        """
+        return bridge.HMD_acquireEyeTexture(self._device, eye)
+
+    def releaseEyeTexture(self, eye):
+        """
+        The eye is rendered, frameReady releases the eyes still acquired
+
+        :param eye: 0 for left, 1 for right
+        :type eye: int
+        :return: return False if the eye texture was not acquired
+        :rtype: bool
+        """
+        return bridge.HMD_releaseEyeTexture(self._device, eye)
+
+    def framebufferBindings(self, draw_framebuffer, read_framebuffer):
+        """
+        Framebuffers bound when calling setup and frameReady,
+        so the bridge does not need to query them every frame
+
+        :param draw_framebuffer: draw framebuffer to restore
+        :type draw_framebuffer: GLuint
+        :param read_framebuffer: read framebuffer to restore
+        :type read_framebuffer: GLuint
+        """
+        bridge.HMD_framebufferBindings(self._device, draw_framebuffer, read_framebuffer)
+
+    def glCalls(self):
+        """
+        Number of GL calls the bridge made during the last frame
+
+        :rtype: int
+        """
+        return bridge.HMD_glCalls(self._device)
+
     def update(self):
         """
         Get fresh tracking data
@@ -89,23 +387,152 @@ class HMD(baseHMD):
         :return: return left orientation, left_position, right_orientation, right_position
         :rtype: tuple(list(4), list(3), list(4), list(3))
         """
+        state = self.frameState(FrameState.ORIENTATION | FrameState.POSITION)
+
+        if state:
+            self._orientation[0] = list(state.orientation[0])
+            self._orientation[1] = list(state.orientation[1])
+            self._position[0] = list(state.position[0])
+            self._position[1] = list(state.position[1])
+
+        return super(HMD, self).update()
 
-        orientation_ptr = [None, None]
-        position_ptr = [None, None]
+    def frameState(self, flags):
+        """
+        Sample the tracking once for a new frame, and fill all the requested representations
 
-        orientation_ptr[0] = (c_float * 4)(*range(4))
-        orientation_ptr[1] = (c_float * 4)(*range(4))
+        :param flags: representations to fill, combination of FrameState flags
+        :type flags: int
+        :return: return the frame state, or None if the device is not tracked
+        :rtype: :class:`FrameState`
+        """
+        state = FrameState()
+        state.flags = flags
 
-        position_ptr[0] = (c_float * 3)(*range(3))
-        position_ptr[1] = (c_float * 3)(*range(3))
+        if bridge.HMD_frameState(self._device, byref(state)):
+            return state
+        return None
 
-        if bridge.HMD_update(self._device, orientation_ptr[0], position_ptr[0], orientation_ptr[1], position_ptr[1]):
-            self._orientation[0] = list(orientation_ptr[0])
-            self._orientation[1] = list(orientation_ptr[1])
-            self._position[0] = list(position_ptr[0])
-            self._position[1] = list(position_ptr[1])
+    def waitFrame(self):
+        """
+        Block until it is time to start the next frame
 
-        return super(HMD, self).update()
+        :return: return the frame timing, or None on failure
+        :rtype: :class:`FrameTiming`
+        """
+        timing = FrameTiming()
+
+        if bridge.HMD_waitFrame(self._device, byref(timing)):
+            return timing
+        return None
+
+    def beginFrame(self, flags):
+        """
+        Latch the poses of the frame returned by waitFrame
+
+        :param flags: representations to fill, combination of FrameState flags
+        :type flags: int
+        :return: return the frame state, or None if the device is not tracked
+        :rtype: :class:`FrameState`
+        """
+        state = FrameState()
+        state.flags = flags
+
+        if bridge.HMD_beginFrame(self._device, byref(state)):
+            return state
+        return None
+
+    def endFrame(self):
+        """
+        Submit the frame started with beginFrame
+
+        :return: return True if success
+        :rtype: bool
+        """
+        return bridge.HMD_endFrame(self._device)
+
+    def trackingStart(self, rate_hz):
+        """
+        Sample the tracking in a background thread, update() then reads the latest sample
+
+        :param rate_hz: sampling rate, usually the sensor rate
+        :type rate_hz: float
+        :return: return True if the thread started
+        :rtype: bool
+        """
+        return bridge.HMD_trackingStart(self._device, c_float(rate_hz))
+
+    def trackingStop(self):
+        """
+        Stop the tracking thread, update() queries the tracking again
+        """
+        bridge.HMD_trackingStop(self._device)
+
+    def predictorSet(self, predictor, horizon):
+        """
+        Predict the poses ahead of the newest tracked sample, for backends without native prediction
+
+        :param predictor: prediction model, see :class:`Predictor`
+        :type predictor: int
+        :param horizon: prediction horizon in seconds
+        :type horizon: float
+        """
+        bridge.HMD_predictorSet(self._device, predictor, c_double(horizon))
+
+    def recordingStart(self, filepath):
+        """
+        Record every tracking sample to a trace file, written in the background
+
+        :param filepath: trace file, overwritten if it exists
+        :type filepath: str
+        :return: return True if the file could be created
+        :rtype: bool
+        """
+        return bridge.HMD_recordingStart(self._device, c_char_p(filepath.encode('utf-8')))
+
+    def recordingStop(self):
+        """
+        Write the pending samples and close the trace file
+        """
+        bridge.HMD_recordingStop(self._device)
+
+    @property
+    def time(self):
+        """
+        Current time in seconds, in the clock of the tracking samples
+        """
+        return bridge.HMD_time(self._device)
+
+    def poseAt(self, time):
+        """
+        Poses interpolated from the history of tracked samples, without querying the tracking
+
+        :param time: time in seconds, see :attr:`time`
+        :type time: float
+        :return: return left orientation, left_position, right_orientation, right_position, or None if there is no history
+        :rtype: tuple(list(4), list(3), list(4), list(3))
+        """
+        orientation_ptr = [(c_float * 4)(), (c_float * 4)()]
+        position_ptr = [(c_float * 3)(), (c_float * 3)()]
+
+        if bridge.HMD_poseAt(self._device, c_double(time), orientation_ptr[0], position_ptr[0], orientation_ptr[1], position_ptr[1]):
+            return list(orientation_ptr[0]), list(position_ptr[0]), list(orientation_ptr[1]), list(position_ptr[1])
+        return None
+
+    def viewMatrix(self, is_right_hand=True):
+        """
+        View matrices of the current frame, computed on demand by the bridge
+
+        :param is_right_hand: right handed coordinate system
+        :type is_right_hand: bool
+        :return: return left and right column-major matrices, or None before the first tracked frame
+        :rtype: tuple(list(16), list(16))
+        """
+        matrix_ptr = [(c_float * 16)(), (c_float * 16)()]
+
+        if bridge.HMD_viewMatrix(self._device, is_right_hand, matrix_ptr[0], matrix_ptr[1]):
+            return list(matrix_ptr[0]), list(matrix_ptr[1])
+        return None
 
     def frameReady(self):
         """
@@ -116,6 +543,44 @@ class HMD(baseHMD):
         """
         return bridge.HMD_frameReady(self._device)
 
+    def submitStart(self):
+        """
+        Submit the frames from a background thread, frameReady only hands them over.
+        In copy mode the color textures must not be rendered into before the frame is submitted
+
+        :return: return True if the submit thread is running
+        :rtype: bool
+        """
+        return bridge.HMD_submitStart(self._device)
+
+    def submitStop(self):
+        """
+        Submit the frames from frameReady again, after the frame in flight
+        """
+        bridge.HMD_submitStop(self._device)
+
+    def submitStats(self):
+        """
+        Frame pacing of frameReady
+
+        :rtype: SubmitStats
+        """
+        stats = SubmitStats()
+        bridge.HMD_submitStats(self._device, byref(stats))
+        return stats
+
+    def gpuStats(self):
+        """
+        GPU time of the GL work of the bridge, read back a few frames late
+
+        :return: the stats, or None if the backend has no timer queries
+        :rtype: GPUStats
+        """
+        stats = GPUStats()
+        if not bridge.HMD_gpuStats(self._device, byref(stats)):
+            return None
+        return stats
+
     def reCenter(self):
         """
         Re-center the HMD device
@@ -132,3 +597,9 @@ class HMD(baseHMD):
         explicitly defines
         """
         bridge.HMD_new.restype = POINTER(c_long)
+        bridge.HMD_newSimulated.restype = POINTER(c_long)
+        bridge.HMD_newReplay.restype = POINTER(c_long)
+        bridge.HMD_newPlugin.restype = POINTER(c_long)
+        bridge.HMD_time.restype = c_double
+        bridge.HMD_layerAcquireTexture.restype = c_uint
+        bridge.HMD_resolutionScale.restype = c_float
@@ -0,0 +1,82 @@
+"""
+Log
+===
+
+Messages of the bridge and of its plugins, delivered by a background
+thread of the bridge to a sink, the standard output by default
+"""
+
+import bridge_wrapper as bridge
+
+from ctypes import (
+        CFUNCTYPE,
+        c_char_p,
+        c_int,
+        c_ulonglong,
+        c_void_p,
+        )
+
+# eHMDLogLevel
+DEBUG = 0
+INFO = 1
+WARNING = 2
+ERROR = 3
+NONE = 4
+
+_SINK = CFUNCTYPE(None, c_int, c_char_p, c_void_p)
+
+# the callback of the bridge, kept alive as long as it is set
+_sink = None
+
+
+def set_sink(sink):
+    """
+    Function receiving the messages, called from the log thread of the bridge
+
+    :param sink: called with the level and the message, None for the standard output
+    :type sink: callable(int, str)
+    """
+    global _sink
+
+    if sink:
+        callback = _SINK(lambda level, message, user_data: sink(level, message.decode('utf-8', 'replace')))
+    else:
+        callback = None
+
+    # the messages logged so far go to the previous sink, before it is released
+    bridge.HMD_logSink(callback, None)
+    _sink = callback
+
+
+def set_level(level):
+    """
+    Ignore the messages below the level, NONE ignores all of them
+
+    :type level: int
+    """
+    bridge.HMD_logLevel(level)
+
+
+def flush():
+    """
+    Wait until the messages logged so far are in the sink
+    """
+    bridge.HMD_logFlush()
+
+
+def dropped():
+    """
+    :return: messages dropped because the log thread was behind
+    :rtype: int
+    """
+    bridge.HMD_logDropped.restype = c_ulonglong
+    return bridge.HMD_logDropped()
+
+
+def shutdown():
+    """
+    Stop the log thread of the bridge, once the messages logged so far are
+    in the sink: the messages are delivered by the thread logging them from
+    then on
+    """
+    bridge.HMD_logShutdown()
@@ -0,0 +1,58 @@
+"""
+Plugin
+======
+
+Device whose backend is a plugin of the bridge, a shared library
+loaded the first time it is requested
+"""
+
+from .backend import HMD as baseHMD
+
+import bridge_wrapper as bridge
+
+from ctypes import (
+        c_bool,
+        c_char_p,
+        )
+
+
+def set_path(path):
+    """
+    Directory where the plugins are looked for first
+
+    :param path: directory, None to forget it
+    :type path: str
+    """
+    bridge.HMD_pluginPath(c_char_p(path.encode('utf-8')) if path else None)
+
+
+def shutdown_idle(name):
+    """
+    Shut the device runtime of the plugin down (e.g. libOVR) while none of its
+    devices is alive, it is initialized again by the next one
+
+    :param name: name of the plugin
+    :type name: str
+    :return: True if the runtime is not initialized anymore, or the plugin isn't loaded
+    :rtype: bool
+    """
+    bridge.HMD_pluginShutdownIdle.restype = c_bool
+    return bridge.HMD_pluginShutdownIdle(c_char_p(name.encode('utf-8')))
+
+
+class HMD(baseHMD):
+    _backend = -1
+
+    def __init__(self, name):
+        """
+        :param name: name of the plugin, e.g. "BridgeOculus" for libBridgeOculus.so or BridgeOculus.dll
+        :type name: str
+        """
+        self._name = name
+        super(HMD, self).__init__()
+
+        if not self._device:
+            raise IOError("Plugin \"{0}\" could not be loaded".format(name))
+
+    def _new(self):
+        return bridge.HMD_newPlugin(c_char_p(self._name.encode('utf-8')))
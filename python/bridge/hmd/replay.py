@@ -0,0 +1,49 @@
+"""
+Replay
+======
+
+Plays back a tracking session recorded with HMD.recordingStart,
+for reproducible benchmarks without hardware
+"""
+
+from .backend import HMD as baseHMD
+from .backend import Backend
+
+import bridge_wrapper as bridge
+
+from ctypes import (
+        c_char_p,
+        c_double,
+        )
+
+
+class HMD(baseHMD):
+    _backend = Backend.REPLAY
+
+    def __init__(self, filepath, is_realtime=False):
+        """
+        :param filepath: trace file
+        :type filepath: str
+        :param is_realtime: follow the recorded timing, otherwise every update returns the next sample
+        :type is_realtime: bool
+        """
+        self._filepath = filepath
+        self._is_realtime = is_realtime
+        super(HMD, self).__init__()
+
+        if not self._device:
+            raise IOError("Trace \"{0}\" could not be opened".format(filepath))
+
+    def _new(self):
+        return bridge.HMD_newReplay(c_char_p(self._filepath.encode('utf-8')), self._is_realtime)
+
+    def seek(self, time):
+        """
+        Continue from the first sample recorded at or after time
+
+        :param time: time in seconds, in the clock of the recording
+        :type time: float
+        :return: return False if the recording ends before time
+        :rtype: bool
+        """
+        return bridge.HMD_replaySeek(self._device, c_double(time))
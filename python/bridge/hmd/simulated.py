@@ -0,0 +1,68 @@
+"""
+Simulated
+=========
+
+Head mounted display without hardware, with scripted head motion
+and frames paced against a virtual vsync
+"""
+
+from .backend import HMD as baseHMD
+from .backend import Backend
+
+import bridge_wrapper as bridge
+
+from ctypes import (
+        byref,
+        c_float,
+        c_int,
+        c_uint,
+        Structure,
+        )
+
+
+class Motion:
+    STILL = 0
+    LOOK_AROUND = 1
+    WALK = 2
+
+
+class SimulatedConfig(Structure):
+    """
+    Mirror of HMD_SimulatedConfig (HMD_Bridge_API.h)
+    """
+    _fields_ = [
+            ('motion', c_uint),
+            ('seed', c_uint),
+            ('orientation_noise', c_float),
+            ('position_noise', c_float),
+            ('sensor_rate', c_float),
+            ('refresh_rate', c_float),
+            ('is_realtime', c_int),
+            ('width', c_uint * 2),
+            ('height', c_uint * 2),
+            ('fov', (c_float * 4) * 2),
+            ('ipd', c_float),
+            ]
+
+    @classmethod
+    def default(cls):
+        config = cls()
+        bridge.HMD_simulatedConfigDefault(byref(config))
+        return config
+
+
+class HMD(baseHMD):
+    _backend = Backend.SIMULATED
+
+    def __init__(self, config=None):
+        """
+        :param config: device setup, defaults to SimulatedConfig.default()
+        :type config: SimulatedConfig
+        """
+        self._config = config
+        super(HMD, self).__init__()
+
+    def _new(self):
+        if self._config is None:
+            return super(HMD, self)._new()
+        return bridge.HMD_newSimulated(byref(self._config))
@@ -11,34 +11,745 @@
 #define DllExport
 #endif
 
+#include "HMD_Bridge_API.h"
+#include "FrameCache.h"
+#include "Layer.h"
+#include "Pose.h"
+#include "PoseHistory.h"
+#include "PoseRing.h"
+#include "Predictor.h"
+#include "ProjectionCache.h"
+#include "ResolutionGovernor.h"
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+
 class DllExport BackendImpl
 {
 public:
-	BackendImpl(){ m_scale = 1.0f; }
-	~BackendImpl() {}
+	BackendImpl(){
+		m_scale = 1.0f;
+		m_frame = -1;
+		m_is_tracked = false;
+		m_is_tracking_threaded = false;
+		m_is_tracking_running = false;
+		m_is_side_by_side = false;
+		m_samples = 1;
+		m_submit_frame = 0;
+		memset(&m_submit_sample, 0, sizeof(m_submit_sample));
+		m_is_submit_threaded = false;
+		m_is_submit_running = false;
+		m_is_submit_started = false;
+		m_is_submit_pending = false;
+		m_submit_result = true;
+		m_submit_fence = nullptr;
+		memset(&m_submit_stats, 0, sizeof(m_submit_stats));
+		memset(m_layers, 0, sizeof(m_layers));
+		memset(m_submit_layers, 0, sizeof(m_submit_layers));
+		memset(m_submit_viewport, 0, sizeof(m_submit_viewport));
+		m_is_resolution_dynamic = false;
+		m_target_frame_time = 0.0;
+		m_gpu_frame_time = 0.0;
+		m_frame_begin = std::chrono::steady_clock::now();
+	}
+	virtual ~BackendImpl()
+	{
+		this->stopAsyncSubmit();
+		this->stopTracking();
+	}
 
 	/* must inherit */
+
+	/* with no color textures (0, 0) the application renders straight into the eye textures
+	 * of the device, see acquireEyeTexture */
 	virtual bool setup(const unsigned int color_texture_left, const unsigned int color_texture_right) = 0;
 
-	virtual bool update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right) = 0;
+	/* both eyes side by side in a single texture, left eye first, see getEyeViewport.
+	 * With no color texture (0) the application renders straight into the device atlas */
+	virtual bool setupSideBySide(const unsigned int) { return false; }
+
+	/* multisampling, before setup: the eye textures have samples, and the copy into the device resolves them */
+	bool setSamples(const unsigned int samples)
+	{
+		const unsigned int count = samples > 1 ? samples : 1;
+
+		if (count > this->getMaxSamples()) {
+			return false;
+		}
+
+		this->m_samples = count;
+		return true;
+	}
+
+	unsigned int getSamples() const { return this->m_samples; }
+
+	/* 1 when the backend has no multisampled eye textures */
+	virtual unsigned int getMaxSamples() { return 1; }
+
+	/* query the device tracking for the given frame, return true if it is tracked */
+	virtual bool sampleTracking(const unsigned int frame, PoseSample *r_sample) = 0;
+
+	/* submit the frame rendered with m_submit_frame and m_submit_sample,
+	 * from the submit thread when it is running */
+	virtual bool frameReady(void) = 0;
+
+	virtual bool reCenter(void) = 0;
+
+	/* direct rendering */
+
+	/* texture to render the eye into for the current frame, 0 if the device has no direct rendering */
+	virtual unsigned int acquireEyeTexture(const int) { return 0; }
+
+	/* the eye is rendered, frameReady releases the eyes still acquired */
+	virtual bool releaseEyeTexture(const int) { return false; }
+
+	/* pacing of waitFrame, the default does not wait and has no prediction of the display time */
+	virtual bool waitToBeginFrame(const unsigned int, HMD_FrameTiming *r_timing)
+	{
+		r_timing->should_render = 1;
+		r_timing->predicted_display_time = this->getTime();
+		r_timing->period = 0.0;
+		return true;
+	}
+
+	/* asynchronous submission, the defaults are for backends without a GL context */
+
+	/* on the calling thread: a context for the submit thread, sharing the objects of the current one */
+	virtual bool createSubmitContext() { return true; }
+
+	/* on the submit thread, when it starts (true) and before it ends (false) */
+	virtual bool makeSubmitContextCurrent(const bool) { return true; }
+
+	/* on the calling thread, once the submit thread is done */
+	virtual void destroySubmitContext() {}
+
+	/* on the calling thread, once the frame is rendered. The submit thread waits for it before frameReady */
+	virtual void *fenceFrame() { return nullptr; }
+	virtual void waitFence(void *) {}
+
+	/* compositor layers, the defaults are for backends without layers */
+
+	/* on the calling thread, the layer desc is set */
+	virtual bool createLayerSwapChain(const int) { return false; }
+	virtual void destroyLayerSwapChain(const int) {}
+
+	/* texture to render the layer into, and make it the one displayed */
+	virtual unsigned int acquireLayerSwapChain(const int) { return 0; }
+	virtual bool commitLayerSwapChain(const int) { return false; }
+
+	/* framebuffers the application has bound when it calls setup and frameReady,
+	 * GL backends restore them without querying the context */
+	virtual void setFramebufferBindings(const unsigned int, const unsigned int) {}
+
+	/* GL calls made by the backend during the last frame */
+	virtual unsigned int getGLCalls() { return 0; }
+
+	/* GPU time of the GL work of the backend */
+	virtual bool getGPUStats(HMD_GPUStats *) { return false; }
+
+	/* region of the eye texture (x, y, width, height) the eye is rendered in */
+	void getEyeViewport(const int eye, int *r_viewport)
+	{
+		const float fraction = this->m_resolution.getFraction();
+
+		r_viewport[0] = (this->m_is_side_by_side && eye == 1) ? this->m_width[0] : 0;
+		r_viewport[1] = 0;
+		r_viewport[2] = BackendImpl::scaleSize(this->m_width[eye], fraction);
+		r_viewport[3] = BackendImpl::scaleSize(this->m_height[eye], fraction);
+	}
+
+	/* dynamic resolution */
+
+	/* before setup, the eye sizes of the given pixel density */
+	virtual bool setPixelDensity(const float) { return false; }
+
+	/* between two displayed frames, 0 if unknown */
+	virtual double getDisplayPeriod() { return 0.0; }
+
+	bool startDynamicResolution(const HMD_ResolutionConfig *config)
+	{
+		const float max_scale = config->max_scale > 0.0f ? config->max_scale : 1.0f;
+
+		if (!this->setPixelDensity(max_scale)) {
+			return false;
+		}
+
+		this->m_resolution.configure(config->min_scale, max_scale, config->utilization);
+		this->m_target_frame_time = config->target_frame_time;
+		this->m_is_resolution_dynamic = true;
+		return true;
+	}
+
+	/* the viewports cover the textures again, they stay at the highest density */
+	void stopDynamicResolution()
+	{
+		this->m_is_resolution_dynamic = false;
+		this->m_resolution.reset();
+	}
+
+	float getResolutionScale() const { return this->m_resolution.getScale(); }
+
+	void setGPUFrameTime(const double time) { this->m_gpu_frame_time = time; }
+
+	/* column-major projection matrix of the eye (0: left, 1: right), only called on a cache miss */
+	virtual void computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix) = 0;
+
+	/* projection matrices, cached until the clipping or the field of view changes */
+
+	virtual void getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+	{
+		memcpy(r_matrix, this->getProjectionMatrix(0, nearz, farz, is_opengl, is_right_hand), sizeof(float[16]));
+	}
+
+	virtual void getProjectionMatrixRight(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+	{
+		memcpy(r_matrix, this->getProjectionMatrix(1, nearz, farz, is_opengl, is_right_hand), sizeof(float[16]));
+	}
+
+	virtual void getProjectionMatrices(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		memcpy(r_matrix_left, this->getProjectionMatrix(0, nearz, farz, is_opengl, is_right_hand), sizeof(float[16]));
+		memcpy(r_matrix_right, this->getProjectionMatrix(1, nearz, farz, is_opengl, is_right_hand), sizeof(float[16]));
+	}
+
+	/* frame state */
+
+	/* sample the tracking once for a new frame, and fill all the requested representations from it */
+	virtual bool getFrameState(HMD_FrameState *r_state)
+	{
+		return this->getFrameStateOf(this, r_state);
+	}
+
+	/* the frame state, with the tracking hooks of Self. A backend bound at compile time (HMDT)
+	 * passes its final type, its hooks are then called without dispatch */
+	template <class Self>
+	bool getFrameStateOf(Self *self, HMD_FrameState *r_state)
+	{
+		PoseSample sample;
+		const unsigned int frame = ++this->m_frame;
+
+		this->m_frame_begin = std::chrono::steady_clock::now();
+		const bool is_tracked = this->acquireSample(self, frame, &sample);
+
+		if (is_tracked) {
+			/* extrapolate the history, for backends without (or on top of) native prediction */
+			self->predictPose(&sample);
+		}
+
+		r_state->frame = frame;
+		r_state->display_time = sample.time;
+		r_state->status = sample.status;
+
+		if (!is_tracked) {
+			return false;
+		}
+
+		/* keep the last tracked pose, it is the one submitted with the frame,
+		 * the derived representations are only computed when requested */
+		this->m_cache.reset(sample);
+		this->m_is_tracked = true;
+
+		for (int eye = 0; eye < 2; eye++) {
+			if (r_state->flags & HMD_FRAME_ORIENTATION) {
+				memcpy(r_state->orientation[eye], sample.orientation[eye], sizeof(float[4]));
+			}
+
+			if (r_state->flags & HMD_FRAME_YAW_PITCH_ROLL) {
+				memcpy(r_state->yaw_pitch_roll[eye], this->m_cache.yawPitchRoll(eye), sizeof(float[3]));
+			}
+
+			if (r_state->flags & HMD_FRAME_POSITION) {
+				r_state->position[eye][0] = this->m_scale * sample.position[eye][0];
+				r_state->position[eye][1] = this->m_scale * sample.position[eye][1];
+				r_state->position[eye][2] = this->m_scale * sample.position[eye][2];
+			}
+
+			const bool is_right_hand = (r_state->flags & HMD_FRAME_LEFT_HANDED) == 0;
+
+			if (r_state->flags & HMD_FRAME_VIEW_MATRIX) {
+				memcpy(r_state->view_matrix[eye], this->m_cache.viewMatrix(eye, is_right_hand), sizeof(float[16]));
+			}
+
+			if (r_state->flags & HMD_FRAME_INVERSE_VIEW_MATRIX) {
+				memcpy(r_state->inverse_view_matrix[eye], this->m_cache.inverseViewMatrix(eye, is_right_hand), sizeof(float[16]));
+			}
+		}
+		return true;
+	}
+
+	/* compositor layers */
+
+	enum { MAX_LAYERS = 8 };
+
+	int createLayer(const HMD_LayerDesc *desc)
+	{
+		if (desc->width == 0 || desc->height == 0 || desc->type > HMD_LAYER_STATIC) {
+			return -1;
+		}
+
+		/* the swap chain is not created while the submit thread submits */
+		std::unique_lock<std::mutex> lock(this->m_submit_mutex);
+		this->m_submit_condition.wait(lock, [this] { return !this->m_is_submit_pending; });
+
+		for (int layer = 0; layer < MAX_LAYERS; layer++) {
+			if (this->m_layers[layer].is_used) {
+				continue;
+			}
+
+			Layer &entry = this->m_layers[layer];
+			memset(&entry, 0, sizeof(entry));
+			entry.desc = *desc;
+
+			for (int i = 0; i < 2; i++) {
+				entry.desc.size[i] /= this->m_scale;
+			}
+
+			for (int i = 0; i < 3; i++) {
+				entry.desc.position[i] /= this->m_scale;
+			}
+
+			if (!this->createLayerSwapChain(layer)) {
+				return -1;
+			}
+
+			entry.is_used = true;
+			return layer;
+		}
+		return -1;
+	}
+
+	bool destroyLayer(const int layer)
+	{
+		if (!this->isLayer(layer)) {
+			return false;
+		}
+
+		/* the submit thread may be displaying it */
+		std::unique_lock<std::mutex> lock(this->m_submit_mutex);
+		this->m_submit_condition.wait(lock, [this] { return !this->m_is_submit_pending; });
+
+		this->destroyLayerSwapChain(layer);
+		this->m_layers[layer].is_used = false;
+		this->m_submit_layers[layer].is_used = false;
+		return true;
+	}
+
+	bool setLayerPose(const int layer, const float *orientation, const float *position)
+	{
+		if (!this->isLayer(layer)) {
+			return false;
+		}
+
+		HMD_LayerDesc &desc = this->m_layers[layer].desc;
+		memcpy(desc.orientation, orientation, sizeof(float[4]));
+
+		for (int i = 0; i < 3; i++) {
+			desc.position[i] = position[i] / this->m_scale;
+		}
+		return true;
+	}
+
+	bool isLayerDue(const int layer)
+	{
+		return this->isLayer(layer) && this->m_layers[layer].isDue(this->getTime());
+	}
+
+	unsigned int acquireLayerTexture(const int layer)
+	{
+		if (!this->isLayer(layer)) {
+			return 0;
+		}
+
+		Layer &entry = this->m_layers[layer];
+
+		if (entry.desc.type == HMD_LAYER_STATIC && entry.is_committed) {
+			return 0;
+		}
+
+		const unsigned int texture = this->acquireLayerSwapChain(layer);
+		entry.is_acquired = texture != 0;
+		return texture;
+	}
+
+	/* the layer shows the new texture from the next frame on */
+	bool releaseLayerTexture(const int layer)
+	{
+		if (!this->isLayer(layer) || !this->m_layers[layer].is_acquired) {
+			return false;
+		}
+
+		Layer &entry = this->m_layers[layer];
+		entry.is_acquired = false;
+
+		if (!this->commitLayerSwapChain(layer)) {
+			return false;
+		}
+
+		entry.is_committed = true;
+		entry.update_time = this->getTime();
+		return true;
+	}
+
+	/* frame submission */
+
+	/* the application is done with the frame: release the eye textures it still holds, and
+	 * submit the frame, or hand it to the submit thread and return the result of the previous one */
+	bool presentFrame()
+	{
+		const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+		for (int eye = 0; eye < 2; eye++) {
+			this->releaseEyeTexture(eye);
+		}
+
+		/* the viewports the frame was rendered with, then the ones of the next frame */
+		int viewport[2][4];
+		this->getEyeViewport(0, viewport[0]);
+		this->getEyeViewport(1, viewport[1]);
+
+		if (this->m_is_resolution_dynamic) {
+			this->updateResolution(begin);
+		}
+
+		if (!this->m_is_submit_threaded) {
+			this->m_submit_frame = this->m_frame;
+			this->m_submit_sample = this->m_cache.sample();
+			memcpy(this->m_submit_layers, this->m_layers, sizeof(this->m_layers));
+			memcpy(this->m_submit_viewport, viewport, sizeof(viewport));
+
+			const bool result = this->frameReady();
+			const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			std::lock_guard<std::mutex> lock(this->m_submit_mutex);
+			this->m_submit_stats.wait_time = std::chrono::duration<double>(end - begin).count();
+			this->addSubmitStats(this->m_submit_stats.wait_time, end);
+			return result;
+		}
+
+		/* before waiting, the GPU may be done by the time the submit thread is free */
+		void *fence = this->fenceFrame();
+
+		std::unique_lock<std::mutex> lock(this->m_submit_mutex);
+
+		if (this->m_is_submit_pending) {
+			/* one frame in flight at most */
+			this->m_submit_stats.stalls++;
+			this->m_submit_condition.wait(lock, [this] { return !this->m_is_submit_pending; });
+		}
+
+		this->m_submit_frame = this->m_frame;
+		this->m_submit_sample = this->m_cache.sample();
+		memcpy(this->m_submit_layers, this->m_layers, sizeof(this->m_layers));
+		memcpy(this->m_submit_viewport, viewport, sizeof(viewport));
+		this->m_submit_fence = fence;
+		this->m_is_submit_pending = true;
+		this->m_submit_stats.wait_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		this->m_submit_condition.notify_all();
+
+		return this->m_submit_result;
+	}
+
+	/* submit from a background thread, the render thread only waits when the previous frame
+	 * is still being submitted. In copy mode (setup with color textures, or with samples) the application
+	 * must not render into the eye textures before the frame is submitted, direct rendering without
+	 * samples has no such restriction */
+	virtual bool startAsyncSubmit()
+	{
+		if (this->m_is_submit_threaded || !this->createSubmitContext()) {
+			return false;
+		}
+
+		this->m_is_submit_running = true;
+		this->m_is_submit_started = false;
+		this->m_submit_thread = std::thread(&BackendImpl::submitLoop, this);
+
+		/* the context is made current from the thread */
+		std::unique_lock<std::mutex> lock(this->m_submit_mutex);
+		this->m_submit_condition.wait(lock, [this] { return this->m_is_submit_started; });
+
+		if (!this->m_is_submit_running) {
+			lock.unlock();
+			this->m_submit_thread.join();
+			this->destroySubmitContext();
+			return false;
+		}
+
+		this->m_is_submit_threaded = true;
+		return true;
+	}
+
+	/* the frame in flight is submitted first */
+	virtual void stopAsyncSubmit()
+	{
+		if (!this->m_is_submit_threaded) {
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->m_submit_mutex);
+			this->m_is_submit_running = false;
+			this->m_submit_condition.notify_all();
+		}
+
+		this->m_submit_thread.join();
+		this->destroySubmitContext();
+		this->m_is_submit_threaded = false;
+	}
+
+	bool isSubmitThreaded() const { return this->m_is_submit_threaded; }
+
+	void getSubmitStats(HMD_SubmitStats *r_stats)
+	{
+		std::lock_guard<std::mutex> lock(this->m_submit_mutex);
+		*r_stats = this->m_submit_stats;
+	}
+
+	/* explicit frame loop */
+
+	/* block until it is time to start the next frame, and tell when it will be displayed */
+	bool waitFrame(HMD_FrameTiming *r_timing)
+	{
+		r_timing->frame = this->m_frame + 1;
+		return this->waitToBeginFrame(r_timing->frame, r_timing);
+	}
+
+	/* latch the poses of the frame waited for */
+	bool beginFrame(HMD_FrameState *r_state)
+	{
+		return this->getFrameState(r_state);
+	}
+
+	bool endFrame()
+	{
+		return this->presentFrame();
+	}
+
+	/* tracking thread */
+
+	/* sample the tracking in the background at rate_hz, the frame state then reads the latest sample */
+	virtual bool startTracking(const float rate_hz)
+	{
+		if (this->m_is_tracking_threaded || rate_hz <= 0.0f) {
+			return false;
+		}
+
+		this->m_is_tracking_running = true;
+		this->m_is_tracking_threaded = true;
+		this->m_tracking_thread = std::thread(&BackendImpl::trackingLoop, this, rate_hz);
+		return true;
+	}
+
+	virtual void stopTracking()
+	{
+		if (!this->m_is_tracking_threaded) {
+			return;
+		}
+
+		this->m_is_tracking_running = false;
+		this->m_tracking_thread.join();
+		this->m_is_tracking_threaded = false;
+	}
+
+	bool isTrackingThreaded() const { return this->m_is_tracking_threaded; }
+
+	/* number of samples published by the tracking thread */
+	unsigned long long getTrackingSampleCount() const { return this->m_tracking_ring.count(); }
+
+	/* prediction */
+
+	virtual void setPredictor(const eHMDPredictor type, const double horizon)
+	{
+		this->m_predictor.set(type, horizon);
+	}
+
+	/* replace the sample by its prediction, return false if it was left untouched */
+	virtual bool predictPose(PoseSample *r_sample)
+	{
+		if (this->m_predictor.getType() == HMD_PREDICTOR_NONE) {
+			return false;
+		}
+
+		PoseSample prediction;
+		if (!this->m_predictor.predict(this->m_history, &prediction)) {
+			return false;
+		}
+
+		prediction.frame = r_sample->frame;
+		*r_sample = prediction;
+		return true;
+	}
+
+	/* recording */
+
+	/* append every tracking sample to a trace file, written in the background */
+	virtual bool startRecording(const char *path)
+	{
+		return this->m_trace.open(path);
+	}
+
+	virtual void stopRecording()
+	{
+		this->m_trace.close();
+	}
+
+	bool isRecording() const { return this->m_trace.isOpen(); }
+
+	/* only for recorded sessions, continue from the given time */
+	virtual bool seek(const double) { return false; }
+
+	/* pose history */
+
+	/* clock of the sample times, in seconds */
+	virtual double getTime()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/* head and eye poses at any time covered by the history, without querying the tracking */
+	virtual bool getPoseAt(const double time, PoseSample *r_sample)
+	{
+		return this->m_history.getPoseAt(time, r_sample);
+	}
+
+	bool getPoseAt(const double time, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+	{
+		PoseSample sample;
+
+		if (!this->getPoseAt(time, &sample)) {
+			return false;
+		}
+
+		float *orientation[2] = { r_orientation_left, r_orientation_right };
+		float *position[2] = { r_position_left, r_position_right };
+
+		for (int eye = 0; eye < 2; eye++) {
+			memcpy(orientation[eye], sample.orientation[eye], sizeof(float[4]));
+			position[eye][0] = this->m_scale * sample.position[eye][0];
+			position[eye][1] = this->m_scale * sample.position[eye][1];
+			position[eye][2] = this->m_scale * sample.position[eye][2];
+		}
+		return true;
+	}
+
+	/* representations of the current frame, computed once and cached until the next frame */
+
+	virtual bool getYawPitchRoll(float *r_yaw_pitch_roll_left, float *r_yaw_pitch_roll_right)
+	{
+		if (!this->m_is_tracked) {
+			return false;
+		}
+
+		memcpy(r_yaw_pitch_roll_left, this->m_cache.yawPitchRoll(0), sizeof(float[3]));
+		memcpy(r_yaw_pitch_roll_right, this->m_cache.yawPitchRoll(1), sizeof(float[3]));
+		return true;
+	}
+
+	virtual bool getViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		if (!this->m_is_tracked) {
+			return false;
+		}
+
+		memcpy(r_matrix_left, this->m_cache.viewMatrix(0, is_right_hand), sizeof(float[16]));
+		memcpy(r_matrix_right, this->m_cache.viewMatrix(1, is_right_hand), sizeof(float[16]));
+		return true;
+	}
+
+	virtual bool getInverseViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		if (!this->m_is_tracked) {
+			return false;
+		}
+
+		memcpy(r_matrix_left, this->m_cache.inverseViewMatrix(0, is_right_hand), sizeof(float[16]));
+		memcpy(r_matrix_right, this->m_cache.inverseViewMatrix(1, is_right_hand), sizeof(float[16]));
+		return true;
+	}
+
+	/* legacy per-representation routines, each one starts a new frame */
+
+	virtual bool update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+	{
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION;
+
+		if (!this->getFrameState(&state)) {
+			return false;
+		}
+
+		memcpy(r_orientation_left, state.orientation[0], sizeof(float[4]));
+		memcpy(r_orientation_right, state.orientation[1], sizeof(float[4]));
+		memcpy(r_position_left, state.position[0], sizeof(float[3]));
+		memcpy(r_position_right, state.position[1], sizeof(float[3]));
+		return true;
+	}
 
 	virtual bool update(
 		float *r_yaw_left, float *r_pitch_left, float *r_roll_left, float *r_position_left,
-		float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_position_right) = 0;
+		float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_position_right)
+	{
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_YAW_PITCH_ROLL | HMD_FRAME_POSITION;
+
+		if (!this->getFrameState(&state)) {
+			return false;
+		}
+
+		*r_yaw_left = state.yaw_pitch_roll[0][0];
+		*r_pitch_left = state.yaw_pitch_roll[0][1];
+		*r_roll_left = state.yaw_pitch_roll[0][2];
+		*r_yaw_right = state.yaw_pitch_roll[1][0];
+		*r_pitch_right = state.yaw_pitch_roll[1][1];
+		*r_roll_right = state.yaw_pitch_roll[1][2];
+
+		memcpy(r_position_left, state.position[0], sizeof(float[3]));
+		memcpy(r_position_right, state.position[1], sizeof(float[3]));
+		return true;
+	}
 
 	virtual bool update(
 		float *r_yaw_left, float *r_pitch_left, float *r_roll_left, float *r_orientation_left, float *r_position_left,
-		float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_orientation_right, float *r_position_right) = 0;
+		float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_orientation_right, float *r_position_right)
+	{
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_YAW_PITCH_ROLL | HMD_FRAME_POSITION;
 
-	virtual bool update(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right) = 0;
+		if (!this->getFrameState(&state)) {
+			return false;
+		}
 
-	virtual bool frameReady(void) = 0;
+		*r_yaw_left = state.yaw_pitch_roll[0][0];
+		*r_pitch_left = state.yaw_pitch_roll[0][1];
+		*r_roll_left = state.yaw_pitch_roll[0][2];
+		*r_yaw_right = state.yaw_pitch_roll[1][0];
+		*r_pitch_right = state.yaw_pitch_roll[1][1];
+		*r_roll_right = state.yaw_pitch_roll[1][2];
 
-	virtual bool reCenter(void) = 0;
+		memcpy(r_orientation_left, state.orientation[0], sizeof(float[4]));
+		memcpy(r_orientation_right, state.orientation[1], sizeof(float[4]));
+		memcpy(r_position_left, state.position[0], sizeof(float[3]));
+		memcpy(r_position_right, state.position[1], sizeof(float[3]));
+		return true;
+	}
+
+	virtual bool update(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_VIEW_MATRIX | (is_right_hand ? 0 : HMD_FRAME_LEFT_HANDED);
 
-	virtual void getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix) = 0;
+		if (!this->getFrameState(&state)) {
+			return false;
+		}
 
-	virtual void getProjectionMatrixRight(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix) = 0;
+		memcpy(r_matrix_left, state.view_matrix[0], sizeof(float[16]));
+		memcpy(r_matrix_right, state.view_matrix[1], sizeof(float[16]));
+		return true;
+	}
 
 	/* generic */
 	virtual int getWidthLeft() { return this->m_width[0]; }
@@ -54,21 +765,213 @@ public:
 	virtual void setStateBool(bool status){}
 
 protected:
+	static unsigned int scaleSize(const unsigned int size, const float fraction)
+	{
+		const unsigned int scaled = (unsigned int)(size * fraction + 0.5f);
+		return scaled < 1 ? 1 : (scaled > size ? size : scaled);
+	}
+
+	/* the frame took the time from its frame state to frameReady on the CPU, and the reported
+	 * time on the GPU, the slowest of the two sets the density */
+	void updateResolution(const std::chrono::steady_clock::time_point end)
+	{
+		const double cpu_time = std::chrono::duration<double>(end - this->m_frame_begin).count();
+		const double frame_time = cpu_time > this->m_gpu_frame_time ? cpu_time : this->m_gpu_frame_time;
+		const double period = this->m_target_frame_time > 0.0 ? this->m_target_frame_time : this->getDisplayPeriod();
+
+		this->m_resolution.update(frame_time, period);
+		this->m_gpu_frame_time = 0.0;
+	}
+
+	bool isLayer(const int layer) const
+	{
+		return layer >= 0 && layer < MAX_LAYERS && this->m_layers[layer].is_used;
+	}
+
+	const float *getProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand)
+	{
+		float *matrix;
+
+		if (this->m_projection_cache.acquire(eye, nearz, farz, is_opengl, is_right_hand, &matrix)) {
+			this->computeProjectionMatrix(eye, nearz, farz, is_opengl, is_right_hand, matrix);
+		}
+		return matrix;
+	}
+
+	/* to be called by the backends whenever the field of view or the render description changes */
+	void invalidateProjection() { this->m_projection_cache.invalidate(); }
+
+	/* query the tracking, the tracked samples go to the history and all of them to the recording */
+	template <class Self>
+	bool takeSample(Self *self, const unsigned int frame, PoseSample *r_sample)
+	{
+		const bool is_tracked = self->sampleTracking(frame, r_sample);
+
+		if (is_tracked) {
+			this->m_history.add(*r_sample);
+		}
+
+		this->m_trace.add(*r_sample);
+		return is_tracked;
+	}
+
+	/* latest sample from the tracking thread, or query the tracking right away */
+	template <class Self>
+	bool acquireSample(Self *self, const unsigned int frame, PoseSample *r_sample)
+	{
+		if (!this->m_is_tracking_threaded) {
+			return this->takeSample(self, frame, r_sample);
+		}
+
+		if (!this->m_tracking_ring.readLatest(r_sample)) {
+			memset(r_sample, 0, sizeof(PoseSample));
+			return false;
+		}
+		return r_sample->status != 0;
+	}
+
+	void trackingLoop(const float rate_hz)
+	{
+		const std::chrono::nanoseconds period((long long)(1e9 / rate_hz));
+		std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+		while (this->m_is_tracking_running.load(std::memory_order_relaxed)) {
+			PoseSample sample;
+
+			/* predict for the frame the render thread is about to start */
+			this->takeSample(this, this->m_frame.load(std::memory_order_relaxed) + 1, &sample);
+			this->m_tracking_ring.publish(sample);
+
+			next += period;
+
+			/* after a stall, from now on instead of sampling back to back to catch up */
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+			if (next < now) {
+				next = now;
+			}
+			std::this_thread::sleep_until(next);
+		}
+	}
+
+	/* called with m_submit_mutex held */
+	void addSubmitStats(const double submit_time, const std::chrono::steady_clock::time_point end)
+	{
+		HMD_SubmitStats &stats = this->m_submit_stats;
+
+		stats.frames++;
+		stats.submit_time = submit_time;
+		stats.submit_time_average += (submit_time - stats.submit_time_average) / stats.frames;
+
+		if (stats.frames > 1) {
+			stats.submit_interval = std::chrono::duration<double>(end - this->m_submit_last).count();
+		}
+		this->m_submit_last = end;
+	}
+
+	void submitLoop()
+	{
+		const bool is_current = this->makeSubmitContextCurrent(true);
+		std::unique_lock<std::mutex> lock(this->m_submit_mutex);
+
+		this->m_is_submit_started = true;
+		this->m_is_submit_running = this->m_is_submit_running && is_current;
+		this->m_submit_condition.notify_all();
+
+		while (is_current) {
+			this->m_submit_condition.wait(lock, [this] { return this->m_is_submit_pending || !this->m_is_submit_running; });
+
+			if (!this->m_is_submit_pending) {
+				break;
+			}
+
+			void *fence = this->m_submit_fence;
+			lock.unlock();
+
+			const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			this->waitFence(fence);
+			const bool result = this->frameReady();
+			const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			lock.lock();
+			this->m_submit_result = result;
+			this->addSubmitStats(std::chrono::duration<double>(end - begin).count(), end);
+			this->m_is_submit_pending = false;
+			this->m_submit_condition.notify_all();
+		}
+
+		lock.unlock();
+
+		if (is_current) {
+			this->makeSubmitContextCurrent(false);
+		}
+	}
+
 	unsigned int m_color_texture[2];
+	bool m_is_side_by_side; /* one texture for both eyes */
+	unsigned int m_samples; /* of the eye textures the application renders into */
 	unsigned int m_width[2];
 	unsigned int m_height[2];
 	float m_scale;
+
+	std::atomic<unsigned int> m_frame;
+	bool m_is_tracked;
+	FrameCache m_cache; /* last tracked pose */
+
+	bool m_is_tracking_threaded;
+	std::atomic<bool> m_is_tracking_running;
+	std::thread m_tracking_thread;
+	PoseRing<PoseSample, 16> m_tracking_ring;
+
+	Layer m_layers[MAX_LAYERS];
+
+	bool m_is_resolution_dynamic;
+	ResolutionGovernor m_resolution;
+	double m_target_frame_time; /* 0 for the display period */
+	double m_gpu_frame_time; /* reported for the current frame */
+	std::chrono::steady_clock::time_point m_frame_begin; /* of the current frame state */
+
+	/* frame being submitted, the pose it was rendered with, its layers and eye viewports */
+	unsigned int m_submit_frame;
+	PoseSample m_submit_sample;
+	Layer m_submit_layers[MAX_LAYERS];
+	int m_submit_viewport[2][4];
+
+	bool m_is_submit_threaded;
+	bool m_is_submit_running;
+	bool m_is_submit_started;
+	bool m_is_submit_pending; /* handed over, not submitted yet */
+	bool m_submit_result; /* of the last submitted frame */
+	void *m_submit_fence;
+	std::mutex m_submit_mutex;
+	std::condition_variable m_submit_condition;
+	std::thread m_submit_thread;
+	HMD_SubmitStats m_submit_stats;
+	std::chrono::steady_clock::time_point m_submit_last;
+
+	PoseHistory m_history; /* tracked samples, written by the thread sampling the tracking */
+	Predictor m_predictor;
+
+	ProjectionCache m_projection_cache;
+
+	TraceWriter m_trace;
 };
 
 class DllExport Backend
 {
 public:
-	Backend() {
-		this->initializeImplementation();
+	Backend():
+		m_me(nullptr)
+	{
+		/* the implementation is created by the inherited constructor,
+		 * virtual calls are not dispatched from here */
 	}
 
-	~Backend() {
+	virtual ~Backend() {
 		if (this->m_me) {
+			/* the tracking and submit threads can't outlive the inherited implementation */
+			this->m_me->stopAsyncSubmit();
+			this->m_me->stopTracking();
 			delete this->m_me;
 		}
 	}
@@ -78,6 +981,21 @@ public:
 		return this->m_me->setup(color_texture_left, color_texture_right);
 	}
 
+	bool setupSideBySide(const unsigned int color_texture)
+	{
+		return this->m_me->setupSideBySide(color_texture);
+	}
+
+	bool setSamples(const unsigned int samples)
+	{
+		return this->m_me->setSamples(samples);
+	}
+
+	unsigned int getSamples()
+	{
+		return this->m_me->getSamples();
+	}
+
 	bool update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
 	{
 		return this->m_me->update(r_orientation_left, r_position_left, r_orientation_right, r_position_right);
@@ -106,9 +1024,99 @@ public:
 		return this->m_me->update(is_right_hand, r_matrix_left, r_matrix_right);
 	}
 
+	bool getFrameState(HMD_FrameState *r_state)
+	{
+		return this->m_me->getFrameState(r_state);
+	}
+
+	bool waitFrame(HMD_FrameTiming *r_timing)
+	{
+		return this->m_me->waitFrame(r_timing);
+	}
+
+	bool beginFrame(HMD_FrameState *r_state)
+	{
+		return this->m_me->beginFrame(r_state);
+	}
+
+	bool endFrame()
+	{
+		return this->m_me->endFrame();
+	}
+
+	bool startTracking(const float rate_hz)
+	{
+		return this->m_me->startTracking(rate_hz);
+	}
+
+	void stopTracking()
+	{
+		this->m_me->stopTracking();
+	}
+
+	void setPredictor(const eHMDPredictor type, const double horizon)
+	{
+		this->m_me->setPredictor(type, horizon);
+	}
+
+	bool startRecording(const char *path)
+	{
+		return this->m_me->startRecording(path);
+	}
+
+	void stopRecording()
+	{
+		this->m_me->stopRecording();
+	}
+
+	bool seek(const double time)
+	{
+		return this->m_me->seek(time);
+	}
+
+	double getTime()
+	{
+		return this->m_me->getTime();
+	}
+
+	bool getPoseAt(const double time, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+	{
+		return this->m_me->getPoseAt(time, r_orientation_left, r_position_left, r_orientation_right, r_position_right);
+	}
+
+	bool getYawPitchRoll(float *r_yaw_pitch_roll_left, float *r_yaw_pitch_roll_right)
+	{
+		return this->m_me->getYawPitchRoll(r_yaw_pitch_roll_left, r_yaw_pitch_roll_right);
+	}
+
+	bool getViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		return this->m_me->getViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+	}
+
+	bool getInverseViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		return this->m_me->getInverseViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+	}
+
 	bool frameReady(void)
 	{
-		return this->m_me->frameReady();
+		return this->m_me->presentFrame();
+	}
+
+	bool startAsyncSubmit()
+	{
+		return this->m_me->startAsyncSubmit();
+	}
+
+	void stopAsyncSubmit()
+	{
+		this->m_me->stopAsyncSubmit();
+	}
+
+	void getSubmitStats(HMD_SubmitStats *r_stats)
+	{
+		this->m_me->getSubmitStats(r_stats);
 	}
 
 	bool reCenter(void)
@@ -116,6 +1124,86 @@ public:
 		return this->m_me->reCenter();
 	}
 
+	unsigned int acquireEyeTexture(const int eye)
+	{
+		return this->m_me->acquireEyeTexture(eye);
+	}
+
+	bool releaseEyeTexture(const int eye)
+	{
+		return this->m_me->releaseEyeTexture(eye);
+	}
+
+	void getEyeViewport(const int eye, int *r_viewport)
+	{
+		this->m_me->getEyeViewport(eye, r_viewport);
+	}
+
+	bool startDynamicResolution(const HMD_ResolutionConfig *config)
+	{
+		return this->m_me->startDynamicResolution(config);
+	}
+
+	void stopDynamicResolution()
+	{
+		this->m_me->stopDynamicResolution();
+	}
+
+	float getResolutionScale()
+	{
+		return this->m_me->getResolutionScale();
+	}
+
+	void setGPUFrameTime(const double time)
+	{
+		this->m_me->setGPUFrameTime(time);
+	}
+
+	int createLayer(const HMD_LayerDesc *desc)
+	{
+		return this->m_me->createLayer(desc);
+	}
+
+	bool destroyLayer(const int layer)
+	{
+		return this->m_me->destroyLayer(layer);
+	}
+
+	bool setLayerPose(const int layer, const float *orientation, const float *position)
+	{
+		return this->m_me->setLayerPose(layer, orientation, position);
+	}
+
+	bool isLayerDue(const int layer)
+	{
+		return this->m_me->isLayerDue(layer);
+	}
+
+	unsigned int acquireLayerTexture(const int layer)
+	{
+		return this->m_me->acquireLayerTexture(layer);
+	}
+
+	bool releaseLayerTexture(const int layer)
+	{
+		return this->m_me->releaseLayerTexture(layer);
+	}
+
+	void setFramebufferBindings(const unsigned int draw_framebuffer, const unsigned int read_framebuffer)
+	{
+		this->m_me->setFramebufferBindings(draw_framebuffer, read_framebuffer);
+	}
+
+	unsigned int getGLCalls()
+	{
+		return this->m_me->getGLCalls();
+	}
+
+	bool getGPUStats(HMD_GPUStats *r_stats)
+	{
+		return this->m_me->getGPUStats(r_stats);
+	}
+
 	void getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
 	{
 		return this->m_me->getProjectionMatrixLeft(nearz, farz, is_opengl, is_right_hand, r_matrix);
@@ -126,6 +1214,11 @@ public:
 		return this->m_me->getProjectionMatrixRight(nearz, farz, is_opengl, is_right_hand, r_matrix);
 	}
 
+	void getProjectionMatrices(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		return this->m_me->getProjectionMatrices(nearz, farz, is_opengl, is_right_hand, r_matrix_left, r_matrix_right);
+	}
+
 	/* generic */
 	int getWidthLeft()
 	{
@@ -0,0 +1,102 @@
+#ifndef __FRAME_CACHE_H__
+#define __FRAME_CACHE_H__
+
+#include "Pose.h"
+#include "ViewMatrix.h"
+
+#include <string.h>
+
+/* Derived representations of the latched frame pose.
+ * They are computed the first time they are requested, and kept until the next frame */
+class FrameCache
+{
+public:
+	FrameCache() :
+		m_valid(0)
+	{
+		memset(&m_sample, 0, sizeof(m_sample));
+		m_sample.orientation[0][0] = m_sample.orientation[1][0] = m_sample.head_orientation[0] = 1.0f;
+	}
+
+	/* start a new frame */
+	void reset(const PoseSample &sample)
+	{
+		this->m_sample = sample;
+		this->m_valid = 0;
+	}
+
+	const PoseSample &sample() const { return this->m_sample; }
+
+	const float *yawPitchRoll(const int eye)
+	{
+		float *ypr = this->m_yaw_pitch_roll[eye];
+
+		if (this->acquire(CACHE_YAW_PITCH_ROLL, eye, true)) {
+			poseYawPitchRoll(this->m_sample.orientation[eye], &ypr[0], &ypr[1], &ypr[2]);
+		}
+		return ypr;
+	}
+
+	const float *viewMatrix(const int eye, const bool is_right_hand)
+	{
+		/* both eyes are built in one pass */
+		if (this->acquire(CACHE_VIEW_MATRIX, eye, is_right_hand)) {
+			this->acquire(CACHE_VIEW_MATRIX, 1 - eye, is_right_hand);
+			poseStereoViewMatrix(this->m_sample, is_right_hand, this->m_view_matrix[is_right_hand]);
+		}
+		return this->m_view_matrix[is_right_hand][eye];
+	}
+
+	const float *inverseViewMatrix(const int eye, const bool is_right_hand)
+	{
+		float *matrix = this->m_inverse_view_matrix[is_right_hand][eye];
+
+		if (this->acquire(CACHE_INVERSE_VIEW_MATRIX, eye, is_right_hand)) {
+			const float *view = this->viewMatrix(eye, is_right_hand);
+
+			/* the rotation is orthonormal, its inverse is the transpose */
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					matrix[i * 4 + j] = view[j * 4 + i];
+				}
+				matrix[i * 4 + 3] = 0.0f;
+			}
+
+			matrix[12] = this->m_sample.position[eye][0];
+			matrix[13] = this->m_sample.position[eye][1];
+			matrix[14] = this->m_sample.position[eye][2];
+			matrix[15] = 1.0f;
+		}
+		return matrix;
+	}
+
+private:
+	enum eCacheType
+	{
+		CACHE_YAW_PITCH_ROLL = 0,
+		CACHE_VIEW_MATRIX,
+		CACHE_INVERSE_VIEW_MATRIX,
+	};
+
+	/* return true if the representation needs to be computed, and mark it as valid */
+	bool acquire(const eCacheType type, const int eye, const bool is_right_hand)
+	{
+		const unsigned int bit = 1u << ((type * 2 + (is_right_hand ? 1 : 0)) * 2 + eye);
+
+		if (this->m_valid & bit) {
+			return false;
+		}
+
+		this->m_valid |= bit;
+		return true;
+	}
+
+	PoseSample m_sample;
+	unsigned int m_valid;
+
+	float m_yaw_pitch_roll[2][3];
+	float m_view_matrix[2][2][16]; /* [is_right_hand][eye] */
+	float m_inverse_view_matrix[2][2][16]; /* [is_right_hand][eye] */
+};
+
+#endif /* __FRAME_CACHE_H__ */
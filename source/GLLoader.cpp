@@ -0,0 +1,532 @@
+/* generated by generate-gl-loader.py, do not edit */
+
+#include "GLLoader.h"
+#include "Log.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <dlfcn.h>
+#endif
+
+static std::atomic<unsigned int> s_resolved(0);
+
+#if defined(_WIN32) || defined(_WIN64)
+
+void *GLLoader_getProcAddress(const char *name)
+{
+	void *proc = (void *)wglGetProcAddress(name);
+
+	/* some drivers return a small value instead of nullptr, GL 1.1 is only in opengl32 */
+	if ((uintptr_t)proc <= 3 || proc == (void *)-1) {
+		static HMODULE opengl = LoadLibraryA("opengl32.dll");
+		proc = opengl ? (void *)GetProcAddress(opengl, name) : nullptr;
+	}
+	return proc;
+}
+
+#else
+
+typedef void *(*PFN_getProcAddress)(const char *name);
+
+static void *openLibrary(const char *const *names)
+{
+	for (int i = 0; names[i]; i++) {
+		void *library = dlopen(names[i], RTLD_LAZY | RTLD_LOCAL);
+
+		if (library) {
+			return library;
+		}
+	}
+	return nullptr;
+}
+
+void *GLLoader_getProcAddress(const char *name)
+{
+#if defined(__APPLE__)
+	static const char *const gl_names[] = { "/System/Library/Frameworks/OpenGL.framework/OpenGL", nullptr };
+	static void *gl = openLibrary(gl_names);
+	return gl ? dlsym(gl, name) : nullptr;
+#else
+	/* the libraries of the vendor neutral dispatch, or of the driver */
+	static const char *const gl_names[] = { "libOpenGL.so.0", "libGL.so.1", nullptr };
+	static const char *const glx_names[] = { "libGL.so.1", "libGLX.so.0", nullptr };
+	static const char *const egl_names[] = { "libEGL.so.1", nullptr };
+
+	static void *gl = openLibrary(gl_names);
+	static void *glx = openLibrary(glx_names);
+	static void *egl = openLibrary(egl_names);
+	static PFN_getProcAddress glx_proc = glx ? (PFN_getProcAddress)dlsym(glx, "glXGetProcAddressARB") : nullptr;
+	static PFN_getProcAddress egl_proc = egl ? (PFN_getProcAddress)dlsym(egl, "eglGetProcAddress") : nullptr;
+
+	void *proc = gl ? dlsym(gl, name) : nullptr;
+
+	if (!proc && egl_proc) {
+		proc = egl_proc(name);
+	}
+
+	if (!proc && glx_proc) {
+		proc = glx_proc(name);
+	}
+	return proc;
+#endif
+}
+
+#endif
+
+/* the entry point, or the missing one that does nothing */
+static void *resolve(const char *name, void *missing)
+{
+	void *proc = GLLoader_getProcAddress(name);
+	s_resolved++;
+
+	if (!proc) {
+		BRIDGE_LOG_ERROR("GL entry point %s is missing", name);
+		return missing;
+	}
+	return proc;
+}
+
+unsigned int GLLoader_getResolved(void)
+{
+	return s_resolved;
+}
+
+bool GLLoader_isVersion(const int major, const int minor)
+{
+	const char *version = (const char *)glGetString(GL_VERSION);
+	int context_major = 0, context_minor = 0;
+
+	if (!version) {
+		return false;
+	}
+
+	/* "major.minor", after "OpenGL ES " on embedded systems */
+	while (*version && (*version < '0' || *version > '9')) {
+		version++;
+	}
+
+	if (sscanf(version, "%d.%d", &context_major, &context_minor) != 2) {
+		return false;
+	}
+	return context_major > major || (context_major == major && context_minor >= minor);
+}
+
+bool GLLoader_hasExtension(const char *name)
+{
+	if (GLLoader_isVersion(3, 0)) {
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		for (GLint i = 0; i < count; i++) {
+			const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, i);
+
+			if (extension && strcmp(extension, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/* a single string, separated by spaces */
+	const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+	const size_t length = strlen(name);
+
+	for (const char *found = extensions ? strstr(extensions, name) : nullptr; found; found = strstr(found + length, name)) {
+		const bool is_start = (found == extensions || found[-1] == ' ');
+		const bool is_end = (found[length] == ' ' || found[length] == '\0');
+
+		if (is_start && is_end) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void GLLOADER_APIENTRY missing_glBindFramebuffer(GLenum, GLuint)
+{
+}
+
+static void GLLOADER_APIENTRY load_glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	GLLoader_glBindFramebuffer = (PFN_glBindFramebuffer)resolve("glBindFramebuffer", (void *)missing_glBindFramebuffer);
+	GLLoader_glBindFramebuffer(target, framebuffer);
+}
+
+PFN_glBindFramebuffer GLLoader_glBindFramebuffer = load_glBindFramebuffer;
+
+static void GLLOADER_APIENTRY missing_glBindTexture(GLenum, GLuint)
+{
+}
+
+static void GLLOADER_APIENTRY load_glBindTexture(GLenum target, GLuint texture)
+{
+	GLLoader_glBindTexture = (PFN_glBindTexture)resolve("glBindTexture", (void *)missing_glBindTexture);
+	GLLoader_glBindTexture(target, texture);
+}
+
+PFN_glBindTexture GLLoader_glBindTexture = load_glBindTexture;
+
+static void GLLOADER_APIENTRY missing_glBlitFramebuffer(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum)
+{
+}
+
+static void GLLOADER_APIENTRY load_glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+	GLLoader_glBlitFramebuffer = (PFN_glBlitFramebuffer)resolve("glBlitFramebuffer", (void *)missing_glBlitFramebuffer);
+	GLLoader_glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+PFN_glBlitFramebuffer GLLoader_glBlitFramebuffer = load_glBlitFramebuffer;
+
+static void GLLOADER_APIENTRY missing_glClear(GLbitfield)
+{
+}
+
+static void GLLOADER_APIENTRY load_glClear(GLbitfield mask)
+{
+	GLLoader_glClear = (PFN_glClear)resolve("glClear", (void *)missing_glClear);
+	GLLoader_glClear(mask);
+}
+
+PFN_glClear GLLoader_glClear = load_glClear;
+
+static void GLLOADER_APIENTRY missing_glDeleteFramebuffers(GLsizei, const GLuint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
+{
+	GLLoader_glDeleteFramebuffers = (PFN_glDeleteFramebuffers)resolve("glDeleteFramebuffers", (void *)missing_glDeleteFramebuffers);
+	GLLoader_glDeleteFramebuffers(n, framebuffers);
+}
+
+PFN_glDeleteFramebuffers GLLoader_glDeleteFramebuffers = load_glDeleteFramebuffers;
+
+static void GLLOADER_APIENTRY missing_glDeleteQueries(GLsizei, const GLuint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glDeleteQueries(GLsizei n, const GLuint *ids)
+{
+	GLLoader_glDeleteQueries = (PFN_glDeleteQueries)resolve("glDeleteQueries", (void *)missing_glDeleteQueries);
+	GLLoader_glDeleteQueries(n, ids);
+}
+
+PFN_glDeleteQueries GLLoader_glDeleteQueries = load_glDeleteQueries;
+
+static void GLLOADER_APIENTRY missing_glDeleteSync(GLsync)
+{
+}
+
+static void GLLOADER_APIENTRY load_glDeleteSync(GLsync sync)
+{
+	GLLoader_glDeleteSync = (PFN_glDeleteSync)resolve("glDeleteSync", (void *)missing_glDeleteSync);
+	GLLoader_glDeleteSync(sync);
+}
+
+PFN_glDeleteSync GLLoader_glDeleteSync = load_glDeleteSync;
+
+static void GLLOADER_APIENTRY missing_glDeleteTextures(GLsizei, const GLuint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glDeleteTextures(GLsizei n, const GLuint *textures)
+{
+	GLLoader_glDeleteTextures = (PFN_glDeleteTextures)resolve("glDeleteTextures", (void *)missing_glDeleteTextures);
+	GLLoader_glDeleteTextures(n, textures);
+}
+
+PFN_glDeleteTextures GLLoader_glDeleteTextures = load_glDeleteTextures;
+
+static void GLLOADER_APIENTRY missing_glDisable(GLenum)
+{
+}
+
+static void GLLOADER_APIENTRY load_glDisable(GLenum cap)
+{
+	GLLoader_glDisable = (PFN_glDisable)resolve("glDisable", (void *)missing_glDisable);
+	GLLoader_glDisable(cap);
+}
+
+PFN_glDisable GLLoader_glDisable = load_glDisable;
+
+static void GLLOADER_APIENTRY missing_glEnable(GLenum)
+{
+}
+
+static void GLLOADER_APIENTRY load_glEnable(GLenum cap)
+{
+	GLLoader_glEnable = (PFN_glEnable)resolve("glEnable", (void *)missing_glEnable);
+	GLLoader_glEnable(cap);
+}
+
+PFN_glEnable GLLoader_glEnable = load_glEnable;
+
+static GLsync GLLOADER_APIENTRY missing_glFenceSync(GLenum, GLbitfield)
+{
+	return 0;
+}
+
+static GLsync GLLOADER_APIENTRY load_glFenceSync(GLenum condition, GLbitfield flags)
+{
+	GLLoader_glFenceSync = (PFN_glFenceSync)resolve("glFenceSync", (void *)missing_glFenceSync);
+	return GLLoader_glFenceSync(condition, flags);
+}
+
+PFN_glFenceSync GLLoader_glFenceSync = load_glFenceSync;
+
+static void GLLOADER_APIENTRY missing_glFlush(void)
+{
+}
+
+static void GLLOADER_APIENTRY load_glFlush(void)
+{
+	GLLoader_glFlush = (PFN_glFlush)resolve("glFlush", (void *)missing_glFlush);
+	GLLoader_glFlush();
+}
+
+PFN_glFlush GLLoader_glFlush = load_glFlush;
+
+static void GLLOADER_APIENTRY missing_glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint)
+{
+}
+
+static void GLLOADER_APIENTRY load_glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+	GLLoader_glFramebufferTexture2D = (PFN_glFramebufferTexture2D)resolve("glFramebufferTexture2D", (void *)missing_glFramebufferTexture2D);
+	GLLoader_glFramebufferTexture2D(target, attachment, textarget, texture, level);
+}
+
+PFN_glFramebufferTexture2D GLLoader_glFramebufferTexture2D = load_glFramebufferTexture2D;
+
+static void GLLOADER_APIENTRY missing_glGenFramebuffers(GLsizei, GLuint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGenFramebuffers(GLsizei n, GLuint *framebuffers)
+{
+	GLLoader_glGenFramebuffers = (PFN_glGenFramebuffers)resolve("glGenFramebuffers", (void *)missing_glGenFramebuffers);
+	GLLoader_glGenFramebuffers(n, framebuffers);
+}
+
+PFN_glGenFramebuffers GLLoader_glGenFramebuffers = load_glGenFramebuffers;
+
+static void GLLOADER_APIENTRY missing_glGenQueries(GLsizei, GLuint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGenQueries(GLsizei n, GLuint *ids)
+{
+	GLLoader_glGenQueries = (PFN_glGenQueries)resolve("glGenQueries", (void *)missing_glGenQueries);
+	GLLoader_glGenQueries(n, ids);
+}
+
+PFN_glGenQueries GLLoader_glGenQueries = load_glGenQueries;
+
+static void GLLOADER_APIENTRY missing_glGenTextures(GLsizei, GLuint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGenTextures(GLsizei n, GLuint *textures)
+{
+	GLLoader_glGenTextures = (PFN_glGenTextures)resolve("glGenTextures", (void *)missing_glGenTextures);
+	GLLoader_glGenTextures(n, textures);
+}
+
+PFN_glGenTextures GLLoader_glGenTextures = load_glGenTextures;
+
+static void GLLOADER_APIENTRY missing_glGenerateMipmap(GLenum)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGenerateMipmap(GLenum target)
+{
+	GLLoader_glGenerateMipmap = (PFN_glGenerateMipmap)resolve("glGenerateMipmap", (void *)missing_glGenerateMipmap);
+	GLLoader_glGenerateMipmap(target);
+}
+
+PFN_glGenerateMipmap GLLoader_glGenerateMipmap = load_glGenerateMipmap;
+
+static void GLLOADER_APIENTRY missing_glGetIntegerv(GLenum, GLint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGetIntegerv(GLenum pname, GLint *data)
+{
+	GLLoader_glGetIntegerv = (PFN_glGetIntegerv)resolve("glGetIntegerv", (void *)missing_glGetIntegerv);
+	GLLoader_glGetIntegerv(pname, data);
+}
+
+PFN_glGetIntegerv GLLoader_glGetIntegerv = load_glGetIntegerv;
+
+static void GLLOADER_APIENTRY missing_glGetQueryObjectiv(GLuint, GLenum, GLint *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGetQueryObjectiv(GLuint id, GLenum pname, GLint *params)
+{
+	GLLoader_glGetQueryObjectiv = (PFN_glGetQueryObjectiv)resolve("glGetQueryObjectiv", (void *)missing_glGetQueryObjectiv);
+	GLLoader_glGetQueryObjectiv(id, pname, params);
+}
+
+PFN_glGetQueryObjectiv GLLoader_glGetQueryObjectiv = load_glGetQueryObjectiv;
+
+static void GLLOADER_APIENTRY missing_glGetQueryObjectui64v(GLuint, GLenum, GLuint64 *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params)
+{
+	GLLoader_glGetQueryObjectui64v = (PFN_glGetQueryObjectui64v)resolve("glGetQueryObjectui64v", (void *)missing_glGetQueryObjectui64v);
+	GLLoader_glGetQueryObjectui64v(id, pname, params);
+}
+
+PFN_glGetQueryObjectui64v GLLoader_glGetQueryObjectui64v = load_glGetQueryObjectui64v;
+
+static const GLubyte * GLLOADER_APIENTRY missing_glGetString(GLenum)
+{
+	return 0;
+}
+
+static const GLubyte * GLLOADER_APIENTRY load_glGetString(GLenum name)
+{
+	GLLoader_glGetString = (PFN_glGetString)resolve("glGetString", (void *)missing_glGetString);
+	return GLLoader_glGetString(name);
+}
+
+PFN_glGetString GLLoader_glGetString = load_glGetString;
+
+static const GLubyte * GLLOADER_APIENTRY missing_glGetStringi(GLenum, GLuint)
+{
+	return 0;
+}
+
+static const GLubyte * GLLOADER_APIENTRY load_glGetStringi(GLenum name, GLuint index)
+{
+	GLLoader_glGetStringi = (PFN_glGetStringi)resolve("glGetStringi", (void *)missing_glGetStringi);
+	return GLLoader_glGetStringi(name, index);
+}
+
+PFN_glGetStringi GLLoader_glGetStringi = load_glGetStringi;
+
+static void GLLOADER_APIENTRY missing_glQueryCounter(GLuint, GLenum)
+{
+}
+
+static void GLLOADER_APIENTRY load_glQueryCounter(GLuint id, GLenum target)
+{
+	GLLoader_glQueryCounter = (PFN_glQueryCounter)resolve("glQueryCounter", (void *)missing_glQueryCounter);
+	GLLoader_glQueryCounter(id, target);
+}
+
+PFN_glQueryCounter GLLoader_glQueryCounter = load_glQueryCounter;
+
+static void GLLOADER_APIENTRY missing_glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void *)
+{
+}
+
+static void GLLOADER_APIENTRY load_glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels)
+{
+	GLLoader_glTexImage2D = (PFN_glTexImage2D)resolve("glTexImage2D", (void *)missing_glTexImage2D);
+	GLLoader_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+PFN_glTexImage2D GLLoader_glTexImage2D = load_glTexImage2D;
+
+static void GLLOADER_APIENTRY missing_glTexImage2DMultisample(GLenum, GLsizei, GLenum, GLsizei, GLsizei, GLboolean)
+{
+}
+
+static void GLLOADER_APIENTRY load_glTexImage2DMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations)
+{
+	GLLoader_glTexImage2DMultisample = (PFN_glTexImage2DMultisample)resolve("glTexImage2DMultisample", (void *)missing_glTexImage2DMultisample);
+	GLLoader_glTexImage2DMultisample(target, samples, internalformat, width, height, fixedsamplelocations);
+}
+
+PFN_glTexImage2DMultisample GLLoader_glTexImage2DMultisample = load_glTexImage2DMultisample;
+
+static void GLLOADER_APIENTRY missing_glTexParameteri(GLenum, GLenum, GLint)
+{
+}
+
+static void GLLOADER_APIENTRY load_glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	GLLoader_glTexParameteri = (PFN_glTexParameteri)resolve("glTexParameteri", (void *)missing_glTexParameteri);
+	GLLoader_glTexParameteri(target, pname, param);
+}
+
+PFN_glTexParameteri GLLoader_glTexParameteri = load_glTexParameteri;
+
+static void GLLOADER_APIENTRY missing_glWaitSync(GLsync, GLbitfield, GLuint64)
+{
+}
+
+static void GLLOADER_APIENTRY load_glWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	GLLoader_glWaitSync = (PFN_glWaitSync)resolve("glWaitSync", (void *)missing_glWaitSync);
+	GLLoader_glWaitSync(sync, flags, timeout);
+}
+
+PFN_glWaitSync GLLoader_glWaitSync = load_glWaitSync;
+
+const char *const GLLoader_names[GLLOADER_COUNT] = {
+	"glBindFramebuffer",
+	"glBindTexture",
+	"glBlitFramebuffer",
+	"glClear",
+	"glDeleteFramebuffers",
+	"glDeleteQueries",
+	"glDeleteSync",
+	"glDeleteTextures",
+	"glDisable",
+	"glEnable",
+	"glFenceSync",
+	"glFlush",
+	"glFramebufferTexture2D",
+	"glGenFramebuffers",
+	"glGenQueries",
+	"glGenTextures",
+	"glGenerateMipmap",
+	"glGetIntegerv",
+	"glGetQueryObjectiv",
+	"glGetQueryObjectui64v",
+	"glGetString",
+	"glGetStringi",
+	"glQueryCounter",
+	"glTexImage2D",
+	"glTexImage2DMultisample",
+	"glTexParameteri",
+	"glWaitSync",
+};
+
+#if defined(_WIN32) || defined(_WIN64)
+
+static HGLRC GLLOADER_APIENTRY missing_wglCreateContextAttribsARB(HDC, HGLRC, const int *)
+{
+	return 0;
+}
+
+static HGLRC GLLOADER_APIENTRY load_wglCreateContextAttribsARB(HDC hDC, HGLRC hShareContext, const int *attribList)
+{
+	GLLoader_wglCreateContextAttribsARB = (PFN_wglCreateContextAttribsARB)resolve("wglCreateContextAttribsARB", (void *)missing_wglCreateContextAttribsARB);
+	return GLLoader_wglCreateContextAttribsARB(hDC, hShareContext, attribList);
+}
+
+PFN_wglCreateContextAttribsARB GLLoader_wglCreateContextAttribsARB = load_wglCreateContextAttribsARB;
+
+static BOOL GLLOADER_APIENTRY missing_wglSwapIntervalEXT(int)
+{
+	return 0;
+}
+
+static BOOL GLLOADER_APIENTRY load_wglSwapIntervalEXT(int interval)
+{
+	GLLoader_wglSwapIntervalEXT = (PFN_wglSwapIntervalEXT)resolve("wglSwapIntervalEXT", (void *)missing_wglSwapIntervalEXT);
+	return GLLoader_wglSwapIntervalEXT(interval);
+}
+
+PFN_wglSwapIntervalEXT GLLoader_wglSwapIntervalEXT = load_wglSwapIntervalEXT;
+#endif
@@ -0,0 +1,207 @@
+/* generated by generate-gl-loader.py, do not edit */
+
+#ifndef __GL_LOADER_H__
+#define __GL_LOADER_H__
+
+/* The GL entry points of the bridge, in place of GLEW: every one of them is resolved in the
+ * context current at its first call, and only if it is called. No system GL header is needed,
+ * none is to be included with this one.
+ *
+ * The entry points of GL 1.1 are the same in every context, the others are too as long as the
+ * contexts are of the same device (as GLEW assumes as well) */
+
+#if defined(__gl_h_) || defined(__GL_H__) || defined(__glew_h__)
+#error "GLLoader.h replaces the GL headers"
+#endif
+
+#include <stdint.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#define GLLOADER_APIENTRY __stdcall
+#else
+#define GLLOADER_APIENTRY
+#endif
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned int GLuint;
+typedef unsigned char GLubyte;
+typedef uint64_t GLuint64;
+typedef struct __GLsync *GLsync;
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_RGBA 0x1908
+#define GL_VERSION 0x1F02
+#define GL_EXTENSIONS 0x1F03
+#define GL_NEAREST 0x2600
+#define GL_LINEAR 0x2601
+#define GL_LINEAR_MIPMAP_LINEAR 0x2703
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_REPEAT 0x2901
+#define GL_RGBA8 0x8058
+#define GL_CLAMP_TO_EDGE 0x812F
+#define GL_NUM_EXTENSIONS 0x821D
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_SRGB8_ALPHA8 0x8C43
+#define GL_DRAW_FRAMEBUFFER_BINDING 0x8CA6
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_READ_FRAMEBUFFER_BINDING 0x8CAA
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_MAX_SAMPLES 0x8D57
+#define GL_FRAMEBUFFER_SRGB 0x8DB9
+#define GL_TIMESTAMP 0x8E28
+#define GL_TEXTURE_2D_MULTISAMPLE 0x9100
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+
+/* entry points, resolved by their first call */
+
+typedef void (GLLOADER_APIENTRY *PFN_glBindFramebuffer)(GLenum target, GLuint framebuffer);
+extern PFN_glBindFramebuffer GLLoader_glBindFramebuffer;
+#define glBindFramebuffer GLLoader_glBindFramebuffer
+
+typedef void (GLLOADER_APIENTRY *PFN_glBindTexture)(GLenum target, GLuint texture);
+extern PFN_glBindTexture GLLoader_glBindTexture;
+#define glBindTexture GLLoader_glBindTexture
+
+typedef void (GLLOADER_APIENTRY *PFN_glBlitFramebuffer)(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+extern PFN_glBlitFramebuffer GLLoader_glBlitFramebuffer;
+#define glBlitFramebuffer GLLoader_glBlitFramebuffer
+
+typedef void (GLLOADER_APIENTRY *PFN_glClear)(GLbitfield mask);
+extern PFN_glClear GLLoader_glClear;
+#define glClear GLLoader_glClear
+
+typedef void (GLLOADER_APIENTRY *PFN_glDeleteFramebuffers)(GLsizei n, const GLuint *framebuffers);
+extern PFN_glDeleteFramebuffers GLLoader_glDeleteFramebuffers;
+#define glDeleteFramebuffers GLLoader_glDeleteFramebuffers
+
+typedef void (GLLOADER_APIENTRY *PFN_glDeleteQueries)(GLsizei n, const GLuint *ids);
+extern PFN_glDeleteQueries GLLoader_glDeleteQueries;
+#define glDeleteQueries GLLoader_glDeleteQueries
+
+typedef void (GLLOADER_APIENTRY *PFN_glDeleteSync)(GLsync sync);
+extern PFN_glDeleteSync GLLoader_glDeleteSync;
+#define glDeleteSync GLLoader_glDeleteSync
+
+typedef void (GLLOADER_APIENTRY *PFN_glDeleteTextures)(GLsizei n, const GLuint *textures);
+extern PFN_glDeleteTextures GLLoader_glDeleteTextures;
+#define glDeleteTextures GLLoader_glDeleteTextures
+
+typedef void (GLLOADER_APIENTRY *PFN_glDisable)(GLenum cap);
+extern PFN_glDisable GLLoader_glDisable;
+#define glDisable GLLoader_glDisable
+
+typedef void (GLLOADER_APIENTRY *PFN_glEnable)(GLenum cap);
+extern PFN_glEnable GLLoader_glEnable;
+#define glEnable GLLoader_glEnable
+
+typedef GLsync (GLLOADER_APIENTRY *PFN_glFenceSync)(GLenum condition, GLbitfield flags);
+extern PFN_glFenceSync GLLoader_glFenceSync;
+#define glFenceSync GLLoader_glFenceSync
+
+typedef void (GLLOADER_APIENTRY *PFN_glFlush)(void);
+extern PFN_glFlush GLLoader_glFlush;
+#define glFlush GLLoader_glFlush
+
+typedef void (GLLOADER_APIENTRY *PFN_glFramebufferTexture2D)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+extern PFN_glFramebufferTexture2D GLLoader_glFramebufferTexture2D;
+#define glFramebufferTexture2D GLLoader_glFramebufferTexture2D
+
+typedef void (GLLOADER_APIENTRY *PFN_glGenFramebuffers)(GLsizei n, GLuint *framebuffers);
+extern PFN_glGenFramebuffers GLLoader_glGenFramebuffers;
+#define glGenFramebuffers GLLoader_glGenFramebuffers
+
+typedef void (GLLOADER_APIENTRY *PFN_glGenQueries)(GLsizei n, GLuint *ids);
+extern PFN_glGenQueries GLLoader_glGenQueries;
+#define glGenQueries GLLoader_glGenQueries
+
+typedef void (GLLOADER_APIENTRY *PFN_glGenTextures)(GLsizei n, GLuint *textures);
+extern PFN_glGenTextures GLLoader_glGenTextures;
+#define glGenTextures GLLoader_glGenTextures
+
+typedef void (GLLOADER_APIENTRY *PFN_glGenerateMipmap)(GLenum target);
+extern PFN_glGenerateMipmap GLLoader_glGenerateMipmap;
+#define glGenerateMipmap GLLoader_glGenerateMipmap
+
+typedef void (GLLOADER_APIENTRY *PFN_glGetIntegerv)(GLenum pname, GLint *data);
+extern PFN_glGetIntegerv GLLoader_glGetIntegerv;
+#define glGetIntegerv GLLoader_glGetIntegerv
+
+typedef void (GLLOADER_APIENTRY *PFN_glGetQueryObjectiv)(GLuint id, GLenum pname, GLint *params);
+extern PFN_glGetQueryObjectiv GLLoader_glGetQueryObjectiv;
+#define glGetQueryObjectiv GLLoader_glGetQueryObjectiv
+
+typedef void (GLLOADER_APIENTRY *PFN_glGetQueryObjectui64v)(GLuint id, GLenum pname, GLuint64 *params);
+extern PFN_glGetQueryObjectui64v GLLoader_glGetQueryObjectui64v;
+#define glGetQueryObjectui64v GLLoader_glGetQueryObjectui64v
+
+typedef const GLubyte * (GLLOADER_APIENTRY *PFN_glGetString)(GLenum name);
+extern PFN_glGetString GLLoader_glGetString;
+#define glGetString GLLoader_glGetString
+
+typedef const GLubyte * (GLLOADER_APIENTRY *PFN_glGetStringi)(GLenum name, GLuint index);
+extern PFN_glGetStringi GLLoader_glGetStringi;
+#define glGetStringi GLLoader_glGetStringi
+
+typedef void (GLLOADER_APIENTRY *PFN_glQueryCounter)(GLuint id, GLenum target);
+extern PFN_glQueryCounter GLLoader_glQueryCounter;
+#define glQueryCounter GLLoader_glQueryCounter
+
+typedef void (GLLOADER_APIENTRY *PFN_glTexImage2D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels);
+extern PFN_glTexImage2D GLLoader_glTexImage2D;
+#define glTexImage2D GLLoader_glTexImage2D
+
+typedef void (GLLOADER_APIENTRY *PFN_glTexImage2DMultisample)(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations);
+extern PFN_glTexImage2DMultisample GLLoader_glTexImage2DMultisample;
+#define glTexImage2DMultisample GLLoader_glTexImage2DMultisample
+
+typedef void (GLLOADER_APIENTRY *PFN_glTexParameteri)(GLenum target, GLenum pname, GLint param);
+extern PFN_glTexParameteri GLLoader_glTexParameteri;
+#define glTexParameteri GLLoader_glTexParameteri
+
+typedef void (GLLOADER_APIENTRY *PFN_glWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+extern PFN_glWaitSync GLLoader_glWaitSync;
+#define glWaitSync GLLoader_glWaitSync
+
+#if defined(_WIN32) || defined(_WIN64)
+typedef HGLRC (GLLOADER_APIENTRY *PFN_wglCreateContextAttribsARB)(HDC hDC, HGLRC hShareContext, const int *attribList);
+extern PFN_wglCreateContextAttribsARB GLLoader_wglCreateContextAttribsARB;
+#define wglCreateContextAttribsARB GLLoader_wglCreateContextAttribsARB
+
+typedef BOOL (GLLOADER_APIENTRY *PFN_wglSwapIntervalEXT)(int interval);
+extern PFN_wglSwapIntervalEXT GLLoader_wglSwapIntervalEXT;
+#define wglSwapIntervalEXT GLLoader_wglSwapIntervalEXT
+#endif
+
+/* names of the GL entry points above, WGL excluded */
+#define GLLOADER_COUNT 27
+extern const char *const GLLoader_names[GLLOADER_COUNT];
+
+/* address of an entry point in the current context, nullptr if it has none */
+void *GLLoader_getProcAddress(const char *name);
+
+/* entry points resolved so far */
+unsigned int GLLoader_getResolved(void);
+
+/* the current context is at least of the version major.minor */
+bool GLLoader_isVersion(const int major, const int minor);
+
+/* the current context has the extension */
+bool GLLoader_hasExtension(const char *name);
+
+#endif /* __GL_LOADER_H__ */
@@ -0,0 +1,207 @@
+#ifndef __GL_STATE_H__
+#define __GL_STATE_H__
+
+/* GL enums used by the cache, without depending on a GL header */
+#ifndef GL_TEXTURE_2D
+#define GL_TEXTURE_2D 0x0DE1
+#endif
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#endif
+#ifndef GL_READ_FRAMEBUFFER_BINDING
+#define GL_READ_FRAMEBUFFER_BINDING 0x8CAA
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER_BINDING
+#define GL_DRAW_FRAMEBUFFER_BINDING 0x8CA6
+#endif
+#ifndef GL_FRAMEBUFFER_SRGB
+#define GL_FRAMEBUFFER_SRGB 0x8DB9
+#endif
+
+/* the GL entry points the cache calls, filled by the backend once GL is loaded */
+struct GLStateFunctions
+{
+	void (*bindFramebuffer)(const unsigned int target, const unsigned int framebuffer);
+	void (*bindTexture)(const unsigned int target, const unsigned int texture);
+	void (*enable)(const unsigned int cap);
+	void (*disable)(const unsigned int cap);
+	void (*getIntegerv)(const unsigned int pname, int *r_data);
+};
+
+/* Shadow of the GL state the bridge changes: the framebuffer bindings, the 2D texture binding
+ * and GL_FRAMEBUFFER_SRGB. A change to the current value issues no GL call.
+ *
+ * Between begin() and end() the bridge owns the context. begin() learns the framebuffers of the
+ * application, either the ones it was told with setApplicationBindings or with glGetIntegerv
+ * (a client/server round trip on many drivers), and end() binds them back.
+ * Outside of begin()/end() the application may change anything, so the state is forgotten.
+ *
+ * Every GL call of the bridge is counted, the ones not going through the cache with countCalls,
+ * endFrame() closes the count of the frame */
+class GLStateCache
+{
+public:
+	GLStateCache() :
+		m_is_application_known(false),
+		m_application_draw(0),
+		m_application_read(0),
+		m_calls(0),
+		m_frame_calls(0)
+	{
+		this->m_functions.bindFramebuffer = nullptr;
+		this->m_functions.bindTexture = nullptr;
+		this->m_functions.enable = nullptr;
+		this->m_functions.disable = nullptr;
+		this->m_functions.getIntegerv = nullptr;
+		this->forget();
+	}
+
+	void setFunctions(const GLStateFunctions &functions)
+	{
+		this->m_functions = functions;
+	}
+
+	/* framebuffers bound by the application when it calls the bridge, no query is made anymore */
+	void setApplicationBindings(const unsigned int draw_framebuffer, const unsigned int read_framebuffer)
+	{
+		this->m_application_draw = draw_framebuffer;
+		this->m_application_read = read_framebuffer;
+		this->m_is_application_known = true;
+	}
+
+	/* query the application framebuffers again */
+	void clearApplicationBindings()
+	{
+		this->m_is_application_known = false;
+	}
+
+	void begin()
+	{
+		this->forget();
+
+		if (!this->m_is_application_known) {
+			int draw = 0, read = 0;
+
+			this->m_functions.getIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw);
+			this->m_functions.getIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read);
+			this->m_calls += 2;
+
+			this->m_application_draw = (unsigned int)draw;
+			this->m_application_read = (unsigned int)read;
+		}
+
+		this->m_draw_framebuffer = this->m_application_draw;
+		this->m_read_framebuffer = this->m_application_read;
+	}
+
+	void end()
+	{
+		this->bindFramebuffer(GL_DRAW_FRAMEBUFFER, this->m_application_draw);
+		this->bindFramebuffer(GL_READ_FRAMEBUFFER, this->m_application_read);
+		this->forget();
+	}
+
+	/* GL_FRAMEBUFFER binds both the draw and the read framebuffer */
+	void bindFramebuffer(const unsigned int target, const unsigned int framebuffer)
+	{
+		const bool is_draw = (target != GL_READ_FRAMEBUFFER) && (this->m_draw_framebuffer != framebuffer);
+		const bool is_read = (target != GL_DRAW_FRAMEBUFFER) && (this->m_read_framebuffer != framebuffer);
+
+		if (is_draw && is_read) {
+			this->call(GL_FRAMEBUFFER, framebuffer);
+		}
+		else if (is_draw) {
+			this->call(GL_DRAW_FRAMEBUFFER, framebuffer);
+		}
+		else if (is_read) {
+			this->call(GL_READ_FRAMEBUFFER, framebuffer);
+		}
+
+		if (target != GL_READ_FRAMEBUFFER) {
+			this->m_draw_framebuffer = framebuffer;
+		}
+
+		if (target != GL_DRAW_FRAMEBUFFER) {
+			this->m_read_framebuffer = framebuffer;
+		}
+	}
+
+	void bindTexture2D(const unsigned int texture)
+	{
+		if (this->m_texture != texture) {
+			this->m_functions.bindTexture(GL_TEXTURE_2D, texture);
+			this->m_texture = texture;
+			this->m_calls++;
+		}
+	}
+
+	void setFramebufferSRGB(const bool is_enabled)
+	{
+		const int value = is_enabled ? 1 : 0;
+
+		if (this->m_framebuffer_srgb != value) {
+			if (is_enabled) {
+				this->m_functions.enable(GL_FRAMEBUFFER_SRGB);
+			}
+			else {
+				this->m_functions.disable(GL_FRAMEBUFFER_SRGB);
+			}
+			this->m_framebuffer_srgb = value;
+			this->m_calls++;
+		}
+	}
+
+	/* GL calls made directly by the bridge */
+	void countCalls(const unsigned int calls)
+	{
+		this->m_calls += calls;
+	}
+
+	void endFrame()
+	{
+		this->m_frame_calls = this->m_calls;
+		this->m_calls = 0;
+	}
+
+	/* GL calls of the last frame */
+	unsigned int getFrameCalls() const { return this->m_frame_calls; }
+
+private:
+	enum { UNKNOWN = 0xffffffffu };
+
+	void call(const unsigned int target, const unsigned int framebuffer)
+	{
+		this->m_functions.bindFramebuffer(target, framebuffer);
+		this->m_calls++;
+	}
+
+	void forget()
+	{
+		this->m_draw_framebuffer = UNKNOWN;
+		this->m_read_framebuffer = UNKNOWN;
+		this->m_texture = UNKNOWN;
+		this->m_framebuffer_srgb = -1;
+	}
+
+	GLStateFunctions m_functions;
+
+	bool m_is_application_known;
+	unsigned int m_application_draw;
+	unsigned int m_application_read;
+
+	unsigned int m_draw_framebuffer;
+	unsigned int m_read_framebuffer;
+	unsigned int m_texture;
+	int m_framebuffer_srgb; /* -1 when unknown */
+
+	unsigned int m_calls;
+	unsigned int m_frame_calls;
+};
+
+#endif /* __GL_STATE_H__ */
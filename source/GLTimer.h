@@ -0,0 +1,263 @@
+#ifndef __GL_TIMER_H__
+#define __GL_TIMER_H__
+
+#include "HMD_Bridge_API.h"
+
+#include <algorithm>
+#include <string.h>
+
+/* GL enums used by the timer, without depending on a GL header */
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+/* the GL entry points of ARB_timer_query (core in GL 3.3), filled by the backend once GL is loaded */
+struct GLTimerFunctions
+{
+	void (*genQueries)(const int n, unsigned int *r_ids);
+	void (*deleteQueries)(const int n, const unsigned int *ids);
+	void (*queryCounter)(const unsigned int id, const unsigned int target);
+	void (*getQueryObjectiv)(const unsigned int id, const unsigned int pname, int *r_params);
+	void (*getQueryObjectui64v)(const unsigned int id, const unsigned int pname, unsigned long long *r_params);
+};
+
+/* GPU time of the sections of the bridge GL work.
+ *
+ * Every section is enclosed by two GL_TIMESTAMP queries, unlike GL_TIME_ELAPSED they can nest
+ * (the eyes are within the submission). The queries of FRAMES frames are in flight, the results
+ * are read once available, a few frames late, and never waited for: when the GPU is so late that a
+ * frame comes back to queries still pending, those are dropped.
+ *
+ * The queries belong to the context they are created in */
+class GLTimer
+{
+public:
+	enum eSection
+	{
+		EYE_LEFT = 0,
+		EYE_RIGHT,
+		SUBMIT,
+		SECTIONS,
+	};
+
+	enum
+	{
+		FRAMES = 4, /* in flight */
+		WINDOW = 128, /* frames of the average and percentile */
+	};
+
+	GLTimer() :
+		m_is_created(false),
+		m_index(0),
+		m_is_frame_open(false)
+	{
+		this->m_functions.genQueries = nullptr;
+		this->m_functions.deleteQueries = nullptr;
+		this->m_functions.queryCounter = nullptr;
+		this->m_functions.getQueryObjectiv = nullptr;
+		this->m_functions.getQueryObjectui64v = nullptr;
+
+		memset(this->m_queries, 0, sizeof(this->m_queries));
+		memset(this->m_used, 0, sizeof(this->m_used));
+		memset(this->m_is_pending, 0, sizeof(this->m_is_pending));
+		this->resetStats();
+	}
+
+	void setFunctions(const GLTimerFunctions &functions)
+	{
+		this->m_functions = functions;
+	}
+
+	/* in the current context */
+	void create()
+	{
+		if (this->m_is_created) {
+			return;
+		}
+
+		this->m_functions.genQueries(QUERIES, &this->m_queries[0][0][0]);
+		memset(this->m_is_pending, 0, sizeof(this->m_is_pending));
+		this->m_index = 0;
+		this->m_is_frame_open = false;
+		this->m_is_created = true;
+	}
+
+	/* in the context it was created in, the results still pending are lost */
+	void destroy()
+	{
+		if (!this->m_is_created) {
+			return;
+		}
+
+		this->m_functions.deleteQueries(QUERIES, &this->m_queries[0][0][0]);
+		this->m_is_created = false;
+	}
+
+	bool isCreated() const { return this->m_is_created; }
+
+	/* read the results available, and start timing a new frame */
+	void beginFrame()
+	{
+		if (!this->m_is_created) {
+			return;
+		}
+
+		this->collect();
+
+		if (this->m_is_pending[this->m_index]) {
+			this->m_is_pending[this->m_index] = false;
+			this->m_stats.dropped++;
+		}
+
+		this->m_used[this->m_index] = 0;
+		this->m_is_frame_open = true;
+	}
+
+	void begin(const eSection section)
+	{
+		if (this->m_is_frame_open) {
+			this->m_functions.queryCounter(this->m_queries[this->m_index][section][0], GL_TIMESTAMP);
+		}
+	}
+
+	void end(const eSection section)
+	{
+		if (this->m_is_frame_open) {
+			this->m_functions.queryCounter(this->m_queries[this->m_index][section][1], GL_TIMESTAMP);
+			this->m_used[this->m_index] |= 1u << section;
+		}
+	}
+
+	void endFrame()
+	{
+		if (!this->m_is_frame_open) {
+			return;
+		}
+
+		this->m_is_pending[this->m_index] = (this->m_used[this->m_index] != 0);
+		this->m_index = (this->m_index + 1) % FRAMES;
+		this->m_is_frame_open = false;
+	}
+
+	/* read the frames whose queries are all available, oldest first */
+	void collect()
+	{
+		for (unsigned int i = 0; i < FRAMES; i++) {
+			const unsigned int frame = (this->m_index + i) % FRAMES;
+
+			if (!this->m_is_pending[frame]) {
+				continue;
+			}
+
+			if (!this->isAvailable(frame)) {
+				/* the newer ones are not available either */
+				return;
+			}
+
+			this->read(frame);
+			this->m_is_pending[frame] = false;
+		}
+	}
+
+	void resetStats()
+	{
+		memset(&this->m_stats, 0, sizeof(this->m_stats));
+		memset(this->m_window, 0, sizeof(this->m_window));
+	}
+
+	/* times in seconds, over the last WINDOW frames read */
+	void getStats(HMD_GPUStats *r_stats) const
+	{
+		*r_stats = this->m_stats;
+
+		HMD_GPUTiming *timings[SECTIONS] = { &r_stats->eye[0], &r_stats->eye[1], &r_stats->submit };
+		const unsigned int count = std::min(this->m_stats.frames, (unsigned int)WINDOW);
+
+		for (int section = 0; section < SECTIONS; section++) {
+			double sorted[WINDOW];
+			double sum = 0.0;
+			unsigned int samples = 0;
+
+			for (unsigned int i = 0; i < count; i++) {
+				const double time = this->m_window[section][i];
+
+				if (time >= 0.0) {
+					sorted[samples++] = time;
+					sum += time;
+				}
+			}
+
+			if (samples == 0) {
+				continue;
+			}
+
+			/* nearest rank */
+			const unsigned int rank = (unsigned int)((samples * 99 + 99) / 100) - 1;
+			std::nth_element(sorted, sorted + rank, sorted + samples);
+
+			timings[section]->average = sum / samples;
+			timings[section]->p99 = sorted[rank];
+		}
+	}
+
+private:
+	enum { QUERIES = FRAMES * SECTIONS * 2 };
+
+	bool isAvailable(const unsigned int frame) const
+	{
+		for (int section = 0; section < SECTIONS; section++) {
+			if (this->m_used[frame] & (1u << section)) {
+				int is_available = 0;
+				this->m_functions.getQueryObjectiv(this->m_queries[frame][section][1], GL_QUERY_RESULT_AVAILABLE, &is_available);
+
+				if (!is_available) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void read(const unsigned int frame)
+	{
+		HMD_GPUTiming *timings[SECTIONS] = { &this->m_stats.eye[0], &this->m_stats.eye[1], &this->m_stats.submit };
+		const unsigned int slot = this->m_stats.frames % WINDOW;
+
+		for (int section = 0; section < SECTIONS; section++) {
+			double time = -1.0; /* not timed this frame */
+
+			if (this->m_used[frame] & (1u << section)) {
+				unsigned long long begin = 0, end = 0;
+
+				this->m_functions.getQueryObjectui64v(this->m_queries[frame][section][0], GL_QUERY_RESULT, &begin);
+				this->m_functions.getQueryObjectui64v(this->m_queries[frame][section][1], GL_QUERY_RESULT, &end);
+
+				time = end > begin ? (end - begin) * 1e-9 : 0.0;
+				timings[section]->last = time;
+			}
+
+			this->m_window[section][slot] = time;
+		}
+		this->m_stats.frames++;
+	}
+
+	GLTimerFunctions m_functions;
+
+	bool m_is_created;
+	unsigned int m_queries[FRAMES][SECTIONS][2]; /* begin and end timestamps */
+	unsigned int m_used[FRAMES]; /* sections timed, one bit each */
+	bool m_is_pending[FRAMES];
+	unsigned int m_index; /* frame being timed */
+	bool m_is_frame_open;
+
+	HMD_GPUStats m_stats; /* averages and percentiles are computed when requested */
+	double m_window[SECTIONS][WINDOW]; /* negative when the section was not timed */
+};
+
+#endif /* __GL_TIMER_H__ */
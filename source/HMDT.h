@@ -0,0 +1,124 @@
+#ifndef __HMDT_H__
+#define __HMDT_H__
+
+#include "Backend.h"
+
+#include <utility>
+
+/* HMD bound at compile time to one backend implementation.
+ *
+ * HMD reaches the device through Backend and a heap allocated BackendImpl, and every call of the
+ * frame goes through its vtable. Here the implementation is a member, called by its qualified
+ * name: nothing of the pose path is dispatched at runtime, and it inlines in the caller (up to
+ * the tracking query of the device, when it is not in a header). The frame state is the one of
+ * BackendImpl instantiated for Impl, with a final Impl the tracking hooks it overrides are bound
+ * statically too, so Impl doesn't override getFrameState.
+ *
+ * Only the per-frame routines are wrapped, the others are reached with getImpl() */
+template <class Impl>
+class HMDT
+{
+public:
+	template <typename... Args>
+	explicit HMDT(Args &&... args) :
+		m_impl(std::forward<Args>(args)...)
+	{}
+
+	~HMDT()
+	{
+		/* the tracking and submit threads can't outlive the implementation */
+		this->m_impl.Impl::stopAsyncSubmit();
+		this->m_impl.Impl::stopTracking();
+	}
+
+	bool setup(const unsigned int color_texture_left, const unsigned int color_texture_right)
+	{
+		return this->m_impl.Impl::setup(color_texture_left, color_texture_right);
+	}
+
+	bool setupSideBySide(const unsigned int color_texture)
+	{
+		return this->m_impl.Impl::setupSideBySide(color_texture);
+	}
+
+	bool getFrameState(HMD_FrameState *r_state)
+	{
+		return this->m_impl.getFrameStateOf(&this->m_impl, r_state);
+	}
+
+	/* legacy routines, each one starts a new frame */
+
+	bool update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+	{
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION;
+
+		if (!this->getFrameState(&state)) {
+			return false;
+		}
+
+		memcpy(r_orientation_left, state.orientation[0], sizeof(float[4]));
+		memcpy(r_orientation_right, state.orientation[1], sizeof(float[4]));
+		memcpy(r_position_left, state.position[0], sizeof(float[3]));
+		memcpy(r_position_right, state.position[1], sizeof(float[3]));
+		return true;
+	}
+
+	bool update(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_VIEW_MATRIX | (is_right_hand ? 0 : HMD_FRAME_LEFT_HANDED);
+
+		if (!this->getFrameState(&state)) {
+			return false;
+		}
+
+		memcpy(r_matrix_left, state.view_matrix[0], sizeof(float[16]));
+		memcpy(r_matrix_right, state.view_matrix[1], sizeof(float[16]));
+		return true;
+	}
+
+	bool getViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		return this->m_impl.Impl::getViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+	}
+
+	void getProjectionMatrices(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+	{
+		this->m_impl.Impl::getProjectionMatrices(nearz, farz, is_opengl, is_right_hand, r_matrix_left, r_matrix_right);
+	}
+
+	bool waitFrame(HMD_FrameTiming *r_timing)
+	{
+		return this->m_impl.Impl::waitFrame(r_timing);
+	}
+
+	bool beginFrame(HMD_FrameState *r_state)
+	{
+		return this->getFrameState(r_state);
+	}
+
+	bool endFrame()
+	{
+		return this->m_impl.Impl::endFrame();
+	}
+
+	bool frameReady(void)
+	{
+		return this->m_impl.Impl::presentFrame();
+	}
+
+	int getWidthLeft() { return this->m_impl.Impl::getWidthLeft(); }
+	int getHeightLeft() { return this->m_impl.Impl::getHeightLeft(); }
+	int getWidthRight() { return this->m_impl.Impl::getWidthRight(); }
+	int getHeightRight() { return this->m_impl.Impl::getHeightRight(); }
+	float getScale() { return this->m_impl.Impl::getScale(); }
+	void setScale(const float scale) { this->m_impl.Impl::setScale(scale); }
+
+	Impl &getImpl() { return this->m_impl; }
+
+private:
+	Impl m_impl;
+};
+
+#endif /* __HMDT_H__ */
@@ -2,44 +2,101 @@
 
 #include "Backend.h"
 
+#include "Log.h"
+#include "PluginLoader.h"
+#include "Replay.h"
+#include "Simulated.h"
 #include "Stub.h"
 
-#if defined OCULUS
-#include "Oculus.h"
-#endif
-
 /* C++ API */
 
+/* name of the plugin of a device, nullptr when there is none */
+static const char *getPluginName(const HMD::eHMDBackend backend)
+{
+	switch (backend) {
+		case HMD::BACKEND_OCULUS:
+			return "BridgeOculus";
+		case HMD::BACKEND_VIVE:
+			return "BridgeVive";
+		case HMD::BACKEND_OSVR:
+			return "BridgeOSVR";
+		case HMD::BACKEND_OPENVR:
+			return "BridgeOpenVR";
+		case HMD::BACKEND_OPENHMD:
+			return "BridgeOpenHMD";
+		default:
+			return nullptr;
+	}
+}
+
 /* legacy overload constructor */
 HMD::HMD():
-	m_hmd(nullptr)
+	HMD(BACKEND_OCULUS)
 {
-#if defined OCULUS
-	m_hmd = new Oculus();
-#else
-	m_hmd = new Stub();
-#endif
 }
 
 HMD::HMD(eHMDBackend backend):
-	m_hmd(nullptr)
+	m_hmd(nullptr),
+	m_plugin(nullptr)
 {
-	switch (backend) {
-		case BACKEND_OCULUS:
-#if defined OCULUS
-			m_hmd = new Oculus();
-			break;
-#endif
-		case BACKEND_VIVE:
-		default:
-			m_hmd = new Stub();
-			break;
+	if (backend == BACKEND_SIMULATED) {
+		m_hmd = new Simulated();
+		return;
+	}
+
+	const HMD_Plugin *plugin = PluginLoader::load(getPluginName(backend));
+
+	if (plugin) {
+		m_hmd = plugin->create();
+	}
+
+	if (m_hmd) {
+		m_plugin = plugin;
+	}
+	else {
+		m_hmd = new Stub();
+	}
+}
+
+HMD::HMD(const HMD_SimulatedConfig *config):
+	m_hmd(nullptr),
+	m_plugin(nullptr)
+{
+	m_hmd = new Simulated(config);
+}
+
+HMD::HMD(const char *trace_path, const bool is_realtime):
+	m_hmd(nullptr),
+	m_plugin(nullptr)
+{
+	m_hmd = new Replay(trace_path, is_realtime);
+}
+
+HMD::HMD(const char *plugin_name):
+	m_hmd(nullptr),
+	m_plugin(nullptr)
+{
+	const HMD_Plugin *plugin = PluginLoader::load(plugin_name);
+
+	if (!plugin) {
+		throw "Plugin could not be loaded";
 	}
+
+	m_hmd = plugin->create();
+
+	if (!m_hmd) {
+		throw "Plugin could not create its backend";
+	}
+	m_plugin = plugin;
 }
 
 HMD::~HMD(void)
 {
-	if (m_hmd) {
+	if (m_plugin) {
+		/* with the allocator of the plugin */
+		m_plugin->destroy(m_hmd);
+	}
+	else if (m_hmd) {
 		delete m_hmd;
 	}
 }
@@ -51,6 +108,21 @@ bool HMD::setup(const unsigned int color_texture_left, const unsigned int color_
 	return m_hmd->setup(color_texture_left, color_texture_right);
 }
 
+bool HMD::setupSideBySide(const unsigned int color_texture)
+{
+	return m_hmd->setupSideBySide(color_texture);
+}
+
+bool HMD::setSamples(const unsigned int samples)
+{
+	return m_hmd->setSamples(samples);
+}
+
+unsigned int HMD::getSamples()
+{
+	return m_hmd->getSamples();
+}
+
 bool HMD::update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
 {
 	return m_hmd->update(r_orientation_left, r_position_left, r_orientation_right, r_position_right);
@@ -79,16 +151,186 @@ bool HMD::update(const bool is_right_hand, float *r_matrix_left, float *r_matrix
 	return m_hmd->update(is_right_hand, r_matrix_left, r_matrix_right);
 }
 
+bool HMD::getFrameState(HMD_FrameState *r_state)
+{
+	return m_hmd->getFrameState(r_state);
+}
+
+bool HMD::waitFrame(HMD_FrameTiming *r_timing)
+{
+	return m_hmd->waitFrame(r_timing);
+}
+
+bool HMD::beginFrame(HMD_FrameState *r_state)
+{
+	return m_hmd->beginFrame(r_state);
+}
+
+bool HMD::endFrame(void)
+{
+	return m_hmd->endFrame();
+}
+
+bool HMD::startTracking(const float rate_hz)
+{
+	return m_hmd->startTracking(rate_hz);
+}
+
+void HMD::stopTracking()
+{
+	m_hmd->stopTracking();
+}
+
+void HMD::setPredictor(const eHMDPredictor type, const double horizon)
+{
+	m_hmd->setPredictor(type, horizon);
+}
+
+bool HMD::startRecording(const char *path)
+{
+	return m_hmd->startRecording(path);
+}
+
+void HMD::stopRecording()
+{
+	m_hmd->stopRecording();
+}
+
+bool HMD::seek(const double time)
+{
+	return m_hmd->seek(time);
+}
+
+double HMD::getTime()
+{
+	return m_hmd->getTime();
+}
+
+bool HMD::getPoseAt(const double time, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+{
+	return m_hmd->getPoseAt(time, r_orientation_left, r_position_left, r_orientation_right, r_position_right);
+}
+
+bool HMD::getYawPitchRoll(float *r_yaw_pitch_roll_left, float *r_yaw_pitch_roll_right)
+{
+	return m_hmd->getYawPitchRoll(r_yaw_pitch_roll_left, r_yaw_pitch_roll_right);
+}
+
+bool HMD::getViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+{
+	return m_hmd->getViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+}
+
+bool HMD::getInverseViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+{
+	return m_hmd->getInverseViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+}
+
 bool HMD::frameReady(void)
 {
 	return m_hmd->frameReady();
 }
 
+bool HMD::startAsyncSubmit(void)
+{
+	return m_hmd->startAsyncSubmit();
+}
+
+void HMD::stopAsyncSubmit(void)
+{
+	m_hmd->stopAsyncSubmit();
+}
+
+void HMD::getSubmitStats(HMD_SubmitStats *r_stats)
+{
+	m_hmd->getSubmitStats(r_stats);
+}
+
 bool HMD::reCenter(void)
 {
 	return m_hmd->reCenter();
 }
 
+unsigned int HMD::acquireEyeTexture(const int eye)
+{
+	return m_hmd->acquireEyeTexture(eye);
+}
+
+bool HMD::releaseEyeTexture(const int eye)
+{
+	return m_hmd->releaseEyeTexture(eye);
+}
+
+int HMD::createLayer(const HMD_LayerDesc *desc)
+{
+	return m_hmd->createLayer(desc);
+}
+
+bool HMD::destroyLayer(const int layer)
+{
+	return m_hmd->destroyLayer(layer);
+}
+
+bool HMD::setLayerPose(const int layer, const float *orientation, const float *position)
+{
+	return m_hmd->setLayerPose(layer, orientation, position);
+}
+
+bool HMD::isLayerDue(const int layer)
+{
+	return m_hmd->isLayerDue(layer);
+}
+
+unsigned int HMD::acquireLayerTexture(const int layer)
+{
+	return m_hmd->acquireLayerTexture(layer);
+}
+
+bool HMD::releaseLayerTexture(const int layer)
+{
+	return m_hmd->releaseLayerTexture(layer);
+}
+
+void HMD::getEyeViewport(const int eye, int *r_viewport)
+{
+	m_hmd->getEyeViewport(eye, r_viewport);
+}
+
+bool HMD::startDynamicResolution(const HMD_ResolutionConfig *config)
+{
+	return m_hmd->startDynamicResolution(config);
+}
+
+void HMD::stopDynamicResolution()
+{
+	m_hmd->stopDynamicResolution();
+}
+
+float HMD::getResolutionScale()
+{
+	return m_hmd->getResolutionScale();
+}
+
+void HMD::setGPUFrameTime(const double time)
+{
+	m_hmd->setGPUFrameTime(time);
+}
+
+void HMD::setFramebufferBindings(const unsigned int draw_framebuffer, const unsigned int read_framebuffer)
+{
+	m_hmd->setFramebufferBindings(draw_framebuffer, read_framebuffer);
+}
+
+unsigned int HMD::getGLCalls()
+{
+	return m_hmd->getGLCalls();
+}
+
+bool HMD::getGPUStats(HMD_GPUStats *r_stats)
+{
+	return m_hmd->getGPUStats(r_stats);
+}
+
 void HMD::getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
 {
 	return m_hmd->getProjectionMatrixLeft(nearz, farz, is_opengl, is_right_hand, r_matrix);
@@ -99,6 +341,11 @@ void HMD::getProjectionMatrixRight(const float nearz, const float farz, const bo
 	return m_hmd->getProjectionMatrixRight(nearz, farz, is_opengl, is_right_hand, r_matrix);
 }
 
+void HMD::getProjectionMatrices(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+{
+	return m_hmd->getProjectionMatrices(nearz, farz, is_opengl, is_right_hand, r_matrix_left, r_matrix_right);
+}
+
 int HMD::getWidthLeft()
 {
 	return m_hmd->getWidthLeft();
@@ -132,6 +379,46 @@ HMD *HMD_new(HMD::eHMDBackend backend)
 	return new HMD(backend);
 }
 
+HMD *HMD_newSimulated(const HMD_SimulatedConfig *config)
+{
+	return new HMD(config);
+}
+
+void HMD_simulatedConfigDefault(HMD_SimulatedConfig *r_config)
+{
+	Simulated::getDefaultConfig(r_config);
+}
+
+HMD *HMD_newReplay(const char *trace_path, const bool is_realtime)
+{
+	try {
+		return new HMD(trace_path, is_realtime);
+	}
+	catch (const char *) {
+		return nullptr;
+	}
+}
+
+HMD *HMD_newPlugin(const char *plugin_name)
+{
+	try {
+		return new HMD(plugin_name);
+	}
+	catch (const char *) {
+		return nullptr;
+	}
+}
+
+void HMD_pluginPath(const char *path)
+{
+	PluginLoader::setPath(path);
+}
+
+bool HMD_pluginShutdownIdle(const char *plugin_name)
+{
+	return PluginLoader::shutdownIdle(plugin_name);
+}
+
 void HMD_del(HMD *hmd)
 {
 	if (hmd) delete hmd;
@@ -142,21 +429,206 @@ bool HMD_setup(HMD *hmd, const unsigned int color_texture_left, const unsigned i
 	return hmd->setup(color_texture_left, color_texture_right);
 }
 
+bool HMD_setupSideBySide(HMD *hmd, const unsigned int color_texture)
+{
+	return hmd->setupSideBySide(color_texture);
+}
+
+bool HMD_samplesSet(HMD *hmd, const unsigned int samples)
+{
+	return hmd->setSamples(samples);
+}
+
+unsigned int HMD_samplesGet(HMD *hmd)
+{
+	return hmd->getSamples();
+}
+
 bool HMD_update(HMD *hmd, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
 {
 	return hmd->update(r_orientation_left, r_position_left, r_orientation_right, r_position_right);
 };
 
+bool HMD_frameState(HMD *hmd, HMD_FrameState *r_state)
+{
+	return hmd->getFrameState(r_state);
+}
+
+bool HMD_waitFrame(HMD *hmd, HMD_FrameTiming *r_timing)
+{
+	return hmd->waitFrame(r_timing);
+}
+
+bool HMD_beginFrame(HMD *hmd, HMD_FrameState *r_state)
+{
+	return hmd->beginFrame(r_state);
+}
+
+bool HMD_endFrame(HMD *hmd)
+{
+	return hmd->endFrame();
+}
+
+bool HMD_trackingStart(HMD *hmd, const float rate_hz)
+{
+	return hmd->startTracking(rate_hz);
+}
+
+void HMD_trackingStop(HMD *hmd)
+{
+	hmd->stopTracking();
+}
+
+void HMD_predictorSet(HMD *hmd, const eHMDPredictor type, const double horizon)
+{
+	hmd->setPredictor(type, horizon);
+}
+
+bool HMD_recordingStart(HMD *hmd, const char *path)
+{
+	return hmd->startRecording(path);
+}
+
+void HMD_recordingStop(HMD *hmd)
+{
+	hmd->stopRecording();
+}
+
+bool HMD_replaySeek(HMD *hmd, const double time)
+{
+	return hmd->seek(time);
+}
+
+double HMD_time(HMD *hmd)
+{
+	return hmd->getTime();
+}
+
+bool HMD_poseAt(HMD *hmd, const double time, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+{
+	return hmd->getPoseAt(time, r_orientation_left, r_position_left, r_orientation_right, r_position_right);
+}
+
+bool HMD_yawPitchRoll(HMD *hmd, float *r_yaw_pitch_roll_left, float *r_yaw_pitch_roll_right)
+{
+	return hmd->getYawPitchRoll(r_yaw_pitch_roll_left, r_yaw_pitch_roll_right);
+}
+
+bool HMD_viewMatrix(HMD *hmd, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+{
+	return hmd->getViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+}
+
+bool HMD_inverseViewMatrix(HMD *hmd, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+{
+	return hmd->getInverseViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+}
+
 bool HMD_frameReady(HMD *hmd)
 {
 	return hmd->frameReady();
 }
 
+bool HMD_submitStart(HMD *hmd)
+{
+	return hmd->startAsyncSubmit();
+}
+
+void HMD_submitStop(HMD *hmd)
+{
+	hmd->stopAsyncSubmit();
+}
+
+void HMD_submitStats(HMD *hmd, HMD_SubmitStats *r_stats)
+{
+	hmd->getSubmitStats(r_stats);
+}
+
 bool HMD_reCenter(HMD *hmd)
 {
 	return hmd->reCenter();
 }
 
+unsigned int HMD_acquireEyeTexture(HMD *hmd, const int eye)
+{
+	return hmd->acquireEyeTexture(eye);
+}
+
+bool HMD_releaseEyeTexture(HMD *hmd, const int eye)
+{
+	return hmd->releaseEyeTexture(eye);
+}
+
+void HMD_eyeViewport(HMD *hmd, const int eye, int *r_viewport)
+{
+	hmd->getEyeViewport(eye, r_viewport);
+}
+
+bool HMD_resolutionStart(HMD *hmd, const HMD_ResolutionConfig *config)
+{
+	return hmd->startDynamicResolution(config);
+}
+
+void HMD_resolutionStop(HMD *hmd)
+{
+	hmd->stopDynamicResolution();
+}
+
+float HMD_resolutionScale(HMD *hmd)
+{
+	return hmd->getResolutionScale();
+}
+
+void HMD_resolutionGPUTime(HMD *hmd, const double time)
+{
+	hmd->setGPUFrameTime(time);
+}
+
+int HMD_layerCreate(HMD *hmd, const HMD_LayerDesc *desc)
+{
+	return hmd->createLayer(desc);
+}
+
+bool HMD_layerDestroy(HMD *hmd, const int layer)
+{
+	return hmd->destroyLayer(layer);
+}
+
+bool HMD_layerPose(HMD *hmd, const int layer, const float *orientation, const float *position)
+{
+	return hmd->setLayerPose(layer, orientation, position);
+}
+
+bool HMD_layerDue(HMD *hmd, const int layer)
+{
+	return hmd->isLayerDue(layer);
+}
+
+unsigned int HMD_layerAcquireTexture(HMD *hmd, const int layer)
+{
+	return hmd->acquireLayerTexture(layer);
+}
+
+bool HMD_layerReleaseTexture(HMD *hmd, const int layer)
+{
+	return hmd->releaseLayerTexture(layer);
+}
+
+void HMD_framebufferBindings(HMD *hmd, const unsigned int draw_framebuffer, const unsigned int read_framebuffer)
+{
+	hmd->setFramebufferBindings(draw_framebuffer, read_framebuffer);
+}
+
+unsigned int HMD_glCalls(HMD *hmd)
+{
+	return hmd->getGLCalls();
+}
+
+bool HMD_gpuStats(HMD *hmd, HMD_GPUStats *r_stats)
+{
+	return hmd->getGPUStats(r_stats);
+}
+
 unsigned int HMD_widthLeft(HMD *hmd)
 {
 	return hmd->getWidthLeft();
@@ -187,6 +659,11 @@ void HMD_projectionMatrixRight(HMD *hmd, const float nearz, const float farz, fl
 	hmd->getProjectionMatrixRight(nearz, farz, true, true, r_matrix);
 }
 
+void HMD_projectionMatrices(HMD *hmd, const float nearz, const float farz, float *r_matrix_left, float *r_matrix_right)
+{
+	hmd->getProjectionMatrices(nearz, farz, true, true, r_matrix_left, r_matrix_right);
+}
+
 float HMD_scaleGet(HMD *hmd)
 {
 	return hmd->getScale();
@@ -197,13 +674,37 @@ void HMD_scaleSet(HMD *hmd, const float scale)
 	hmd->setScale(scale);
 }
 
+void HMD_logSink(HMD_LogSink sink, void *user_data)
+{
+	Log::setSink(sink, user_data);
+}
+
+void HMD_logLevel(const int level)
+{
+	Log::setLevel(level);
+}
+
+void HMD_logFlush(void)
+{
+	Log::flush();
+}
+
+unsigned long long HMD_logDropped(void)
+{
+	return Log::getDropped();
+}
+
+void HMD_logShutdown(void)
+{
+	Log::shutdown();
+}
+
 /* Legacy C API */
 
-#include <iostream>
 /* Oculus wrapper - kept for backward compatibility */
 HMD *Oculus_new()
 {
-	std::cout << "HMD SDK Bridge Legacy API is deprecated, please contact your software developer." << std::endl;
+	BRIDGE_LOG_WARNING("HMD SDK Bridge Legacy API is deprecated, please contact your software developer.");
 	return new HMD(HMD::eHMDBackend::BACKEND_OCULUS);
 }
 
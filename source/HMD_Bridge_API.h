@@ -17,6 +17,160 @@
 #endif
 #endif
 
+
+/* Frame State */
+
+/* tracking status of the sampled pose */
+enum eHMDStatus
+{
+	HMD_STATUS_ORIENTATION_TRACKED = (1 << 0),
+	HMD_STATUS_POSITION_TRACKED = (1 << 1),
+};
+
+/* representations to fill in HMD_frameState */
+enum eHMDFrameFlag
+{
+	HMD_FRAME_ORIENTATION = (1 << 0),
+	HMD_FRAME_YAW_PITCH_ROLL = (1 << 1),
+	HMD_FRAME_POSITION = (1 << 2),
+	HMD_FRAME_VIEW_MATRIX = (1 << 3),
+	HMD_FRAME_LEFT_HANDED = (1 << 4), /* view matrix is right handed by default */
+	HMD_FRAME_INVERSE_VIEW_MATRIX = (1 << 5),
+};
+
+/* bridge-side pose prediction models */
+enum eHMDPredictor
+{
+	HMD_PREDICTOR_NONE = 0,
+	HMD_PREDICTOR_CONSTANT_VELOCITY,
+	HMD_PREDICTOR_CONSTANT_ACCELERATION,
+	HMD_PREDICTOR_ANGULAR_VELOCITY,
+};
+
+/* all the representations of a single tracking sample, [0] is left and [1] is right eye */
+typedef struct HMD_FrameState
+{
+	unsigned int flags; /* eHMDFrameFlag, set by the caller */
+	unsigned int frame;
+	double display_time;
+	unsigned int status; /* eHMDStatus */
+
+	float orientation[2][4]; /* w, x, y, z */
+	float yaw_pitch_roll[2][3];
+	float position[2][3];
+	float view_matrix[2][16]; /* column-major */
+	float inverse_view_matrix[2][16]; /* column-major */
+} HMD_FrameState;
+
+/* the frame to start, from HMD_waitFrame, times in seconds */
+typedef struct HMD_FrameTiming
+{
+	unsigned int frame; /* the one HMD_beginFrame starts */
+	int should_render; /* 0 when the frame is not displayed (e.g. headset off), begin and end it anyway */
+	double predicted_display_time;
+	double period; /* between two displayed frames, 0 if unknown */
+} HMD_FrameTiming;
+
+/* frame pacing of HMD_frameReady, times in seconds */
+typedef struct HMD_SubmitStats
+{
+	unsigned int frames; /* submitted to the device */
+	unsigned int stalls; /* frameReady waited for the previous frame to be submitted */
+	double wait_time; /* last time frameReady blocked the caller */
+	double submit_time; /* last duration of the submission */
+	double submit_time_average;
+	double submit_interval; /* between the last two submissions */
+} HMD_SubmitStats;
+
+/* GPU time of the GL work of the bridge, in seconds */
+typedef struct HMD_GPUTiming
+{
+	double last;
+	double average;
+	double p99; /* 99th percentile */
+} HMD_GPUTiming;
+
+typedef struct HMD_GPUStats
+{
+	unsigned int frames; /* timed, read back a few frames late */
+	unsigned int dropped; /* not read back in time */
+	HMD_GPUTiming eye[2]; /* copy of each eye, or of the side by side atlas in eye[0] */
+	HMD_GPUTiming submit; /* all of frameReady */
+} HMD_GPUStats;
+
+/* Dynamic resolution: the eye textures are allocated at the highest pixel density, and the
+ * viewports shrink when the frames take too long. Densities are relative to the one recommended
+ * by the device (1.0) */
+typedef struct HMD_ResolutionConfig
+{
+	float min_scale;
+	float max_scale; /* of the allocated textures, above 1.0 for supersampling */
+	float utilization; /* share of the frame time a frame may take, 0.9 if 0 */
+	double target_frame_time; /* in seconds, 0 for the refresh period of the device */
+} HMD_ResolutionConfig;
+
+/* Compositor layers, on top of the eye layer */
+
+enum eHMDLayerType
+{
+	HMD_LAYER_QUAD = 0, /* textured rectangle in space, for HUD and UI */
+	HMD_LAYER_STATIC, /* quad whose texture is rendered once */
+};
+
+typedef struct HMD_LayerDesc
+{
+	unsigned int type; /* eHMDLayerType */
+	unsigned int width; /* of the texture, in pixels */
+	unsigned int height;
+	float size[2]; /* of the quad, in the units of the poses (see HMD_scaleSet) */
+	float orientation[4]; /* w, x, y, z, the quad faces its +z axis */
+	float position[3];
+	int is_head_locked; /* the pose is relative to the head, otherwise to the tracking origin */
+	float update_rate; /* texture updates per second, 0 for every frame */
+} HMD_LayerDesc;
+
+/* Simulated device */
+
+/* scripted head motion of the simulated backend */
+enum eHMDMotion
+{
+	HMD_MOTION_STILL = 0,
+	HMD_MOTION_LOOK_AROUND, /* standing, looking left and right, up and down */
+	HMD_MOTION_WALK, /* walking in a circle, looking ahead */
+};
+
+/* see HMD_simulatedConfigDefault for the default values */
+typedef struct HMD_SimulatedConfig
+{
+	unsigned int motion; /* eHMDMotion */
+	unsigned int seed; /* of the sensor noise */
+	float orientation_noise; /* standard deviation, in radians */
+	float position_noise; /* standard deviation, in meters */
+
+	float sensor_rate; /* tracking samples per second */
+	float refresh_rate; /* virtual vsync, per second */
+	int is_realtime; /* frameReady waits for the vsync, otherwise the clock jumps to it */
+
+	unsigned int width[2];
+	unsigned int height[2];
+	float fov[2][4]; /* tangents of the up, down, left and right half angles */
+	float ipd; /* in meters */
+} HMD_SimulatedConfig;
+
+/* Log */
+
+enum eHMDLogLevel
+{
+	HMD_LOG_DEBUG = 0,
+	HMD_LOG_INFO,
+	HMD_LOG_WARNING,
+	HMD_LOG_ERROR,
+	HMD_LOG_NONE, /* for HMD_logLevel, no message at all */
+};
+
+/* called by the log thread of the bridge, one message at a time, without the line break */
+typedef void (*HMD_LogSink)(const int level, const char *message, void *user_data);
+
 #ifdef __cplusplus
 
 /* C++ API */
@@ -32,6 +186,8 @@
 
 /* Forward declarations */
 class Backend;
+class HMDStatic;
+struct HMD_Plugin;
 
 /* Interface */
 class DllExport HMD
@@ -46,16 +202,39 @@ public:
 		BACKEND_OSVR,
 		BACKEND_OPENVR,
 		BACKEND_OPENHMD,
+		BACKEND_SIMULATED,
+		BACKEND_REPLAY, /* needs a trace, see HMD(path, is_realtime) */
 	};
 
 	HMD();
 
+	/* the devices other than the simulated one are plugins, loaded the first time they are requested,
+	 * a device without its plugin is a stub */
 	HMD(eHMDBackend backend);
 
+	/* simulated device with a custom configuration */
+	HMD(const HMD_SimulatedConfig *config);
+
+	/* play back a trace recorded with startRecording, throws if it can't be opened */
+	HMD(const char *trace_path, const bool is_realtime);
+
+	/* backend of the plugin named plugin_name, see PluginLoader.h, throws if it can't be loaded */
+	HMD(const char *plugin_name);
+
 	~HMD(void);
 
 	bool setup(const unsigned int color_texture_left, const unsigned int color_texture_right);
 
+	/* both eyes side by side in one texture, or in the device atlas when color_texture is 0 */
+	bool setupSideBySide(const unsigned int color_texture);
+
+	/* multisampled eyes, before setup. In copy mode the color textures are multisampled
+	 * (GL_TEXTURE_2D_MULTISAMPLE, GL_SRGB8_ALPHA8), in direct mode acquireEyeTexture returns
+	 * multisampled textures of the bridge. Either way frameReady resolves them in its copy */
+	bool setSamples(const unsigned int samples);
+
+	unsigned int getSamples(void);
+
 	bool update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right);
 
 	bool update(
@@ -68,14 +247,106 @@ public:
 
 	bool update(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
 
+	bool getFrameState(HMD_FrameState *r_state);
+
+	/* frame loop: wait until it is time to start the next frame, latch its poses, submit it */
+	bool waitFrame(HMD_FrameTiming *r_timing);
+
+	bool beginFrame(HMD_FrameState *r_state);
+
+	bool endFrame(void);
+
+	/* sample the tracking in a background thread */
+	bool startTracking(const float rate_hz);
+
+	void stopTracking();
+
+	/* predict the poses horizon seconds ahead of the newest sample */
+	void setPredictor(const eHMDPredictor type, const double horizon);
+
+	/* record the tracking samples to a trace file */
+	bool startRecording(const char *path);
+
+	void stopRecording();
+
+	/* recorded sessions only, continue from the first sample at or after time */
+	bool seek(const double time);
+
+	/* poses from the history of tracked samples */
+	double getTime();
+
+	bool getPoseAt(const double time, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right);
+
+	/* current frame representations, computed on demand */
+	bool getYawPitchRoll(float *r_yaw_pitch_roll_left, float *r_yaw_pitch_roll_right);
+
+	bool getViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
+
+	bool getInverseViewMatrix(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
+
 	bool frameReady(void);
 
+	/* submit the frames from a background thread, frameReady only hands them over.
+	 * GL backends share the objects of the current context with a context of their own */
+	bool startAsyncSubmit(void);
+
+	void stopAsyncSubmit(void);
+
+	void getSubmitStats(HMD_SubmitStats *r_stats);
+
 	bool reCenter(void);
 
+	/* direct rendering, after setup(0, 0): render the eye into the device texture of the current frame */
+	unsigned int acquireEyeTexture(const int eye);
+
+	bool releaseEyeTexture(const int eye);
+
+	/* compositor layers, drawn over the eyes in the order of their ids. Return the layer id, or -1 */
+	int createLayer(const HMD_LayerDesc *desc);
+
+	bool destroyLayer(const int layer);
+
+	bool setLayerPose(const int layer, const float *orientation, const float *position);
+
+	/* the update rate asks for a new texture */
+	bool isLayerDue(const int layer);
+
+	/* texture to render the layer into, 0 for a static layer already rendered */
+	unsigned int acquireLayerTexture(const int layer);
+
+	bool releaseLayerTexture(const int layer);
+
+	/* x, y, width, height of the eye in its texture, it changes with the dynamic resolution */
+	void getEyeViewport(const int eye, int *r_viewport);
+
+	/* dynamic resolution, before setup: the eye sizes become the ones of the highest density */
+	bool startDynamicResolution(const HMD_ResolutionConfig *config);
+
+	/* back to the whole eye textures */
+	void stopDynamicResolution(void);
+
+	/* current pixel density */
+	float getResolutionScale(void);
+
+	/* GPU time of the frame, in seconds, taken into account by the next frameReady with the CPU time */
+	void setGPUFrameTime(const double time);
+
+	/* framebuffers bound when calling setup and frameReady, so they are not queried every frame */
+	void setFramebufferBindings(const unsigned int draw_framebuffer, const unsigned int read_framebuffer);
+
+	/* GL calls the bridge made during the last frame */
+	unsigned int getGLCalls(void);
+
+	/* GPU time of the bridge, false if the backend has no timer queries */
+	bool getGPUStats(HMD_GPUStats *r_stats);
+
 	void getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
 
 	void getProjectionMatrixRight(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
 
+	/* both eyes at once */
+	void getProjectionMatrices(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
+
 	/* generic */
 	int getWidthLeft();
 	int getHeightLeft();
@@ -86,6 +357,7 @@ public:
 
 protected:
 	Backend *m_hmd;
+	const HMD_Plugin *m_plugin; /* that created m_hmd, if any */
 };
 
 #endif /* __cplusplus */
@@ -105,19 +377,68 @@ EXPORT_LIB void Debug_draw(const unsigned int color_texture) { Debug::draw(color
 #endif
 
 EXPORT_LIB HMD *HMD_new(HMD::eHMDBackend backend);
+EXPORT_LIB HMD *HMD_newSimulated(const HMD_SimulatedConfig *config);
+EXPORT_LIB void HMD_simulatedConfigDefault(HMD_SimulatedConfig *r_config);
+EXPORT_LIB HMD *HMD_newReplay(const char *trace_path, const bool is_realtime);
+EXPORT_LIB HMD *HMD_newPlugin(const char *plugin_name);
+EXPORT_LIB void HMD_pluginPath(const char *path);
+EXPORT_LIB bool HMD_pluginShutdownIdle(const char *plugin_name);
 EXPORT_LIB void HMD_del(HMD *hmd);
 EXPORT_LIB bool HMD_setup(HMD *hmd, const unsigned int color_texture_left, const unsigned int color_texture_right);
+EXPORT_LIB bool HMD_setupSideBySide(HMD *hmd, const unsigned int color_texture);
+EXPORT_LIB bool HMD_samplesSet(HMD *hmd, const unsigned int samples);
+EXPORT_LIB unsigned int HMD_samplesGet(HMD *hmd);
 EXPORT_LIB bool HMD_update(HMD *hmd, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right);
+EXPORT_LIB bool HMD_frameState(HMD *hmd, HMD_FrameState *r_state);
+EXPORT_LIB bool HMD_waitFrame(HMD *hmd, HMD_FrameTiming *r_timing);
+EXPORT_LIB bool HMD_beginFrame(HMD *hmd, HMD_FrameState *r_state);
+EXPORT_LIB bool HMD_endFrame(HMD *hmd);
+EXPORT_LIB bool HMD_trackingStart(HMD *hmd, const float rate_hz);
+EXPORT_LIB void HMD_trackingStop(HMD *hmd);
+EXPORT_LIB void HMD_predictorSet(HMD *hmd, const eHMDPredictor type, const double horizon);
+EXPORT_LIB bool HMD_recordingStart(HMD *hmd, const char *path);
+EXPORT_LIB void HMD_recordingStop(HMD *hmd);
+EXPORT_LIB bool HMD_replaySeek(HMD *hmd, const double time);
+EXPORT_LIB double HMD_time(HMD *hmd);
+EXPORT_LIB bool HMD_poseAt(HMD *hmd, const double time, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right);
+EXPORT_LIB bool HMD_yawPitchRoll(HMD *hmd, float *r_yaw_pitch_roll_left, float *r_yaw_pitch_roll_right);
+EXPORT_LIB bool HMD_viewMatrix(HMD *hmd, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
+EXPORT_LIB bool HMD_inverseViewMatrix(HMD *hmd, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
 EXPORT_LIB bool HMD_frameReady(HMD *hmd);
+EXPORT_LIB bool HMD_submitStart(HMD *hmd);
+EXPORT_LIB void HMD_submitStop(HMD *hmd);
+EXPORT_LIB void HMD_submitStats(HMD *hmd, HMD_SubmitStats *r_stats);
 EXPORT_LIB bool HMD_reCenter(HMD *hmd);
+EXPORT_LIB unsigned int HMD_acquireEyeTexture(HMD *hmd, const int eye);
+EXPORT_LIB bool HMD_releaseEyeTexture(HMD *hmd, const int eye);
+EXPORT_LIB void HMD_eyeViewport(HMD *hmd, const int eye, int *r_viewport);
+EXPORT_LIB bool HMD_resolutionStart(HMD *hmd, const HMD_ResolutionConfig *config);
+EXPORT_LIB void HMD_resolutionStop(HMD *hmd);
+EXPORT_LIB float HMD_resolutionScale(HMD *hmd);
+EXPORT_LIB void HMD_resolutionGPUTime(HMD *hmd, const double time);
+EXPORT_LIB int HMD_layerCreate(HMD *hmd, const HMD_LayerDesc *desc);
+EXPORT_LIB bool HMD_layerDestroy(HMD *hmd, const int layer);
+EXPORT_LIB bool HMD_layerPose(HMD *hmd, const int layer, const float *orientation, const float *position);
+EXPORT_LIB bool HMD_layerDue(HMD *hmd, const int layer);
+EXPORT_LIB unsigned int HMD_layerAcquireTexture(HMD *hmd, const int layer);
+EXPORT_LIB bool HMD_layerReleaseTexture(HMD *hmd, const int layer);
+EXPORT_LIB void HMD_framebufferBindings(HMD *hmd, const unsigned int draw_framebuffer, const unsigned int read_framebuffer);
+EXPORT_LIB unsigned int HMD_glCalls(HMD *hmd);
+EXPORT_LIB bool HMD_gpuStats(HMD *hmd, HMD_GPUStats *r_stats);
 EXPORT_LIB unsigned int HMD_widthLeft(HMD *hmd);
 EXPORT_LIB unsigned int HMD_heightLeft(HMD *hmd);
 EXPORT_LIB unsigned int HMD_widthRight(HMD *hmd);
 EXPORT_LIB unsigned int HMD_heightRight(HMD *hmd);
 EXPORT_LIB void HMD_projectionMatrixLeft(HMD *hmd, const float nearz, const float farz, float *r_matrix);
 EXPORT_LIB void HMD_projectionMatrixRight(HMD *hmd, const float nearz, const float farz, float *r_matrix);
+EXPORT_LIB void HMD_projectionMatrices(HMD *hmd, const float nearz, const float farz, float *r_matrix_left, float *r_matrix_right);
 EXPORT_LIB float HMD_scaleGet(HMD *hmd);
 EXPORT_LIB void HMD_scaleSet(HMD *hmd, const float scale);
+EXPORT_LIB void HMD_logSink(HMD_LogSink sink, void *user_data);
+EXPORT_LIB void HMD_logLevel(const int level);
+EXPORT_LIB void HMD_logFlush(void);
+EXPORT_LIB unsigned long long HMD_logDropped(void);
+EXPORT_LIB void HMD_logShutdown(void);
 
 #ifdef OCULUS
 /* Oculus wrapper - kept for backward compatibility */
@@ -137,6 +458,22 @@ EXPORT_LIB float Oculus_scaleGet(HMD *hmd);
 EXPORT_LIB void Oculus_scaleSet(HMD *hmd, const float scale);
 #endif
 
+#ifdef STATIC_BACKEND
+/* backend bound at compile time (STATIC_BACKEND in CMake), the frame routines without dispatch */
+EXPORT_LIB HMDStatic *HMDStatic_new();
+EXPORT_LIB void HMDStatic_del(HMDStatic *hmd);
+EXPORT_LIB bool HMDStatic_setup(HMDStatic *hmd, const unsigned int color_texture_left, const unsigned int color_texture_right);
+EXPORT_LIB bool HMDStatic_frameState(HMDStatic *hmd, HMD_FrameState *r_state);
+EXPORT_LIB bool HMDStatic_update(HMDStatic *hmd, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right);
+EXPORT_LIB bool HMDStatic_viewMatrix(HMDStatic *hmd, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
+EXPORT_LIB void HMDStatic_projectionMatrices(HMDStatic *hmd, const float nearz, const float farz, float *r_matrix_left, float *r_matrix_right);
+EXPORT_LIB bool HMDStatic_frameReady(HMDStatic *hmd);
+EXPORT_LIB unsigned int HMDStatic_widthLeft(HMDStatic *hmd);
+EXPORT_LIB unsigned int HMDStatic_heightLeft(HMDStatic *hmd);
+EXPORT_LIB unsigned int HMDStatic_widthRight(HMDStatic *hmd);
+EXPORT_LIB unsigned int HMDStatic_heightRight(HMDStatic *hmd);
+#endif
+
 #undef EXPORT_LIB
 
 #endif /* __HMD_BRIDGE_API_H__ */
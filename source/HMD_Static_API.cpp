@@ -0,0 +1,88 @@
+#include "HMD_Bridge_API.h"
+
+#include "HMDT.h"
+
+/* C API of the backend bound at compile time, see STATIC_BACKEND */
+
+#if defined STATIC_BACKEND_SIMULATED
+
+#include "Simulated.h"
+
+static HMD_SimulatedConfig getSimulatedConfig()
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+	return config;
+}
+
+class HMDStatic : public HMDT<SimulatedImpl>
+{
+public:
+	HMDStatic() :
+		HMDT<SimulatedImpl>(getSimulatedConfig())
+	{}
+};
+
+#else
+#error "STATIC_BACKEND has no implementation bound"
+#endif
+
+HMDStatic *HMDStatic_new()
+{
+	return new HMDStatic();
+}
+
+void HMDStatic_del(HMDStatic *hmd)
+{
+	if (hmd) delete hmd;
+}
+
+bool HMDStatic_setup(HMDStatic *hmd, const unsigned int color_texture_left, const unsigned int color_texture_right)
+{
+	return hmd->setup(color_texture_left, color_texture_right);
+}
+
+bool HMDStatic_frameState(HMDStatic *hmd, HMD_FrameState *r_state)
+{
+	return hmd->getFrameState(r_state);
+}
+
+bool HMDStatic_update(HMDStatic *hmd, float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+{
+	return hmd->update(r_orientation_left, r_position_left, r_orientation_right, r_position_right);
+}
+
+bool HMDStatic_viewMatrix(HMDStatic *hmd, const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+{
+	return hmd->getViewMatrix(is_right_hand, r_matrix_left, r_matrix_right);
+}
+
+void HMDStatic_projectionMatrices(HMDStatic *hmd, const float nearz, const float farz, float *r_matrix_left, float *r_matrix_right)
+{
+	hmd->getProjectionMatrices(nearz, farz, true, true, r_matrix_left, r_matrix_right);
+}
+
+bool HMDStatic_frameReady(HMDStatic *hmd)
+{
+	return hmd->frameReady();
+}
+
+unsigned int HMDStatic_widthLeft(HMDStatic *hmd)
+{
+	return hmd->getWidthLeft();
+}
+
+unsigned int HMDStatic_heightLeft(HMDStatic *hmd)
+{
+	return hmd->getHeightLeft();
+}
+
+unsigned int HMDStatic_widthRight(HMDStatic *hmd)
+{
+	return hmd->getWidthRight();
+}
+
+unsigned int HMDStatic_heightRight(HMDStatic *hmd)
+{
+	return hmd->getHeightRight();
+}
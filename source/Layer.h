@@ -0,0 +1,37 @@
+#ifndef __LAYER_H__
+#define __LAYER_H__
+
+#include "HMD_Bridge_API.h"
+
+/* compositor layer, the pose in meters */
+struct Layer
+{
+	bool is_used;
+	HMD_LayerDesc desc;
+
+	bool is_acquired;
+	bool is_committed; /* has a texture to display */
+	double update_time; /* of the last commit */
+	unsigned int image; /* swap chain texture displayed, for backends keeping track of it */
+
+	/* the update rate asks for a new texture at the given time */
+	bool isDue(const double time) const
+	{
+		if (!this->is_committed) {
+			return true;
+		}
+
+		if (this->desc.type == HMD_LAYER_STATIC) {
+			return false;
+		}
+
+		if (this->desc.update_rate <= 0.0f) {
+			return true;
+		}
+
+		/* a little early rather than a whole display period late */
+		return (time - this->update_time) >= (1.0 / this->desc.update_rate) - 1e-4;
+	}
+};
+
+#endif /* __LAYER_H__ */
@@ -0,0 +1,284 @@
+#include "Log.h"
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <stdarg.h>
+#include <stdio.h>
+#include <thread>
+
+namespace {
+
+struct LogMessage
+{
+	int level;
+	char text[Log::MESSAGE_SIZE];
+};
+
+struct LogState
+{
+	LogState() :
+		level(HMD_LOG_DEBUG),
+		queued(0),
+		delivered(0),
+		dropped(0),
+		dropped_reported(0),
+		sink(nullptr),
+		user_data(nullptr),
+		is_running(true),
+		is_stopped(false),
+		is_woken(false)
+	{}
+
+	MpscQueue<LogMessage, Log::QUEUE_SIZE> queue;
+	std::atomic<int> level;
+
+	std::atomic<unsigned long long> queued;
+	std::atomic<unsigned long long> delivered;
+	std::atomic<unsigned long long> dropped;
+	unsigned long long dropped_reported; /* under drain_mutex */
+
+	/* the queue has a single consumer: the log thread, or once it is stopped the threads logging */
+	std::mutex drain_mutex;
+
+	std::mutex sink_mutex; /* held while the sink is called, never by write() */
+	HMD_LogSink sink;
+	void *user_data;
+
+	std::once_flag is_started;
+	std::thread thread;
+	std::atomic<bool> is_running;
+	std::atomic<bool> is_stopped; /* the log thread is gone, write() drains the queue itself */
+
+	/* to wake the log thread while it is idle, never by write() */
+	std::mutex wake_mutex;
+	std::condition_variable wake_condition;
+	bool is_woken;
+};
+
+thread_local bool t_is_log_thread = false;
+thread_local bool t_is_delivering = false; /* in the sink, the drain in progress takes what it logs */
+
+/* never destroyed, the plugins and the static destructors of the application may log until the end.
+ * In static storage rather than on the heap, operator new ignores the alignment of the queue
+ * before C++17 */
+LogState &getState()
+{
+	alignas(LogState) static unsigned char storage[sizeof(LogState)];
+	static LogState *state = new (storage) LogState();
+	return *state;
+}
+
+void deliver(LogState *state, const int level, const char *text)
+{
+	std::lock_guard<std::mutex> lock(state->sink_mutex);
+	t_is_delivering = true;
+
+	if (state->sink) {
+		state->sink(level, text, state->user_data);
+	}
+	else {
+		fputs(text, stdout);
+		fputc('\n', stdout);
+		fflush(stdout);
+	}
+
+	t_is_delivering = false;
+}
+
+/* move the queued messages to the sink, return the number of messages delivered */
+unsigned int drain(LogState *state)
+{
+	std::lock_guard<std::mutex> lock(state->drain_mutex);
+	LogMessage message;
+	unsigned int delivered = 0;
+
+	while (state->queue.pop(&message)) {
+		deliver(state, message.level, message.text);
+		state->delivered++;
+		delivered++;
+	}
+
+	const unsigned long long dropped = state->dropped;
+
+	if (dropped != state->dropped_reported) {
+		char text[64];
+		snprintf(text, sizeof(text), "%llu log messages dropped", dropped - state->dropped_reported);
+		state->dropped_reported = dropped;
+		deliver(state, HMD_LOG_WARNING, text);
+	}
+
+	return delivered;
+}
+
+/* deliver what is queued without waiting for the log thread to look again */
+void wake(LogState *state)
+{
+	std::lock_guard<std::mutex> lock(state->wake_mutex);
+	state->is_woken = true;
+	state->wake_condition.notify_one();
+}
+
+void logLoop(LogState *state)
+{
+	t_is_log_thread = true;
+
+	/* write() doesn't wake the thread, it looks less often the longer the queue stays empty */
+	const std::chrono::milliseconds idle_min(1), idle_max(64);
+	std::chrono::milliseconds idle = idle_min;
+
+	while (state->is_running) {
+		if (drain(state) != 0) {
+			idle = idle_min;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(state->wake_mutex);
+		state->wake_condition.wait_for(lock, idle, [state]() { return state->is_woken; });
+		state->is_woken = false;
+		idle = std::min(idle * 2, idle_max);
+	}
+
+	/* what was queued before stopping */
+	while (drain(state) != 0) {
+	}
+}
+
+/* write() calls the sink itself from now on, the log thread delivers what was queued and exits */
+void stop(LogState *state, const bool is_joined)
+{
+	if (state->is_stopped.exchange(true)) {
+		return;
+	}
+
+	state->is_running = false;
+	wake(state);
+
+	if (state->thread.joinable()) {
+		if (is_joined) {
+			state->thread.join();
+		}
+		else {
+			state->thread.detach();
+		}
+	}
+
+	/* what was pushed after the last drain of the thread, or while it still runs detached */
+	drain(state);
+}
+
+/* stop the log thread once the library is unloaded, with what was logged by then */
+struct LogShutdown
+{
+	~LogShutdown()
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		/* under the loader lock, that the thread needs to exit: a join would never return. At the
+		 * end of the process the thread is gone already, before a FreeLibrary Log::shutdown stops it */
+		stop(&getState(), false);
+#else
+		stop(&getState(), true);
+#endif
+	}
+} s_shutdown;
+
+} /* namespace */
+
+void Log::write(const int level, const char *format, ...)
+{
+	LogState &state = getState();
+
+	if (level < state.level.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	LogMessage message;
+	message.level = level;
+
+	va_list arguments;
+	va_start(arguments, format);
+	vsnprintf(message.text, sizeof(message.text), format, arguments);
+	va_end(arguments);
+
+	if (!state.is_stopped) {
+		std::call_once(state.is_started, [&state]() {
+			state.thread = std::thread(logLoop, &state);
+		});
+	}
+
+	if (state.queue.push(message)) {
+		state.queued++;
+	}
+	else {
+		state.dropped++;
+	}
+
+	/* stopped, or stopping since the check above: the log thread may have drained the queue for
+	 * the last time already. The fence orders the push before the load, as the exchange in stop() */
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (state.is_stopped && !t_is_delivering) {
+		drain(&state);
+	}
+}
+
+void Log::setLevel(const int level)
+{
+	getState().level = level;
+}
+
+int Log::getLevel()
+{
+	return getState().level;
+}
+
+void Log::setSink(HMD_LogSink sink, void *user_data)
+{
+	LogState &state = getState();
+	Log::flush();
+
+	std::lock_guard<std::mutex> lock(state.sink_mutex);
+	state.sink = sink;
+	state.user_data = user_data;
+}
+
+void Log::flush()
+{
+	LogState &state = getState();
+	const unsigned long long queued = state.queued;
+
+	/* from the sink, the message being delivered would never be */
+	if (t_is_log_thread || t_is_delivering) {
+		return;
+	}
+
+	wake(&state);
+
+	while (state.delivered < queued) {
+		/* once the drain in progress, if any, is over */
+		if (state.is_stopped) {
+			drain(&state);
+			return;
+		}
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+}
+
+void Log::shutdown()
+{
+	/* from the sink, the thread would join itself */
+	if (t_is_log_thread) {
+		return;
+	}
+
+	stop(&getState(), true);
+}
+
+unsigned long long Log::getDropped()
+{
+	return getState().dropped;
+}
@@ -0,0 +1,87 @@
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#include "HMD_Bridge_API.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#if !defined(DllExport)
+#define DllExport   __declspec( dllexport )
+#endif
+
+#else
+#define DllExport
+#endif
+
+/* lowest eHMDLogLevel compiled in, as a number (LOG_LEVEL in CMake): the calls of the levels
+ * below it are removed by the preprocessor, arguments included */
+#if !defined(BRIDGE_LOG_LEVEL)
+#if defined(NDEBUG)
+#define BRIDGE_LOG_LEVEL 1 /* HMD_LOG_INFO */
+#else
+#define BRIDGE_LOG_LEVEL 0 /* HMD_LOG_DEBUG */
+#endif
+#endif
+
+#if BRIDGE_LOG_LEVEL <= 0
+#define BRIDGE_LOG_DEBUG(...) Log::write(HMD_LOG_DEBUG, __VA_ARGS__)
+#else
+#define BRIDGE_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if BRIDGE_LOG_LEVEL <= 1
+#define BRIDGE_LOG_INFO(...) Log::write(HMD_LOG_INFO, __VA_ARGS__)
+#else
+#define BRIDGE_LOG_INFO(...) ((void)0)
+#endif
+
+#if BRIDGE_LOG_LEVEL <= 2
+#define BRIDGE_LOG_WARNING(...) Log::write(HMD_LOG_WARNING, __VA_ARGS__)
+#else
+#define BRIDGE_LOG_WARNING(...) ((void)0)
+#endif
+
+#if BRIDGE_LOG_LEVEL <= 3
+#define BRIDGE_LOG_ERROR(...) Log::write(HMD_LOG_ERROR, __VA_ARGS__)
+#else
+#define BRIDGE_LOG_ERROR(...) ((void)0)
+#endif
+
+#if defined(__GNUC__)
+#define BRIDGE_LOG_PRINTF(format_index, first_argument) __attribute__((format(printf, format_index, first_argument)))
+#else
+#define BRIDGE_LOG_PRINTF(format_index, first_argument)
+#endif
+
+/* Log of the bridge, and of its plugins.
+ *
+ * write() formats the message on the stack and queues it, without a lock, an allocation or any
+ * I/O: the sink (HMD_logSink, the standard output by default) is called by a background thread,
+ * in the order of the queue. A message that doesn't fit in the queue is dropped and counted, one
+ * longer than MESSAGE_SIZE is cut */
+class DllExport Log
+{
+public:
+	enum { MESSAGE_SIZE = 256, QUEUE_SIZE = 256 };
+
+	static void write(const int level, const char *format, ...) BRIDGE_LOG_PRINTF(2, 3);
+
+	/* messages of a lower level are ignored, HMD_LOG_NONE ignores all of them */
+	static void setLevel(const int level);
+	static int getLevel();
+
+	/* nullptr for the standard output. The messages logged before go to the previous sink */
+	static void setSink(HMD_LogSink sink, void *user_data);
+
+	/* wait until the messages logged so far are in the sink */
+	static void flush();
+
+	static unsigned long long getDropped();
+
+	/* stop the log thread, once what was logged is in the sink: write() calls the sink itself from
+	 * then on. Required on Windows before unloading the bridge with FreeLibrary, the thread can't
+	 * be joined at that point */
+	static void shutdown();
+};
+
+#endif /* __LOG_H__ */
@@ -0,0 +1,88 @@
+#ifndef __MPSC_QUEUE_H__
+#define __MPSC_QUEUE_H__
+
+#include <atomic>
+
+/* Multiple-producer, single-consumer bounded queue.
+ * Neither side ever waits on a lock: push fails when the queue is full, pop when it is empty.
+ * Every slot has a sequence number telling which lap of the ring it is ready for, the producers
+ * claim their slot with a compare and swap on the tail, and publish it with the sequence.
+ * N must be a power of two */
+template <typename T, unsigned int N>
+class MpscQueue
+{
+public:
+	MpscQueue() :
+		m_head(0),
+		m_tail(0)
+	{
+		static_assert((N & (N - 1)) == 0, "MpscQueue size must be a power of two");
+
+		for (unsigned int i = 0; i < N; i++) {
+			this->m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/* from any thread */
+	bool push(const T &value)
+	{
+		unsigned long long tail = this->m_tail.load(std::memory_order_relaxed);
+		Slot *slot;
+
+		for (;;) {
+			slot = &this->m_slots[tail & (N - 1)];
+			const unsigned long long sequence = slot->sequence.load(std::memory_order_acquire);
+
+			if (sequence == tail) {
+				/* free for this lap, claim it */
+				if (this->m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (sequence < tail) {
+				/* not popped yet since the previous lap */
+				return false;
+			}
+			else {
+				/* claimed by another producer */
+				tail = this->m_tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->value = value;
+		slot->sequence.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* only to be called from the consumer thread */
+	bool pop(T *r_value)
+	{
+		const unsigned long long head = this->m_head.load(std::memory_order_relaxed);
+		Slot *slot = &this->m_slots[head & (N - 1)];
+
+		/* empty, or claimed and not written yet */
+		if (slot->sequence.load(std::memory_order_acquire) != head + 1) {
+			return false;
+		}
+
+		*r_value = slot->value;
+		slot->sequence.store(head + N, std::memory_order_release);
+		this->m_head.store(head + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<unsigned long long> sequence;
+		T value;
+	};
+
+	Slot m_slots[N];
+
+	/* on their own cache lines, the tail is shared by the producers */
+	alignas(64) std::atomic<unsigned long long> m_head;
+	alignas(64) std::atomic<unsigned long long> m_tail;
+};
+
+#endif /* __MPSC_QUEUE_H__ */
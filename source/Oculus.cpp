@@ -1,14 +1,29 @@
 #include "Oculus.h"
+#include "Plugin.h"
 
+#if defined(USE_GLEW)
 #include "GL/glew.h"
 #include "GL/wglew.h"
 
+#define GL_HAS_TIMER_QUERY() (GLEW_ARB_timer_query)
+#define WGL_HAS_CREATE_CONTEXT() (WGLEW_ARB_create_context)
+#else
+#include "GLLoader.h"
+
+#define GL_HAS_TIMER_QUERY() (GLLoader_isVersion(3, 3) || GLLoader_hasExtension("GL_ARB_timer_query"))
+#define WGL_HAS_CREATE_CONTEXT() (GLLoader_getProcAddress("wglCreateContextAttribsARB") != nullptr)
+#endif
+
+#include "GLState.h"
+#include "GLTimer.h"
+#include "Log.h"
+#include "RuntimeContext.h"
+
 #include "OVR_CAPI_GL.h"
 #include "OVR_CAPI.h"
 
 #include "Extras/OVR_Math.h"
 
-#include <iostream>
 #include <assert.h>
 
 using namespace OVR;
@@ -17,14 +32,6 @@ using namespace OVR;
 #define MAX(a,b) a > b ? a : b;
 
 struct TextureBuffer;
-struct DepthBuffer;
-
-typedef enum eLibStatus
-{
-	LIB_UNLOADED = 0,
-	LIB_FAILED,
-	LIB_INITIALIZED,
-};
 
 class DllExport OculusImpl : public BackendImpl
 {
@@ -36,99 +43,128 @@ public:
 
 	bool setup(const unsigned int color_texture_left, const unsigned int color_texture_right);
 
-	bool update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right);
-
-	bool update(
-		float *r_yaw_left, float *r_pitch_left, float *r_roll_left, float *r_position_left,
-		float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_position_right);
+	bool setupSideBySide(const unsigned int color_texture);
 
-	bool update(
-		float *r_yaw_left, float *r_pitch_left, float *r_roll_left, float *r_orientation_left, float *r_position_left,
-		float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_orientation_right, float *r_position_right);
+	bool sampleTracking(const unsigned int frame, PoseSample *r_sample);
 
-	bool update(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right);
+	double getTime();
 
 	bool frameReady(void);
 
+	bool waitToBeginFrame(const unsigned int frame, HMD_FrameTiming *r_timing);
+
 	bool reCenter(void);
 
-	void getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
+	bool setPixelDensity(const float density);
+
+	double getDisplayPeriod(void);
+
+	unsigned int getMaxSamples(void);
+
+	unsigned int acquireEyeTexture(const int eye);
+
+	bool releaseEyeTexture(const int eye);
+
+	void computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
+
+	void setFramebufferBindings(const unsigned int draw_framebuffer, const unsigned int read_framebuffer);
+
+	unsigned int getGLCalls(void);
+
+	bool getGPUStats(HMD_GPUStats *r_stats);
+
+	bool createSubmitContext(void);
+
+	bool makeSubmitContextCurrent(const bool is_current);
+
+	void destroySubmitContext(void);
+
+	void *fenceFrame(void);
 
-	void getProjectionMatrixRight(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
+	void waitFence(void *fence);
+
+	bool createLayerSwapChain(const int layer);
+
+	void destroyLayerSwapChain(const int layer);
+
+	unsigned int acquireLayerSwapChain(const int layer);
+
+	bool commitLayerSwapChain(const int layer);
 
 private:
 	bool isConnected(void);
 	unsigned int getProjectionMatrixFlags(const bool is_opengl, const bool is_right_hand);
-	static bool initializeLibrary(void);
+	void setupReadBuffers(GLStateCache *state);
+	void setupMultisample(const int chains);
+	bool failSetup(void);
+	void createFramebuffers(void);
+	void deleteFramebuffers(void);
 
-	unsigned int m_frame;
 	ovrSession m_hmd;
 	ovrLayerEyeFov m_layer;
 
+	float m_refresh_rate;
 	ovrEyeRenderDesc m_eyeRenderDesc[2];
 	ovrVector3f m_hmdToEyeViewOffset[2];
-	TextureBuffer *m_eyeRenderTexture[2];
-	DepthBuffer *m_eyeDepthBuffer[2];
-	static eLibStatus m_lib_status;
+	TextureBuffer *m_eyeRenderTexture[2]; /* only the first one is used side by side */
+	TextureBuffer *m_eyeMultisampleTexture[2]; /* rendered into, resolved into the swap chains */
+	TextureBuffer *m_layerTexture[MAX_LAYERS];
+	ovrLayerQuad m_layerQuad[MAX_LAYERS];
 	GLuint m_fbo[2];
-};
 
-eLibStatus OculusImpl::m_lib_status = LIB_UNLOADED;
-
-/* TextureBuffer copied/adapted from Oculus SDK samples (Win32_GLAppUtil.h)  */
-struct DepthBuffer
-{
-	GLuint        texId;
-
-	DepthBuffer(Sizei size, int sampleCount)
-	{
-		assert(sampleCount <= 1); // The code doesn't currently handle MSAA textures.
+	GLStateCache m_gl_state;
 
-		glGenTextures(1, &texId);
-		glBindTexture(GL_TEXTURE_2D, texId);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	/* the submit context has a state of its own, with no framebuffer of the application to
+	 * restore (they are not shared between contexts). m_frame_gl_state is the one of the context
+	 * frameReady runs in */
+	GLStateCache m_submit_gl_state;
+	GLStateCache *m_frame_gl_state;
 
-		GLenum internalFormat = GL_DEPTH_COMPONENT24;
-		GLenum type = GL_UNSIGNED_INT;
+	/* copy and submission, read back by the thread submitting */
+	GLTimer m_gpu_timer;
+	std::mutex m_gpu_timer_mutex;
 
-		if (GL_ARB_depth_buffer_float)
-		{
-			internalFormat = GL_DEPTH_COMPONENT32F;
-			type = GL_FLOAT;
-		}
+	/* context of the submit thread, framebuffers are not shared between contexts */
+	HDC m_submit_dc;
+	HGLRC m_submit_context;
 
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size.w, size.h, 0, GL_DEPTH_COMPONENT, type, NULL);
-	}
-	~DepthBuffer()
-	{
-		if (texId)
-		{
-			glDeleteTextures(1, &texId);
-			texId = 0;
-		}
-	}
+	bool m_is_direct; /* the application renders into the swap chains */
+	bool m_is_copied; /* frameReady copies or resolves into the swap chains */
+	bool m_is_acquired[2];
+	GLint m_max_samples;
 };
 
+/* libOVR, initialized once for all the sessions */
+static RuntimeContext &getRuntime()
+{
+	static const RuntimeFunctions functions = {
+		[]() { return OVR_SUCCESS(ovr_Initialize(nullptr)); },
+		[]() { ovr_Shutdown(); },
+	};
+	static RuntimeContext runtime(functions);
+	return runtime;
+}
+
+/* TextureBuffer copied/adapted from Oculus SDK samples (Win32_GLAppUtil.h)  */
 struct TextureBuffer
 {
 	ovrSession          Session;
+	GLStateCache       *State;
 	ovrTextureSwapChain  TextureChain;
 	GLuint              texId;
 	GLuint              fboId;
 	Sizei               texSize;
+	int                 samples;
 
-	TextureBuffer(ovrSession session, bool rendertarget, bool displayableOnHmd, Sizei size, int mipLevels, unsigned char * data, int sampleCount) :
+	TextureBuffer(ovrSession session, GLStateCache *state, bool rendertarget, bool displayableOnHmd, Sizei size, int mipLevels, unsigned char * data, int sampleCount, bool staticImage = false) :
 		Session(session),
+		State(state),
 		TextureChain(nullptr),
 		texId(0),
 		fboId(0),
-		texSize(0, 0)
+		texSize(0, 0),
+		samples(sampleCount)
 	{
-		assert(sampleCount <= 1); // The code doesn't currently handle MSAA textures.
-
 		texSize = size;
 
 		if (displayableOnHmd)
@@ -145,7 +181,7 @@ struct TextureBuffer
 			desc.MipLevels = 1;
 			desc.Format = OVR_FORMAT_R8G8B8A8_UNORM_SRGB;
 			desc.SampleCount = 1;
-			desc.StaticImage = ovrFalse;
+			desc.StaticImage = staticImage ? ovrTrue : ovrFalse;
 
 			ovrResult result = ovr_CreateTextureSwapChainGL(Session, &desc, &TextureChain);
 
@@ -158,7 +194,7 @@ struct TextureBuffer
 				{
 					GLuint chainTexId;
 					ovr_GetTextureSwapChainBufferGL(Session, TextureChain, i, &chainTexId);
-					glBindTexture(GL_TEXTURE_2D, chainTexId);
+					State->bindTexture2D(chainTexId);
 
 					if (rendertarget)
 					{
@@ -177,10 +213,20 @@ struct TextureBuffer
 				}
 			}
 		}
+		else if (sampleCount > 1)
+		{
+			// Multisampled render target, resolved by the copy into a swap chain.
+			// Same format as the swap chains, a resolving blit can't convert it
+			glGenTextures(1, &texId);
+			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texId);
+			glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, sampleCount, GL_SRGB8_ALPHA8, texSize.w, texSize.h, GL_TRUE);
+			glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+			State->countCalls(3);
+		}
 		else
 		{
 			glGenTextures(1, &texId);
-			glBindTexture(GL_TEXTURE_2D, texId);
+			State->bindTexture2D(texId);
 
 			if (rendertarget)
 			{
@@ -200,7 +246,7 @@ struct TextureBuffer
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, texSize.w, texSize.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
 		}
 
-		if (mipLevels > 1)
+		if (mipLevels > 1 && sampleCount <= 1)
 		{
 			glGenerateMipmap(GL_TEXTURE_2D);
 		}
@@ -232,7 +278,7 @@ struct TextureBuffer
 		return texSize;
 	}
 
-	void SetAndClearRenderSurface(DepthBuffer* dbuffer)
+	GLuint GetCurrentTexture()
 	{
 		GLuint curTexId;
 		if (TextureChain)
@@ -245,22 +291,34 @@ struct TextureBuffer
 		{
 			curTexId = texId;
 		}
+		return curTexId;
+	}
+
+	// The surface is only blitted into, it has no depth. It is cleared only when the
+	// copied width x height region does not cover it, the rest would be undefined otherwise
+	// in the context of state, which may not be the one the texture was created in
+	void SetRenderSurface(GLStateCache *state, GLint width, GLint height)
+	{
+		GLuint curTexId = GetCurrentTexture();
 
-		glBindFramebuffer(GL_FRAMEBUFFER, fboId);
+		state->bindFramebuffer(GL_FRAMEBUFFER, fboId);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, curTexId, 0);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, dbuffer->texId, 0);
+		state->countCalls(1);
 
-		glViewport(0, 0, texSize.w, texSize.h);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glEnable(GL_FRAMEBUFFER_SRGB);
+		if (width < texSize.w || height < texSize.h)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			state->countCalls(1);
+		}
+		state->setFramebufferSRGB(true);
 	}
 
-	void UnsetRenderSurface()
+	void UnsetRenderSurface(GLStateCache *state)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, fboId);
+		state->bindFramebuffer(GL_FRAMEBUFFER, fboId);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
-		glDisable(GL_FRAMEBUFFER_SRGB);
+		state->countCalls(1);
+		state->setFramebufferSRGB(false);
 	}
 
 	void Commit()
@@ -272,49 +330,48 @@ struct TextureBuffer
 	}
 };
 
-bool OculusImpl::initializeLibrary()
-{
-	switch (OculusImpl::m_lib_status) {
-	case LIB_FAILED:
-		return false;
-		break;
-	case LIB_INITIALIZED:
-		return true;
-		break;
-	case LIB_UNLOADED:
-	default:
-		/* try to load the library */
-		break;
-	}
-
-	ovrResult result;
-	result = ovr_Initialize(nullptr);
-
-	if (OVR_FAILURE(result)) {
-		OculusImpl::m_lib_status = LIB_FAILED;
-		return false;
-	}
-	else {
-		OculusImpl::m_lib_status = LIB_INITIALIZED;
-		return true;
-	}
-}
-
 OculusImpl::OculusImpl() :BackendImpl()
 {
-	std::cout << "Oculus()" << std::endl;
+	BRIDGE_LOG_DEBUG("Oculus()");
 
+#if defined(USE_GLEW)
 	/* we need glew to access opengl commands */
 	glewInit();
-
-	/* Make sure the library is loaded */
-	if (OculusImpl::initializeLibrary() == false) {
-		std::cout << "libOVR could not initialize" << std::endl;
+#else
+	/* the GL entry points are resolved by their first call, see GLLoader.h */
+#endif
+
+	GLStateFunctions functions;
+	functions.bindFramebuffer = [](const unsigned int target, const unsigned int framebuffer) { glBindFramebuffer(target, framebuffer); };
+	functions.bindTexture = [](const unsigned int target, const unsigned int texture) { glBindTexture(target, texture); };
+	functions.enable = [](const unsigned int cap) { glEnable(cap); };
+	functions.disable = [](const unsigned int cap) { glDisable(cap); };
+	functions.getIntegerv = [](const unsigned int pname, int *r_data) { glGetIntegerv(pname, r_data); };
+	this->m_gl_state.setFunctions(functions);
+	this->m_submit_gl_state.setFunctions(functions);
+	this->m_submit_gl_state.setApplicationBindings(0, 0);
+	this->m_frame_gl_state = &this->m_gl_state;
+
+	GLTimerFunctions timer_functions;
+	timer_functions.genQueries = [](const int n, unsigned int *r_ids) { glGenQueries(n, r_ids); };
+	timer_functions.deleteQueries = [](const int n, const unsigned int *ids) { glDeleteQueries(n, ids); };
+	timer_functions.queryCounter = [](const unsigned int id, const unsigned int target) { glQueryCounter(id, target); };
+	timer_functions.getQueryObjectiv = [](const unsigned int id, const unsigned int pname, int *r_params) { glGetQueryObjectiv(id, pname, r_params); };
+	timer_functions.getQueryObjectui64v = [](const unsigned int id, const unsigned int pname, unsigned long long *r_params) { glGetQueryObjectui64v(id, pname, (GLuint64 *)r_params); };
+	this->m_gpu_timer.setFunctions(timer_functions);
+
+	this->m_max_samples = 1;
+	glGetIntegerv(GL_MAX_SAMPLES, &this->m_max_samples);
+
+	/* Make sure the library is loaded, the reference is released by the destructor */
+	if (getRuntime().acquire() == false) {
+		BRIDGE_LOG_ERROR("libOVR could not initialize");
 		throw "libOVR could not initialize";
 	}
 
 	if (this->isConnected() == false) {
-		std::cout << "Oculus not connected" << std::endl;
+		getRuntime().release();
+		BRIDGE_LOG_WARNING("Oculus not connected");
 		throw "Oculus not connected";
 	}
 
@@ -324,8 +381,8 @@ OculusImpl::OculusImpl() :BackendImpl()
 	/* initialize the device */
 	ovrResult result = ovr_Create(&hmd, &luid);
 	if (OVR_FAILURE(result)) {
-		ovr_Shutdown();
-		std::cout << "Oculus could not initialize" << std::endl;
+		getRuntime().release();
+		BRIDGE_LOG_ERROR("Oculus could not initialize");
 		throw "Oculus could not initialize";
 	}
 
@@ -339,10 +396,12 @@ OculusImpl::OculusImpl() :BackendImpl()
 
 	/* initialize data */
 	this->m_hmd = hmd;
+	this->m_refresh_rate = desc.DisplayRefreshRate;
 	this->m_eyeRenderDesc[0] = ovr_GetRenderDesc(hmd, ovrEye_Left, desc.DefaultEyeFov[0]);
 	this->m_eyeRenderDesc[1] = ovr_GetRenderDesc(hmd, ovrEye_Right, desc.DefaultEyeFov[1]);
 	this->m_hmdToEyeViewOffset[0] = this->m_eyeRenderDesc[0].HmdToEyeOffset;
 	this->m_hmdToEyeViewOffset[1] = this->m_eyeRenderDesc[1].HmdToEyeOffset;
+	this->invalidateProjection();
 	this->m_frame = -1;
 	this->m_width[0] = recommendedTex0Size.w;
 	this->m_height[0] = recommendedTex0Size.h;
@@ -350,43 +409,57 @@ OculusImpl::OculusImpl() :BackendImpl()
 	this->m_height[1] = recommendedTex1Size.h;
 	this->m_eyeRenderTexture[0] = NULL;
 	this->m_eyeRenderTexture[1] = NULL;
-	this->m_eyeDepthBuffer[0] = NULL;
-	this->m_eyeDepthBuffer[1] = NULL;
 	this->m_fbo[0] = 0;
 	this->m_fbo[1] = 0;
-	std::cout << "Oculus properly initialized (" << m_width[0] << "x" << m_height[0] << ", " << m_width[1] << "x" << m_height[1] << ")" << std::endl;
+	this->m_eyeMultisampleTexture[0] = NULL;
+	this->m_eyeMultisampleTexture[1] = NULL;
+
+	for (int layer = 0; layer < MAX_LAYERS; layer++) {
+		this->m_layerTexture[layer] = NULL;
+	}
+	this->m_submit_dc = NULL;
+	this->m_submit_context = NULL;
+	this->m_is_direct = false;
+	this->m_is_copied = false;
+	this->m_is_acquired[0] = false;
+	this->m_is_acquired[1] = false;
+	BRIDGE_LOG_INFO("Oculus properly initialized (%ux%u, %ux%u)", m_width[0], m_height[0], m_width[1], m_height[1]);
 }
 
 OculusImpl::~OculusImpl()
 {
-	std::cout << "~OculusImpl" << std::endl;
+	BRIDGE_LOG_DEBUG("~OculusImpl");
 
 	for (int eye = 0; eye < 2; eye++) {
 		if (this->m_eyeRenderTexture[eye])
 			delete this->m_eyeRenderTexture[eye];
 
-		if (this->m_eyeDepthBuffer[eye])
-			delete this->m_eyeDepthBuffer[eye];
+		if (this->m_eyeMultisampleTexture[eye])
+			delete this->m_eyeMultisampleTexture[eye];
 
 		if (this->m_fbo[eye])
 			glDeleteFramebuffers(1, &this->m_fbo[eye]);
 	}
 
+	{
+		std::lock_guard<std::mutex> lock(this->m_gpu_timer_mutex);
+		this->m_gpu_timer.destroy();
+	}
+
+	for (int layer = 0; layer < MAX_LAYERS; layer++) {
+		if (this->m_layerTexture[layer])
+			delete this->m_layerTexture[layer];
+	}
+
 	ovr_Destroy(this->m_hmd);
-	ovr_Shutdown();
 
-	/* the library needs to be re-loaded every time because the
-	 * Python wrapper keeps the static values
-	 */
-	OculusImpl::m_lib_status = LIB_UNLOADED;
+	/* libOVR stays initialized for the next session */
+	getRuntime().release();
 }
 
+/* with libOVR initialized */
 bool OculusImpl::isConnected()
 {
-	/* Make sure the library is loaded */
-	if (OculusImpl::initializeLibrary() == false)
-		throw "libOVR could not initialize";
-
 	ovrHmdDesc desc = ovr_GetHmdDesc(nullptr);
 	if (desc.Type == ovrHmd_None) {
 		return false;
@@ -398,26 +471,23 @@ bool OculusImpl::isConnected()
 
 bool OculusImpl::setup(const unsigned int color_texture_left, const unsigned int color_texture_right)
 {
-	GLint readFboId = 0;
-	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFboId);
+	this->m_gl_state.begin();
+
+	/* no textures to copy from, the application renders into the swap chains */
+	this->m_is_direct = (color_texture_left == 0 && color_texture_right == 0);
 
 	// Make eye render buffers
 	for (int eye = 0; eye < 2; eye++) {
 		ovrSizei idealTextureSize;
 		idealTextureSize.w = this->m_width[eye];
 		idealTextureSize.h = this->m_height[eye];
-		this->m_eyeRenderTexture[eye] = new TextureBuffer(this->m_hmd, true, true, idealTextureSize, 1, NULL, 1);
-		this->m_eyeDepthBuffer[eye] = new DepthBuffer(this->m_eyeRenderTexture[eye]->GetSize(), 0);
+		this->m_eyeRenderTexture[eye] = new TextureBuffer(this->m_hmd, &this->m_gl_state, true, true, idealTextureSize, 1, NULL, 1);
 
 		if (!this->m_eyeRenderTexture[eye]->TextureChain) {
-			return false;
+			return this->failSetup();
 		}
 	}
 
-	ovrSizei bufferSize;
-	bufferSize.w = this->m_width[0] + this->m_width[1];
-	bufferSize.h = MAX(this->m_height[0], this->m_height[1]);
-
 	ovrLayerEyeFov layer;
 	layer.Header.Type = ovrLayerType_EyeFov;
 	layer.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;   // Because OpenGL.
@@ -434,222 +504,404 @@ bool OculusImpl::setup(const unsigned int color_texture_left, const unsigned int
 	this->m_color_texture[1] = color_texture_right;
 	this->m_layer = layer;
 
-	// Configure the read buffer
-	for (int eye = 0; eye < 2; eye++) {
-		glGenFramebuffers(1, &this->m_fbo[eye]);
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->m_fbo[eye]);
-		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_color_texture[eye], 0);
-	}
+	this->setupMultisample(2);
+	this->setupReadBuffers(&this->m_gl_state);
 
 	// Turn off vsync to let the compositor do its magic
 	wglSwapIntervalEXT(0);
 
-	std::cout << "Oculus properly setup." << std::endl;
+	BRIDGE_LOG_INFO("Oculus properly setup.");
 
 	// restore active FBO
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, readFboId);
+	this->m_gl_state.end();
 	return true;
 };
 
-static void formatMatrix(ovrMatrix4f matrix, float *r_matrix)
+/* undo a setup that could not create its swap chains, so it can be tried again */
+bool OculusImpl::failSetup()
 {
-	for (int i = 0; i < 4; i++)
-		for (int j = 0; j < 4; j++)
-			r_matrix[i * 4 + j] = matrix.M[j][i];
+	for (int eye = 0; eye < 2; eye++) {
+		if (this->m_eyeRenderTexture[eye]) {
+			delete this->m_eyeRenderTexture[eye];
+			this->m_eyeRenderTexture[eye] = NULL;
+		}
+	}
+
+	this->m_is_side_by_side = false;
+
+	// restore active FBO
+	this->m_gl_state.end();
+	return false;
 }
 
-bool OculusImpl::update(float *r_orientation_left, float *r_position_left, float *r_orientation_right, float *r_position_right)
+bool OculusImpl::setupSideBySide(const unsigned int color_texture)
 {
-	/* Get both eye poses simultaneously, with IPD offset already included */
-	double ftiming = ovr_GetPredictedDisplayTime(this->m_hmd, ++this->m_frame);
-	ovrTrackingState hmdState = ovr_GetTrackingState(this->m_hmd, ftiming, ovrTrue);
+	this->m_gl_state.begin();
+
+	this->m_is_direct = (color_texture == 0);
+	this->m_is_side_by_side = true;
 
-	if ((hmdState.StatusFlags & (ovrStatus_OrientationTracked | ovrStatus_PositionTracked)) != 0) {
-		ovr_CalcEyePoses(hmdState.HeadPose.ThePose, this->m_hmdToEyeViewOffset, this->m_layer.RenderPose);
+	// Make a single render buffer for both eyes
+	ovrSizei bufferSize;
+	bufferSize.w = this->m_width[0] + this->m_width[1];
+	bufferSize.h = MAX(this->m_height[0], this->m_height[1]);
 
-		float *orientation[2] = { r_orientation_left, r_orientation_right };
-		float *position[2] = { r_position_left, r_position_right };
+	this->m_eyeRenderTexture[0] = new TextureBuffer(this->m_hmd, &this->m_gl_state, true, true, bufferSize, 1, NULL, 1);
 
-		for (int eye = 0; eye < 2; eye++) {
-			orientation[eye][0] = this->m_layer.RenderPose[eye].Orientation.w;
-			orientation[eye][1] = this->m_layer.RenderPose[eye].Orientation.x;
-			orientation[eye][2] = this->m_layer.RenderPose[eye].Orientation.y;
-			orientation[eye][3] = this->m_layer.RenderPose[eye].Orientation.z;
+	if (!this->m_eyeRenderTexture[0]->TextureChain) {
+		return this->failSetup();
+	}
 
-			position[eye][0] = this->m_scale * this->m_layer.RenderPose[eye].Position.x;
-			position[eye][1] = this->m_scale * this->m_layer.RenderPose[eye].Position.y;
-			position[eye][2] = this->m_scale * this->m_layer.RenderPose[eye].Position.z;
-		}
+	ovrLayerEyeFov layer;
+	layer.Header.Type = ovrLayerType_EyeFov;
+	layer.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;   // Because OpenGL.
 
-		return true;
+	for (int eye = 0; eye < 2; eye++) {
+		int viewport[4];
+		this->getEyeViewport(eye, viewport);
+
+		layer.ColorTexture[eye] = this->m_eyeRenderTexture[0]->TextureChain;
+		layer.Viewport[eye] = Recti(viewport[0], viewport[1], viewport[2], viewport[3]);
+		layer.Fov[eye] = this->m_eyeRenderDesc[eye].Fov;
 	}
-	return false;
-};
+	// layer.RenderPose is updated later per frame
 
-bool OculusImpl::update(
-	float *r_yaw_left, float *r_pitch_left, float *r_roll_left, float *r_position_left,
-	float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_position_right)
-{
-	/* Get both eye poses simultaneously, with IPD offset already included */
-	double ftiming = ovr_GetPredictedDisplayTime(this->m_hmd, ++this->m_frame);
-	ovrTrackingState hmdState = ovr_GetTrackingState(this->m_hmd, ftiming, ovrTrue);
+	/* store data */
+	this->m_color_texture[0] = color_texture;
+	this->m_color_texture[1] = color_texture;
+	this->m_layer = layer;
 
-	if ((hmdState.StatusFlags & (ovrStatus_OrientationTracked | ovrStatus_PositionTracked)) != 0) {
-		ovr_CalcEyePoses(hmdState.HeadPose.ThePose, this->m_hmdToEyeViewOffset, this->m_layer.RenderPose);
+	this->setupMultisample(1);
+	this->setupReadBuffers(&this->m_gl_state);
 
-		Quatf quat;
+	// Turn off vsync to let the compositor do its magic
+	wglSwapIntervalEXT(0);
 
-		quat = this->m_layer.RenderPose[0].Orientation;
-		quat.GetYawPitchRoll(r_yaw_left, r_pitch_left, r_roll_left);
+	BRIDGE_LOG_INFO("Oculus properly setup, side by side.");
 
-		quat = this->m_layer.RenderPose[1].Orientation;
-		quat.GetYawPitchRoll(r_yaw_right, r_pitch_right, r_roll_right);
+	// restore active FBO
+	this->m_gl_state.end();
+	return true;
+}
 
-		r_position_left[0] = this->m_scale * this->m_layer.RenderPose[0].Position.x;
-		r_position_left[1] = this->m_scale * this->m_layer.RenderPose[0].Position.y;
-		r_position_left[2] = this->m_scale * this->m_layer.RenderPose[0].Position.z;
+/* with samples, the application renders into multisampled textures, its own in copy mode or
+ * the ones of the bridge in direct mode. The copy into the swap chains resolves them */
+void OculusImpl::setupMultisample(const int chains)
+{
+	this->m_is_copied = !this->m_is_direct || this->m_samples > 1;
 
-		r_position_right[0] = this->m_scale * this->m_layer.RenderPose[1].Position.x;
-		r_position_right[1] = this->m_scale * this->m_layer.RenderPose[1].Position.y;
-		r_position_right[2] = this->m_scale * this->m_layer.RenderPose[1].Position.z;
-		return true;
+	for (int eye = 0; eye < chains && this->m_is_direct && this->m_samples > 1; eye++) {
+		this->m_eyeMultisampleTexture[eye] = new TextureBuffer(this->m_hmd, &this->m_gl_state, true, false, this->m_eyeRenderTexture[eye]->GetSize(), 1, NULL, this->m_samples);
+		this->m_color_texture[eye] = this->m_eyeMultisampleTexture[eye]->texId;
 	}
-	return false;
-};
+}
 
-bool OculusImpl::update(
-	float *r_yaw_left, float *r_pitch_left, float *r_roll_left, float *r_orientation_left, float *r_position_left,
-	float *r_yaw_right, float *r_pitch_right, float *r_roll_right, float *r_orientation_right, float *r_position_right)
+void OculusImpl::setupReadBuffers(GLStateCache *state)
 {
-	/* Get both eye poses simultaneously, with IPD offset already included */
-	double ftiming = ovr_GetPredictedDisplayTime(this->m_hmd, ++this->m_frame);
-	ovrTrackingState hmdState = ovr_GetTrackingState(this->m_hmd, ftiming, ovrTrue);
+	/* one per swap chain */
+	const int chains = this->m_is_side_by_side ? 1 : 2;
+	const GLenum target = this->m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
 
-	if ((hmdState.StatusFlags & (ovrStatus_OrientationTracked | ovrStatus_PositionTracked)) != 0) {
-		ovr_CalcEyePoses(hmdState.HeadPose.ThePose, this->m_hmdToEyeViewOffset, this->m_layer.RenderPose);
+	for (int eye = 0; eye < chains && this->m_is_copied; eye++) {
+		glGenFramebuffers(1, &this->m_fbo[eye]);
+		state->bindFramebuffer(GL_READ_FRAMEBUFFER, this->m_fbo[eye]);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target, m_color_texture[eye], 0);
+	}
 
-		Quatf quat;
+	/* the timer queries of the copy, in the same context */
+	if (this->m_is_copied && GL_HAS_TIMER_QUERY()) {
+		std::lock_guard<std::mutex> lock(this->m_gpu_timer_mutex);
+		this->m_gpu_timer.create();
+	}
+}
 
-		quat = this->m_layer.RenderPose[0].Orientation;
-		quat.GetYawPitchRoll(r_yaw_left, r_pitch_left, r_roll_left);
-		r_orientation_left[0] = quat.w;
-		r_orientation_left[1] = quat.x;
-		r_orientation_left[2] = quat.y;
-		r_orientation_left[3] = quat.z;
+/* in the context frameReady runs in */
+void OculusImpl::createFramebuffers()
+{
+	this->m_frame_gl_state->begin();
 
-		quat = this->m_layer.RenderPose[1].Orientation;
-		quat.GetYawPitchRoll(r_yaw_right, r_pitch_right, r_roll_right);
-		r_orientation_right[0] = quat.w;
-		r_orientation_right[1] = quat.x;
-		r_orientation_right[2] = quat.y;
-		r_orientation_right[3] = quat.z;
+	for (int eye = 0; eye < 2; eye++) {
+		if (this->m_eyeRenderTexture[eye]) {
+			glGenFramebuffers(1, &this->m_eyeRenderTexture[eye]->fboId);
+		}
+	}
+	this->setupReadBuffers(this->m_frame_gl_state);
 
-		r_position_left[0] = this->m_scale * this->m_layer.RenderPose[0].Position.x;
-		r_position_left[1] = this->m_scale * this->m_layer.RenderPose[0].Position.y;
-		r_position_left[2] = this->m_scale * this->m_layer.RenderPose[0].Position.z;
+	this->m_frame_gl_state->end();
+}
 
-		r_position_right[0] = this->m_scale * this->m_layer.RenderPose[1].Position.x;
-		r_position_right[1] = this->m_scale * this->m_layer.RenderPose[1].Position.y;
-		r_position_right[2] = this->m_scale * this->m_layer.RenderPose[1].Position.z;
-		return true;
+void OculusImpl::deleteFramebuffers()
+{
+	for (int eye = 0; eye < 2; eye++) {
+		if (this->m_eyeRenderTexture[eye] && this->m_eyeRenderTexture[eye]->fboId) {
+			glDeleteFramebuffers(1, &this->m_eyeRenderTexture[eye]->fboId);
+			this->m_eyeRenderTexture[eye]->fboId = 0;
+		}
+
+		if (this->m_fbo[eye]) {
+			glDeleteFramebuffers(1, &this->m_fbo[eye]);
+			this->m_fbo[eye] = 0;
+		}
 	}
-	return false;
+
+	std::lock_guard<std::mutex> lock(this->m_gpu_timer_mutex);
+	this->m_gpu_timer.destroy();
 }
 
-bool OculusImpl::update(const bool is_right_hand, float *r_matrix_left, float *r_matrix_right)
+static void formatMatrix(ovrMatrix4f matrix, float *r_matrix)
 {
-	/* Get both eye poses simultaneously, with IPD offset already included */
-	double ftiming = ovr_GetPredictedDisplayTime(this->m_hmd, ++this->m_frame);
-	ovrTrackingState hmdState = ovr_GetTrackingState(this->m_hmd, ftiming, ovrTrue);
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			r_matrix[i * 4 + j] = matrix.M[j][i];
+}
+
+static void copyPose(const ovrPosef &pose, float *r_orientation, float *r_position)
+{
+	r_orientation[0] = pose.Orientation.w;
+	r_orientation[1] = pose.Orientation.x;
+	r_orientation[2] = pose.Orientation.y;
+	r_orientation[3] = pose.Orientation.z;
+
+	r_position[0] = pose.Position.x;
+	r_position[1] = pose.Position.y;
+	r_position[2] = pose.Position.z;
+}
 
-	if ((hmdState.StatusFlags & (ovrStatus_OrientationTracked | ovrStatus_PositionTracked)) != 0) {
-		ovr_CalcEyePoses(hmdState.HeadPose.ThePose, this->m_hmdToEyeViewOffset, this->m_layer.RenderPose);
+static ovrPosef convertPose(const float *orientation, const float *position)
+{
+	ovrPosef pose;
+	pose.Orientation.w = orientation[0];
+	pose.Orientation.x = orientation[1];
+	pose.Orientation.y = orientation[2];
+	pose.Orientation.z = orientation[3];
+
+	pose.Position.x = position[0];
+	pose.Position.y = position[1];
+	pose.Position.z = position[2];
+	return pose;
+}
 
-		float *matrix[2] = { r_matrix_left, r_matrix_right };
+bool OculusImpl::sampleTracking(const unsigned int frame, PoseSample *r_sample)
+{
+	/* Get both eye poses simultaneously, with IPD offset already included */
+	double ftiming = ovr_GetPredictedDisplayTime(this->m_hmd, frame);
+	ovrTrackingState hmdState = ovr_GetTrackingState(this->m_hmd, ftiming, ovrTrue);
 
-		for (int eye = 0; eye < 2; eye++) {
-			Vector3f pos = this->m_layer.RenderPose[eye].Position;
-			Matrix4f rot = Matrix4f(this->m_layer.RenderPose[eye].Orientation);
+	r_sample->time = ftiming;
+	r_sample->frame = frame;
+	r_sample->status = 0;
 
-			Vector3f finalUp, finalForward;
-			Matrix4f view;
+	if (hmdState.StatusFlags & ovrStatus_OrientationTracked)
+		r_sample->status |= HMD_STATUS_ORIENTATION_TRACKED;
 
-			finalUp = rot.Transform(Vector3f(0.0f, 1.0f, 0.0f));
-			finalForward = rot.Transform(Vector3f(0.0f, 0.0f, -1.0f));
+	if (hmdState.StatusFlags & ovrStatus_PositionTracked)
+		r_sample->status |= HMD_STATUS_POSITION_TRACKED;
 
-			if (is_right_hand) {
-				view = Matrix4f::LookAtRH(pos, pos + finalForward, finalUp);
-			}
-			else {
-				view = Matrix4f::LookAtLH(pos, pos + finalForward, finalUp);
-			}
+	if (r_sample->status != 0) {
+		ovrPosef eyePoses[2];
+		ovr_CalcEyePoses(hmdState.HeadPose.ThePose, this->m_hmdToEyeViewOffset, eyePoses);
 
-			formatMatrix(view, matrix[eye]);
-		}
+		copyPose(hmdState.HeadPose.ThePose, r_sample->head_orientation, r_sample->head_position);
+		copyPose(eyePoses[0], r_sample->orientation[0], r_sample->position[0]);
+		copyPose(eyePoses[1], r_sample->orientation[1], r_sample->position[1]);
 		return true;
 	}
 	return false;
 }
 
+double OculusImpl::getTime()
+{
+	/* same clock as the predicted display times */
+	return ovr_GetTimeInSeconds();
+}
+
 bool OculusImpl::frameReady()
 {
-	GLint readFboId = 0;
-	GLint fboId = 0;
-	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFboId);
-	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &fboId);
+	/* side by side the atlas is copied and committed at once */
+	const int chains = this->m_is_side_by_side ? 1 : 2;
+	GLStateCache *state = this->m_frame_gl_state;
 
-	for (int eye = 0; eye < 2; eye++) {
-		// Switch to eye render target
-		this->m_eyeRenderTexture[eye]->SetAndClearRenderSurface(this->m_eyeDepthBuffer[eye]);
+	/* the whole timed section, getGPUStats reads the timer from another thread */
+	std::unique_lock<std::mutex> timer_lock(this->m_gpu_timer_mutex, std::defer_lock);
+
+	if (this->m_is_copied) {
+		/* in direct mode the context is not touched */
+		state->begin();
+
+		/* read back the frames done, before timing this one */
+		timer_lock.lock();
+		this->m_gpu_timer.beginFrame();
+		this->m_gpu_timer.begin(GLTimer::SUBMIT);
+	}
+
+	for (int eye = 0; eye < chains && this->m_is_copied; eye++) {
+		this->m_gpu_timer.begin((GLTimer::eSection)eye);
 
 		GLint w = this->m_eyeRenderTexture[eye]->texSize.w;
 		GLint h = this->m_eyeRenderTexture[eye]->texSize.h;
 
-		// copy result from color_texture to HMD
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->m_fbo[eye]);
+		if (!this->m_is_side_by_side) {
+			// only the region rendered at the dynamic resolution
+			w = this->m_submit_viewport[eye][2];
+			h = this->m_submit_viewport[eye][3];
+		}
+
+		// Switch to eye render target, cleared only if the blit doesn't cover it
+		this->m_eyeRenderTexture[eye]->SetRenderSurface(state, w, h);
+
+		// copy result from color_texture to HMD, resolving the samples in the same blit
+		state->bindFramebuffer(GL_READ_FRAMEBUFFER, this->m_fbo[eye]);
 		glBlitFramebuffer(0, 0, w, h,
 		                  0, 0, w, h,
 		                  GL_COLOR_BUFFER_BIT, GL_NEAREST);
-		this->m_eyeRenderTexture[eye]->UnsetRenderSurface();
+		state->countCalls(1);
+		this->m_eyeRenderTexture[eye]->UnsetRenderSurface(state);
 
 		this->m_eyeRenderTexture[eye]->Commit();
+		this->m_gpu_timer.end((GLTimer::eSection)eye);
 	}
 
-	ovrLayerHeader *layers = &this->m_layer.Header;
-	ovrResult result = ovr_SubmitFrame(this->m_hmd, this->m_frame, nullptr, &layers, 1);
+	// submit the pose and the viewports the frame was rendered with
+	for (int eye = 0; eye < 2; eye++) {
+		const int *viewport = this->m_submit_viewport[eye];
+
+		this->m_layer.RenderPose[eye] = convertPose(this->m_submit_sample.orientation[eye], this->m_submit_sample.position[eye]);
+		this->m_layer.Viewport[eye] = Recti(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+	// the eyes, then the layers with a texture in the order of their ids
+	ovrLayerHeader *layers[1 + MAX_LAYERS];
+	unsigned int count = 0;
+
+	layers[count++] = &this->m_layer.Header;
+
+	for (int layer = 0; layer < MAX_LAYERS; layer++) {
+		const Layer &entry = this->m_submit_layers[layer];
+
+		if (!entry.is_used || !entry.is_committed) {
+			continue;
+		}
+
+		ovrLayerQuad &quad = this->m_layerQuad[layer];
+		quad.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft | (entry.desc.is_head_locked ? ovrLayerFlag_HeadLocked : 0);
+		quad.QuadPoseCenter = convertPose(entry.desc.orientation, entry.desc.position);
+		quad.QuadSize.x = entry.desc.size[0];
+		quad.QuadSize.y = entry.desc.size[1];
+
+		layers[count++] = &quad.Header;
+	}
+
+	ovrResult result = ovr_SubmitFrame(this->m_hmd, this->m_submit_frame, nullptr, layers, count);
 
 	// restore active FBO
-	glBindFramebuffer(GL_FRAMEBUFFER, fboId);
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, readFboId);
+	if (this->m_is_copied) {
+		state->end();
+		this->m_gpu_timer.end(GLTimer::SUBMIT);
+		this->m_gpu_timer.endFrame();
+		timer_lock.unlock();
+	}
+	state->endFrame();
 
 	return (ovrSuccess == result);
 };
 
+bool OculusImpl::waitToBeginFrame(const unsigned int frame, HMD_FrameTiming *r_timing)
+{
+	ovrSessionStatus status;
+
+	if (OVR_FAILURE(ovr_GetSessionStatus(this->m_hmd, &status))) {
+		return false;
+	}
+
+	/* ovr_SubmitFrame blocks until the compositor wants the next frame, it paces the loop */
+	r_timing->should_render = status.IsVisible ? 1 : 0;
+	r_timing->predicted_display_time = ovr_GetPredictedDisplayTime(this->m_hmd, frame);
+	r_timing->period = this->getDisplayPeriod();
+	return true;
+}
+
 bool OculusImpl::reCenter()
 {
 	ovr_RecenterTrackingOrigin(this->m_hmd);
 	return true;
 };
 
-void OculusImpl::getProjectionMatrixLeft(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+bool OculusImpl::setPixelDensity(const float density)
 {
-	unsigned int flags = getProjectionMatrixFlags(is_opengl, is_right_hand);
+	/* the swap chains are allocated once */
+	if (this->m_eyeRenderTexture[0] || density <= 0.0f) {
+		return false;
+	}
 
-	ovrMatrix4f matrix = ovrMatrix4f_Projection(
-		this->m_eyeRenderDesc[0].Fov,
-		nearz,
-		farz,
-		flags);
+	for (int eye = 0; eye < 2; eye++) {
+		ovrSizei size = ovr_GetFovTextureSize(this->m_hmd, (ovrEyeType)eye, this->m_eyeRenderDesc[eye].Fov, density);
+		this->m_width[eye] = size.w;
+		this->m_height[eye] = size.h;
+	}
+	return true;
+}
 
-	formatMatrix(matrix, r_matrix);
+unsigned int OculusImpl::getMaxSamples()
+{
+	return this->m_max_samples > 1 ? (unsigned int)this->m_max_samples : 1;
+}
+
+double OculusImpl::getDisplayPeriod()
+{
+	return this->m_refresh_rate > 0.0f ? 1.0 / this->m_refresh_rate : 0.0;
+}
+
+unsigned int OculusImpl::acquireEyeTexture(const int eye)
+{
+	const int chain = this->m_is_side_by_side ? 0 : eye;
+	TextureBuffer *texture = this->m_eyeRenderTexture[chain];
+
+	if (!this->m_is_direct || !texture) {
+		return 0;
+	}
+
+	this->m_is_acquired[eye] = true;
+
+	if (this->m_eyeMultisampleTexture[chain]) {
+		/* always the same, frameReady resolves it into the swap chain */
+		return this->m_eyeMultisampleTexture[chain]->texId;
+	}
+
+	/* the current texture only changes when the swap chain is committed */
+	return texture->GetCurrentTexture();
 }
 
-void OculusImpl::getProjectionMatrixRight(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+bool OculusImpl::releaseEyeTexture(const int eye)
+{
+	if (!this->m_is_acquired[eye]) {
+		return false;
+	}
+
+	this->m_is_acquired[eye] = false;
+
+	if (this->m_is_copied) {
+		/* multisampled, committed by frameReady after the resolve */
+		return true;
+	}
+
+	if (this->m_is_side_by_side) {
+		/* the atlas is committed once both eyes are done with it */
+		if (!this->m_is_acquired[1 - eye]) {
+			this->m_eyeRenderTexture[0]->Commit();
+		}
+		return true;
+	}
+
+	this->m_eyeRenderTexture[eye]->Commit();
+	return true;
+}
+
+void OculusImpl::computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
 {
 	unsigned int flags = getProjectionMatrixFlags(is_opengl, is_right_hand);
 
 	ovrMatrix4f matrix = ovrMatrix4f_Projection(
-		this->m_eyeRenderDesc[1].Fov,
+		this->m_eyeRenderDesc[eye].Fov,
 		nearz,
 		farz,
 		flags);
@@ -657,6 +909,158 @@ void OculusImpl::getProjectionMatrixRight(const float nearz, const float farz, c
 	formatMatrix(matrix, r_matrix);
 }
 
+bool OculusImpl::createLayerSwapChain(const int layer)
+{
+	const HMD_LayerDesc &desc = this->m_layers[layer].desc;
+	const bool is_static = (desc.type == HMD_LAYER_STATIC);
+
+	ovrSizei size;
+	size.w = desc.width;
+	size.h = desc.height;
+
+	this->m_gl_state.begin();
+	TextureBuffer *texture = new TextureBuffer(this->m_hmd, &this->m_gl_state, true, true, size, 1, NULL, 1, is_static);
+	this->m_gl_state.end();
+
+	if (!texture->TextureChain) {
+		delete texture;
+		return false;
+	}
+
+	ovrLayerQuad quad = {};
+	quad.Header.Type = ovrLayerType_Quad;
+	quad.ColorTexture = texture->TextureChain;
+	quad.Viewport = Recti(texture->GetSize());
+	// the flags and the pose are updated per frame
+
+	this->m_layerTexture[layer] = texture;
+	this->m_layerQuad[layer] = quad;
+	return true;
+}
+
+void OculusImpl::destroyLayerSwapChain(const int layer)
+{
+	delete this->m_layerTexture[layer];
+	this->m_layerTexture[layer] = NULL;
+}
+
+unsigned int OculusImpl::acquireLayerSwapChain(const int layer)
+{
+	/* the current texture only changes when the swap chain is committed */
+	return this->m_layerTexture[layer]->GetCurrentTexture();
+}
+
+bool OculusImpl::commitLayerSwapChain(const int layer)
+{
+	return OVR_SUCCESS(ovr_CommitTextureSwapChain(this->m_hmd, this->m_layerTexture[layer]->TextureChain));
+}
+
+void OculusImpl::setFramebufferBindings(const unsigned int draw_framebuffer, const unsigned int read_framebuffer)
+{
+	this->m_gl_state.setApplicationBindings(draw_framebuffer, read_framebuffer);
+}
+
+unsigned int OculusImpl::getGLCalls()
+{
+	return this->m_frame_gl_state->getFrameCalls();
+}
+
+bool OculusImpl::getGPUStats(HMD_GPUStats *r_stats)
+{
+	std::lock_guard<std::mutex> lock(this->m_gpu_timer_mutex);
+
+	if (!this->m_gpu_timer.isCreated()) {
+		return false;
+	}
+
+	this->m_gpu_timer.getStats(r_stats);
+	return true;
+}
+
+bool OculusImpl::createSubmitContext()
+{
+	HDC dc = wglGetCurrentDC();
+	HGLRC context = wglGetCurrentContext();
+
+	if (!dc || !context) {
+		return false;
+	}
+
+	/* share the textures with the render context */
+	if (WGL_HAS_CREATE_CONTEXT()) {
+		this->m_submit_context = wglCreateContextAttribsARB(dc, context, NULL);
+	}
+	else {
+		this->m_submit_context = wglCreateContext(dc);
+
+		if (this->m_submit_context && !wglShareLists(context, this->m_submit_context)) {
+			wglDeleteContext(this->m_submit_context);
+			this->m_submit_context = NULL;
+		}
+	}
+
+	if (!this->m_submit_context) {
+		BRIDGE_LOG_ERROR("Oculus submit context could not be created");
+		return false;
+	}
+
+	/* the submit thread makes its own */
+	this->m_submit_dc = dc;
+	this->deleteFramebuffers();
+	return true;
+}
+
+bool OculusImpl::makeSubmitContextCurrent(const bool is_current)
+{
+	if (!is_current) {
+		this->deleteFramebuffers();
+		this->m_frame_gl_state = &this->m_gl_state;
+		return wglMakeCurrent(NULL, NULL) == TRUE;
+	}
+
+	if (!wglMakeCurrent(this->m_submit_dc, this->m_submit_context)) {
+		return false;
+	}
+
+	this->m_frame_gl_state = &this->m_submit_gl_state;
+	this->createFramebuffers();
+	return true;
+}
+
+void OculusImpl::destroySubmitContext()
+{
+	if (this->m_submit_context) {
+		wglDeleteContext(this->m_submit_context);
+		this->m_submit_context = NULL;
+	}
+
+	/* back to submitting from the render context */
+	this->m_frame_gl_state = &this->m_gl_state;
+	this->createFramebuffers();
+}
+
+void *OculusImpl::fenceFrame()
+{
+	if (!this->m_is_copied) {
+		/* committing the swap chains synchronizes with the compositor */
+		return nullptr;
+	}
+
+	/* the copy must see the application rendering */
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+	return fence;
+}
+
+void OculusImpl::waitFence(void *fence)
+{
+	if (fence) {
+		/* the GPU waits, not the submit thread */
+		glWaitSync((GLsync)fence, 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync((GLsync)fence);
+	}
+}
+
 unsigned int OculusImpl::getProjectionMatrixFlags(const bool is_opengl, const bool is_right_hand)
 {
 	unsigned int flags = is_right_hand ? ovrProjection_None : ovrProjection_LeftHanded;
@@ -670,3 +1074,10 @@ unsigned int OculusImpl::getProjectionMatrixFlags(const bool is_opengl, const bo
 void Oculus::initializeImplementation() {
 	m_me = new OculusImpl();
 }
+
+static bool shutdownRuntime(void)
+{
+	return getRuntime().shutdownIdle();
+}
+
+HMD_PLUGIN_RUNTIME("Oculus", Oculus, shutdownRuntime)
@@ -17,8 +17,12 @@ class OculusImpl;
 
 class DllExport Oculus : public Backend
 {
+public:
+	Oculus() {
+		this->initializeImplementation();
+	}
+
 protected:
-	OculusImpl *m_me;
 	virtual void initializeImplementation();
 };
 
@@ -0,0 +1,56 @@
+#ifndef __PLUGIN_H__
+#define __PLUGIN_H__
+
+#include "Backend.h"
+
+/* Backend plugins: shared objects the bridge loads the first time their backend is requested,
+ * so the core library starts without the SDK (and the GL loader) of every device.
+ *
+ * A plugin exports HMD_pluginEntry, returning its description. The backend is created and deleted
+ * by the plugin, with its own allocator. The classes of Backend.h cross the boundary, so
+ * HMD_PLUGIN_ABI is raised whenever their layout changes, and a plugin built with another one is
+ * not used */
+
+#define HMD_PLUGIN_ABI 2
+#define HMD_PLUGIN_ENTRY "HMD_pluginEntry"
+
+#if defined(_WIN32) || defined(_WIN64)
+#define HMD_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define HMD_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+struct HMD_Plugin
+{
+	unsigned int abi; /* HMD_PLUGIN_ABI of the plugin */
+	const char *name;
+	Backend *(*create)(void); /* nullptr when the device can't be used */
+	void (*destroy)(Backend *backend);
+	bool (*shutdownIdle)(void); /* shut the device runtime down if no backend holds it, may be nullptr */
+};
+
+typedef const HMD_Plugin *(*HMD_PluginEntry)(void);
+
+/* entry point of the plugin of a backend with a default constructor, that throws when the device
+ * can't be used */
+#define HMD_PLUGIN(name, BackendClass) HMD_PLUGIN_RUNTIME(name, BackendClass, nullptr)
+
+/* same, for a device runtime shared by the backends, see RuntimeContext */
+#define HMD_PLUGIN_RUNTIME(name, BackendClass, shutdown_idle) \
+	static Backend *HMD_pluginCreate(void) \
+	{ \
+		try { \
+			return new BackendClass(); \
+		} \
+		catch (const char *) { \
+			return nullptr; \
+		} \
+	} \
+	static void HMD_pluginDestroy(Backend *backend) { delete backend; } \
+	HMD_PLUGIN_EXPORT const HMD_Plugin *HMD_pluginEntry(void) \
+	{ \
+		static const HMD_Plugin plugin = { HMD_PLUGIN_ABI, name, HMD_pluginCreate, HMD_pluginDestroy, shutdown_idle }; \
+		return &plugin; \
+	}
+
+#endif /* __PLUGIN_H__ */
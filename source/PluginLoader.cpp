@@ -0,0 +1,217 @@
+#include "PluginLoader.h"
+#include "Log.h"
+
+#include <mutex>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace {
+
+struct LoadedPlugin
+{
+	std::string name;
+	void *library;
+	const HMD_Plugin *plugin;
+};
+
+std::mutex s_mutex;
+std::string s_path;
+std::vector<LoadedPlugin> s_plugins;
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#define PLUGIN_PREFIX ""
+#define PLUGIN_SUFFIX ".dll"
+#define PLUGIN_SEPARATOR '\\'
+
+void *openLibrary(const std::string &path)
+{
+	return (void *)LoadLibraryA(path.c_str());
+}
+
+void *findSymbol(void *library, const char *symbol)
+{
+	return (void *)GetProcAddress((HMODULE)library, symbol);
+}
+
+void closeLibrary(void *library)
+{
+	FreeLibrary((HMODULE)library);
+}
+
+/* directory of the bridge library, with its separator */
+std::string getLibraryDirectory()
+{
+	HMODULE module = NULL;
+	char path[MAX_PATH];
+
+	if (!GetModuleHandleExA(
+		GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		(LPCSTR)&PluginLoader::load, &module))
+	{
+		return std::string();
+	}
+
+	const DWORD length = GetModuleFileNameA(module, path, MAX_PATH);
+
+	if (length == 0 || length == MAX_PATH) {
+		return std::string();
+	}
+
+	const std::string file(path, length);
+	const size_t separator = file.find_last_of("\\/");
+	return separator == std::string::npos ? std::string() : file.substr(0, separator + 1);
+}
+
+#else
+
+#define PLUGIN_PREFIX "lib"
+#define PLUGIN_SUFFIX ".so" /* of the CMake modules, on macOS too */
+#define PLUGIN_SEPARATOR '/'
+
+void *openLibrary(const std::string &path)
+{
+	/* the symbols of a plugin are its own, resolved at once so a missing one fails here */
+	return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+void *findSymbol(void *library, const char *symbol)
+{
+	return dlsym(library, symbol);
+}
+
+void closeLibrary(void *library)
+{
+	dlclose(library);
+}
+
+std::string getLibraryDirectory()
+{
+	Dl_info info;
+
+	if (!dladdr((void *)&PluginLoader::load, &info) || !info.dli_fname) {
+		return std::string();
+	}
+
+	const std::string file(info.dli_fname);
+	const size_t separator = file.rfind('/');
+	return separator == std::string::npos ? std::string() : file.substr(0, separator + 1);
+}
+
+#endif
+
+std::string getDirectory(const std::string &path)
+{
+	if (path.empty() || path.back() == '/' || path.back() == PLUGIN_SEPARATOR) {
+		return path;
+	}
+	return path + PLUGIN_SEPARATOR;
+}
+
+LoadedPlugin *find(const char *name)
+{
+	for (LoadedPlugin &loaded : s_plugins) {
+		if (loaded.name == name) {
+			return &loaded;
+		}
+	}
+	return nullptr;
+}
+
+} /* namespace */
+
+void PluginLoader::setPath(const char *path)
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+	s_path = path ? path : "";
+}
+
+const HMD_Plugin *PluginLoader::load(const char *name)
+{
+	if (!name || !name[0]) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	const LoadedPlugin *loaded = find(name);
+
+	if (loaded) {
+		return loaded->plugin;
+	}
+
+	const std::string file = std::string(PLUGIN_PREFIX) + name + PLUGIN_SUFFIX;
+	const char *environment = getenv("HMD_BRIDGE_PLUGIN_PATH");
+
+	/* an empty directory is the search path of the system */
+	std::vector<std::string> directories;
+
+	if (!s_path.empty()) {
+		directories.push_back(getDirectory(s_path));
+	}
+
+	if (environment && environment[0]) {
+		directories.push_back(getDirectory(environment));
+	}
+
+	directories.push_back(getLibraryDirectory());
+	directories.push_back(std::string());
+
+	for (const std::string &directory : directories) {
+		void *library = openLibrary(directory + file);
+
+		if (!library) {
+			continue;
+		}
+
+		HMD_PluginEntry entry = (HMD_PluginEntry)findSymbol(library, HMD_PLUGIN_ENTRY);
+		const HMD_Plugin *plugin = entry ? entry() : nullptr;
+
+		if (!plugin || plugin->abi != HMD_PLUGIN_ABI || !plugin->create || !plugin->destroy) {
+			BRIDGE_LOG_WARNING("Plugin \"%s%s\" is not compatible with this bridge", directory.c_str(), file.c_str());
+			closeLibrary(library);
+			return nullptr;
+		}
+
+		LoadedPlugin plugin_loaded;
+		plugin_loaded.name = name;
+		plugin_loaded.library = library;
+		plugin_loaded.plugin = plugin;
+		s_plugins.push_back(plugin_loaded);
+		return plugin;
+	}
+
+	return nullptr;
+}
+
+bool PluginLoader::isLoaded(const char *name)
+{
+	if (!name) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return find(name) != nullptr;
+}
+
+bool PluginLoader::shutdownIdle(const char *name)
+{
+	if (!name) {
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+	const LoadedPlugin *loaded = find(name);
+
+	if (!loaded || !loaded->plugin->shutdownIdle) {
+		return true;
+	}
+	return loaded->plugin->shutdownIdle();
+}
@@ -0,0 +1,38 @@
+#ifndef __PLUGIN_LOADER_H__
+#define __PLUGIN_LOADER_H__
+
+#include "Plugin.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#if !defined(DllExport)
+#define DllExport   __declspec( dllexport )
+#endif
+
+#else
+#define DllExport
+#endif
+
+/* Finds and loads the plugins, once per process: a loaded plugin stays until the process ends,
+ * the vtables of its backends live in it.
+ *
+ * The library of the plugin "Name" is libName.so (Name.dll on Windows). It is looked for in the
+ * directory set with setPath, then in HMD_BRIDGE_PLUGIN_PATH, then next to the bridge library,
+ * and at last in the search path of the system */
+class DllExport PluginLoader
+{
+public:
+	/* nullptr to forget it */
+	static void setPath(const char *path);
+
+	/* nullptr if the plugin can't be found, or was built with another ABI */
+	static const HMD_Plugin *load(const char *name);
+
+	static bool isLoaded(const char *name);
+
+	/* shut the runtime of the plugin down if none of its backends holds it, the next backend
+	 * initializes it again. True if it is not initialized anymore, or the plugin isn't loaded */
+	static bool shutdownIdle(const char *name);
+};
+
+#endif /* __PLUGIN_LOADER_H__ */
@@ -0,0 +1,229 @@
+#ifndef __POSE_H__
+#define __POSE_H__
+
+#include <math.h>
+
+/* Tracking sample, as returned by the backend for a single frame.
+ * Orientations are stored as (w, x, y, z), positions in meters */
+struct PoseSample
+{
+	double time;
+	unsigned int frame;
+	unsigned int status;
+
+	float head_orientation[4];
+	float head_position[3];
+
+	float orientation[2][4];
+	float position[2][3];
+};
+
+/* Yaw, pitch and roll (rotation order Y, X, Z), same convention as OVR::Quatf::GetYawPitchRoll */
+static inline void poseYawPitchRoll(const float *q, float *r_yaw, float *r_pitch, float *r_roll)
+{
+	const float w = q[0], x = q[1], y = q[2], z = q[3];
+	const float ww = w * w, xx = x * x, yy = y * y, zz = z * z;
+	const float singularity_radius = 1e-7f;
+
+	const float s2 = 2.0f * (w * x - y * z);
+
+	if (s2 < -1.0f + singularity_radius) {
+		/* south pole singularity */
+		*r_yaw = 0.0f;
+		*r_pitch = -1.5707963267948966f;
+		*r_roll = atan2f(2.0f * (w * z - x * y), ww + xx - yy - zz);
+	}
+	else if (s2 > 1.0f - singularity_radius) {
+		/* north pole singularity */
+		*r_yaw = 0.0f;
+		*r_pitch = 1.5707963267948966f;
+		*r_roll = atan2f(2.0f * (w * z - x * y), ww + xx - yy - zz);
+	}
+	else {
+		*r_yaw = atan2f(2.0f * (w * y + x * z), ww - xx - yy + zz);
+		*r_pitch = asinf(s2);
+		*r_roll = atan2f(2.0f * (w * z + x * y), ww - xx + yy - zz);
+	}
+}
+
+/* Column-major view matrix for an eye with orientation q and position p.
+ * Equivalent to Matrix4f::LookAtRH/LookAtLH(p, p + forward, up) */
+static inline void poseViewMatrix(const float *q, const float *p, const bool is_right_hand, float *r_matrix)
+{
+	const float w = q[0], x = q[1], y = q[2], z = q[3];
+
+	/* LookAt normalizes its axes, scaling by 2 / |q|^2 does the same for the quaternion */
+	const float norm = w * w + x * x + y * y + z * z;
+	const float s = norm > 0.0f ? 2.0f / norm : 0.0f;
+
+	/* rows of the view rotation are the columns of the orientation matrix */
+	float axis[3][3] = {
+		{ 1.0f - s * (y * y + z * z), s * (x * y + w * z), s * (x * z - w * y) },
+		{ s * (x * y - w * z), 1.0f - s * (x * x + z * z), s * (y * z + w * x) },
+		{ s * (x * z + w * y), s * (y * z - w * x), 1.0f - s * (x * x + y * y) },
+	};
+
+	if (!is_right_hand) {
+		/* left-handed looks down +z, flipping the side and forward axes */
+		for (int i = 0; i < 3; i++) {
+			axis[0][i] = -axis[0][i];
+			axis[2][i] = -axis[2][i];
+		}
+	}
+
+	for (int row = 0; row < 3; row++) {
+		r_matrix[0 + row] = axis[row][0];
+		r_matrix[4 + row] = axis[row][1];
+		r_matrix[8 + row] = axis[row][2];
+		r_matrix[12 + row] = -(axis[row][0] * p[0] + axis[row][1] * p[1] + axis[row][2] * p[2]);
+	}
+
+	r_matrix[3] = 0.0f;
+	r_matrix[7] = 0.0f;
+	r_matrix[11] = 0.0f;
+	r_matrix[15] = 1.0f;
+}
+
+/* Spherical linear interpolation between the unit quaternions q0 and q1 (w, x, y, z) */
+static inline void poseSlerp(const float *q0, const float *q1, const float t, float *r_q)
+{
+	float cos_theta = q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+	float sign = 1.0f;
+
+	/* take the shortest path */
+	if (cos_theta < 0.0f) {
+		cos_theta = -cos_theta;
+		sign = -1.0f;
+	}
+
+	float k0, k1;
+
+	if (cos_theta > 0.9995f) {
+		/* nearly parallel, fallback to a normalized lerp */
+		k0 = 1.0f - t;
+		k1 = t;
+	}
+	else {
+		const float theta = acosf(cos_theta);
+		const float sin_theta = sinf(theta);
+		k0 = sinf((1.0f - t) * theta) / sin_theta;
+		k1 = sinf(t * theta) / sin_theta;
+	}
+
+	k1 *= sign;
+
+	float len = 0.0f;
+	for (int i = 0; i < 4; i++) {
+		r_q[i] = k0 * q0[i] + k1 * q1[i];
+		len += r_q[i] * r_q[i];
+	}
+
+	len = sqrtf(len);
+	for (int i = 0; i < 4; i++) {
+		r_q[i] /= len;
+	}
+}
+
+static inline void poseLerp(const float *p0, const float *p1, const float t, float *r_p)
+{
+	for (int i = 0; i < 3; i++) {
+		r_p[i] = p0[i] + (p1[i] - p0[i]) * t;
+	}
+}
+
+/* Quaternion product a * b */
+static inline void poseMultiply(const float *a, const float *b, float *r_q)
+{
+	const float w = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+	const float x = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+	const float y = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+	const float z = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+
+	r_q[0] = w;
+	r_q[1] = x;
+	r_q[2] = y;
+	r_q[3] = z;
+}
+
+/* Rotate the vector v by the unit quaternion q */
+static inline void poseRotate(const float *q, const float *v, float *r_v)
+{
+	const float w = q[0], x = q[1], y = q[2], z = q[3];
+
+	/* t = 2 * cross(q.xyz, v), v' = v + w * t + cross(q.xyz, t) */
+	const float tx = 2.0f * (y * v[2] - z * v[1]);
+	const float ty = 2.0f * (z * v[0] - x * v[2]);
+	const float tz = 2.0f * (x * v[1] - y * v[0]);
+
+	r_v[0] = v[0] + w * tx + (y * tz - z * ty);
+	r_v[1] = v[1] + w * ty + (z * tx - x * tz);
+	r_v[2] = v[2] + w * tz + (x * ty - y * tx);
+}
+
+/* Angular velocity (world space, rad/s) rotating q0 into q1 in dt seconds */
+static inline void poseAngularVelocity(const float *q0, const float *q1, const float dt, float *r_omega)
+{
+	const float q0_inv[4] = { q0[0], -q0[1], -q0[2], -q0[3] };
+	float delta[4];
+
+	poseMultiply(q1, q0_inv, delta);
+
+	/* take the shortest path */
+	if (delta[0] < 0.0f) {
+		for (int i = 0; i < 4; i++) {
+			delta[i] = -delta[i];
+		}
+	}
+
+	const float sin_half = sqrtf(delta[1] * delta[1] + delta[2] * delta[2] + delta[3] * delta[3]);
+
+	if (sin_half < 1e-8f || dt <= 0.0f) {
+		r_omega[0] = r_omega[1] = r_omega[2] = 0.0f;
+		return;
+	}
+
+	const float angle = 2.0f * atan2f(sin_half, delta[0]);
+	const float k = angle / (sin_half * dt);
+
+	r_omega[0] = delta[1] * k;
+	r_omega[1] = delta[2] * k;
+	r_omega[2] = delta[3] * k;
+}
+
+/* Rotate q by the angular velocity omega (world space, rad/s) during dt seconds */
+static inline void poseIntegrate(const float *q, const float *omega, const float dt, float *r_q)
+{
+	const float speed = sqrtf(omega[0] * omega[0] + omega[1] * omega[1] + omega[2] * omega[2]);
+
+	if (speed < 1e-8f) {
+		r_q[0] = q[0]; r_q[1] = q[1]; r_q[2] = q[2]; r_q[3] = q[3];
+		return;
+	}
+
+	const float half_angle = 0.5f * speed * dt;
+	const float k = sinf(half_angle) / speed;
+	const float delta[4] = { cosf(half_angle), omega[0] * k, omega[1] * k, omega[2] * k };
+
+	poseMultiply(delta, q, r_q);
+}
+
+/* Interpolate head and eye poses between the samples a and b */
+static inline void poseInterpolate(const PoseSample &a, const PoseSample &b, const double time, PoseSample *r_sample)
+{
+	const double span = b.time - a.time;
+	const float t = span > 0.0 ? (float)((time - a.time) / span) : 0.0f;
+
+	r_sample->time = time;
+	r_sample->frame = t < 0.5f ? a.frame : b.frame;
+	r_sample->status = a.status & b.status;
+
+	poseSlerp(a.head_orientation, b.head_orientation, t, r_sample->head_orientation);
+	poseLerp(a.head_position, b.head_position, t, r_sample->head_position);
+
+	for (int eye = 0; eye < 2; eye++) {
+		poseSlerp(a.orientation[eye], b.orientation[eye], t, r_sample->orientation[eye]);
+		poseLerp(a.position[eye], b.position[eye], t, r_sample->position[eye]);
+	}
+}
+
+#endif /* __POSE_H__ */
@@ -0,0 +1,81 @@
+#ifndef __POSE_HISTORY_H__
+#define __POSE_HISTORY_H__
+
+#include "Pose.h"
+#include "PoseRing.h"
+
+/* Fixed-capacity history of the tracked samples, ordered by time.
+ * Written by the thread sampling the tracking, it can be queried from any thread */
+class PoseHistory
+{
+public:
+	enum { CAPACITY = 128 };
+
+	/* only to be called from the sampling thread, samples are expected in increasing time */
+	void add(const PoseSample &sample)
+	{
+		this->m_ring.publish(sample);
+	}
+
+	unsigned long long count() const
+	{
+		return this->m_ring.count();
+	}
+
+	bool getLatest(PoseSample *r_sample) const
+	{
+		return this->m_ring.readLatest(r_sample);
+	}
+
+	/* copy up to count of the newest samples, newest first, return how many were copied */
+	unsigned int getRecent(PoseSample *r_samples, const unsigned int count) const
+	{
+		const unsigned long long total = this->m_ring.count();
+		unsigned int i = 0;
+
+		for (; i < count && i < total; i++) {
+			if (!this->m_ring.read(total - 1 - i, &r_samples[i])) {
+				break;
+			}
+		}
+		return i;
+	}
+
+	/* pose at the given time, interpolated between the samples around it.
+	 * Times outside the history are clamped to the oldest or the newest sample */
+	bool getPoseAt(const double time, PoseSample *r_sample) const
+	{
+		unsigned long long index = this->m_ring.count();
+		PoseSample after, before;
+
+		/* walk back from the newest sample, recent poses are the common query */
+		if (index == 0 || !this->m_ring.read(--index, &before)) {
+			return false;
+		}
+
+		if (before.time <= time) {
+			*r_sample = before;
+			r_sample->time = time;
+			return true;
+		}
+
+		do {
+			after = before;
+
+			if (index == 0 || !this->m_ring.read(--index, &before)) {
+				/* reached the oldest sample */
+				*r_sample = after;
+				r_sample->time = time;
+				return true;
+			}
+		} while (before.time > time);
+
+		poseInterpolate(before, after, time, r_sample);
+		return true;
+	}
+
+private:
+	PoseRing<PoseSample, CAPACITY> m_ring;
+};
+
+#endif /* __POSE_HISTORY_H__ */
@@ -0,0 +1,92 @@
+#ifndef __POSE_RING_H__
+#define __POSE_RING_H__
+
+#include <atomic>
+
+/* Single-writer, multiple-reader ring buffer, each slot protected by a sequence lock.
+ * The writer never waits for the readers. A reader only retries when the slot it is
+ * copying gets overwritten meanwhile, which requires the writer to lap the whole ring. */
+template <typename T, unsigned int N>
+class PoseRing
+{
+public:
+	PoseRing() :
+		m_count(0)
+	{
+		for (unsigned int i = 0; i < N; i++) {
+			m_slots[i].seq.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/* only to be called from the writer thread */
+	void publish(const T &value)
+	{
+		const unsigned long long count = this->m_count.load(std::memory_order_relaxed);
+		Slot &slot = this->m_slots[count % N];
+
+		const unsigned int seq = slot.seq.load(std::memory_order_relaxed);
+		slot.seq.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.value = value;
+
+		slot.seq.store(seq + 2, std::memory_order_release);
+		this->m_count.store(count + 1, std::memory_order_release);
+	}
+
+	/* copy the most recent value, return false if nothing was published yet */
+	bool readLatest(T *r_value) const
+	{
+		for (;;) {
+			const unsigned long long count = this->m_count.load(std::memory_order_acquire);
+
+			if (count == 0) {
+				return false;
+			}
+
+			if (this->read(count - 1, r_value)) {
+				return true;
+			}
+		}
+	}
+
+	/* copy the value published at the given index, return false if it is not available (anymore) */
+	bool read(const unsigned long long index, T *r_value) const
+	{
+		const Slot &slot = this->m_slots[index % N];
+
+		/* sequence of the slot once the value at index is written, before it gets overwritten */
+		const unsigned int seq_expected = (unsigned int)(2 * (index / N + 1));
+
+		if (index >= this->m_count.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		if (slot.seq.load(std::memory_order_acquire) != seq_expected) {
+			return false;
+		}
+
+		*r_value = slot.value;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.seq.load(std::memory_order_relaxed) == seq_expected;
+	}
+
+	/* number of values published so far */
+	unsigned long long count() const
+	{
+		return this->m_count.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<unsigned int> seq;
+		T value;
+	};
+
+	Slot m_slots[N];
+	std::atomic<unsigned long long> m_count;
+};
+
+#endif /* __POSE_RING_H__ */
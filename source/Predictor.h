@@ -0,0 +1,187 @@
+#ifndef __PREDICTOR_H__
+#define __PREDICTOR_H__
+
+#include "HMD_Bridge_API.h"
+#include "Pose.h"
+#include "PoseHistory.h"
+
+#include <string.h>
+
+/* Bridge-side pose prediction, extrapolating the newest samples of the history
+ * horizon seconds ahead. For backends without native prediction */
+class Predictor
+{
+public:
+	Predictor() :
+		m_type(HMD_PREDICTOR_NONE),
+		m_horizon(0.0)
+	{}
+
+	void set(const eHMDPredictor type, const double horizon)
+	{
+		this->m_type = type;
+		this->m_horizon = horizon;
+	}
+
+	eHMDPredictor getType() const { return this->m_type; }
+	double getHorizon() const { return this->m_horizon; }
+
+	/* return false if there is not enough history for the model */
+	bool predict(const PoseHistory &history, PoseSample *r_sample) const
+	{
+		/* newest first */
+		PoseSample samples[3];
+
+		switch (this->m_type) {
+			case HMD_PREDICTOR_CONSTANT_VELOCITY:
+				if (history.getRecent(samples, 2) < 2)
+					return false;
+				Predictor::constantVelocity(samples[1], samples[0], this->m_horizon, r_sample);
+				return true;
+
+			case HMD_PREDICTOR_CONSTANT_ACCELERATION:
+				if (history.getRecent(samples, 3) < 3)
+					return false;
+				Predictor::constantAcceleration(samples[2], samples[1], samples[0], this->m_horizon, r_sample);
+				return true;
+
+			case HMD_PREDICTOR_ANGULAR_VELOCITY:
+				if (history.getRecent(samples, 2) < 2)
+					return false;
+				Predictor::angularVelocity(samples[1], samples[0], this->m_horizon, r_sample);
+				return true;
+
+			case HMD_PREDICTOR_NONE:
+			default:
+				return false;
+		}
+	}
+
+	/* linear extrapolation of positions and (normalized) quaternion components, cheapest model */
+	static void constantVelocity(const PoseSample &s0, const PoseSample &s1, const double horizon, PoseSample *r_sample)
+	{
+		const float dt = (float)(s1.time - s0.time);
+		const float k = dt > 0.0f ? (float)horizon / dt : 0.0f;
+
+		Predictor::begin(s1, horizon, r_sample);
+
+		Predictor::extrapolateQuaternion(s0.head_orientation, s1.head_orientation, k, r_sample->head_orientation);
+		Predictor::extrapolatePosition(s0.head_position, s1.head_position, k, r_sample->head_position);
+
+		for (int eye = 0; eye < 2; eye++) {
+			Predictor::extrapolateQuaternion(s0.orientation[eye], s1.orientation[eye], k, r_sample->orientation[eye]);
+			Predictor::extrapolatePosition(s0.position[eye], s1.position[eye], k, r_sample->position[eye]);
+		}
+	}
+
+	/* quadratic extrapolation of positions, angular velocity and acceleration integration of orientations */
+	static void constantAcceleration(const PoseSample &s0, const PoseSample &s1, const PoseSample &s2, const double horizon, PoseSample *r_sample)
+	{
+		const float dt0 = (float)(s1.time - s0.time);
+		const float dt1 = (float)(s2.time - s1.time);
+		const float h = (float)horizon;
+
+		Predictor::begin(s2, horizon, r_sample);
+
+		Predictor::accelerateQuaternion(s0.head_orientation, s1.head_orientation, s2.head_orientation, dt0, dt1, h, r_sample->head_orientation);
+		Predictor::acceleratePosition(s0.head_position, s1.head_position, s2.head_position, dt0, dt1, h, r_sample->head_position);
+
+		for (int eye = 0; eye < 2; eye++) {
+			Predictor::accelerateQuaternion(s0.orientation[eye], s1.orientation[eye], s2.orientation[eye], dt0, dt1, h, r_sample->orientation[eye]);
+			Predictor::acceleratePosition(s0.position[eye], s1.position[eye], s2.position[eye], dt0, dt1, h, r_sample->position[eye]);
+		}
+	}
+
+	/* integration of the angular velocity on the rotation group, linear extrapolation of positions */
+	static void angularVelocity(const PoseSample &s0, const PoseSample &s1, const double horizon, PoseSample *r_sample)
+	{
+		const float dt = (float)(s1.time - s0.time);
+		const float k = dt > 0.0f ? (float)horizon / dt : 0.0f;
+		float omega[3];
+
+		Predictor::begin(s1, horizon, r_sample);
+
+		poseAngularVelocity(s0.head_orientation, s1.head_orientation, dt, omega);
+		poseIntegrate(s1.head_orientation, omega, (float)horizon, r_sample->head_orientation);
+		Predictor::extrapolatePosition(s0.head_position, s1.head_position, k, r_sample->head_position);
+
+		for (int eye = 0; eye < 2; eye++) {
+			poseAngularVelocity(s0.orientation[eye], s1.orientation[eye], dt, omega);
+			poseIntegrate(s1.orientation[eye], omega, (float)horizon, r_sample->orientation[eye]);
+			Predictor::extrapolatePosition(s0.position[eye], s1.position[eye], k, r_sample->position[eye]);
+		}
+	}
+
+private:
+	static void begin(const PoseSample &latest, const double horizon, PoseSample *r_sample)
+	{
+		r_sample->time = latest.time + horizon;
+		r_sample->frame = latest.frame;
+		r_sample->status = latest.status;
+	}
+
+	/* p1 + (p1 - p0) * k */
+	static void extrapolatePosition(const float *p0, const float *p1, const float k, float *r_p)
+	{
+		for (int i = 0; i < 3; i++) {
+			r_p[i] = p1[i] + (p1[i] - p0[i]) * k;
+		}
+	}
+
+	static void extrapolateQuaternion(const float *q0, const float *q1, const float k, float *r_q)
+	{
+		const float dot = q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+		const float sign = dot < 0.0f ? -1.0f : 1.0f;
+		float len = 0.0f;
+
+		for (int i = 0; i < 4; i++) {
+			r_q[i] = q1[i] + (q1[i] - sign * q0[i]) * k;
+			len += r_q[i] * r_q[i];
+		}
+
+		len = sqrtf(len);
+		for (int i = 0; i < 4; i++) {
+			r_q[i] /= len;
+		}
+	}
+
+	static void acceleratePosition(const float *p0, const float *p1, const float *p2, const float dt0, const float dt1, const float h, float *r_p)
+	{
+		if (dt0 <= 0.0f || dt1 <= 0.0f) {
+			memcpy(r_p, p2, sizeof(float[3]));
+			return;
+		}
+
+		for (int i = 0; i < 3; i++) {
+			/* the finite differences are the velocities at the middle of each interval */
+			const float v0 = (p1[i] - p0[i]) / dt0;
+			const float v1 = (p2[i] - p1[i]) / dt1;
+			const float a = (v1 - v0) / (0.5f * (dt0 + dt1));
+			const float v = v1 + a * 0.5f * dt1;
+
+			r_p[i] = p2[i] + v * h + 0.5f * a * h * h;
+		}
+	}
+
+	static void accelerateQuaternion(const float *q0, const float *q1, const float *q2, const float dt0, const float dt1, const float h, float *r_q)
+	{
+		float omega0[3], omega1[3], omega[3];
+
+		poseAngularVelocity(q0, q1, dt0, omega0);
+		poseAngularVelocity(q1, q2, dt1, omega1);
+
+		/* average angular velocity over the horizon */
+		const float k = (dt0 + dt1) > 0.0f ? (0.5f * (dt1 + h)) / (0.5f * (dt0 + dt1)) : 0.0f;
+
+		for (int i = 0; i < 3; i++) {
+			omega[i] = omega1[i] + (omega1[i] - omega0[i]) * k;
+		}
+
+		poseIntegrate(q2, omega, h, r_q);
+	}
+
+	eHMDPredictor m_type;
+	double m_horizon;
+};
+
+#endif /* __PREDICTOR_H__ */
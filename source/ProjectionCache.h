@@ -0,0 +1,126 @@
+#ifndef __PROJECTION_CACHE_H__
+#define __PROJECTION_CACHE_H__
+
+#include <stddef.h>
+
+/* Column-major projection matrix for a field of view given as the tangents of its
+ * up, down, left and right half angles, same as ovrMatrix4f_Projection */
+static inline void fovProjectionMatrix(const float *fov, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+{
+	const float up = fov[0], down = fov[1], left = fov[2], right = fov[3];
+	const float handedness = is_right_hand ? -1.0f : 1.0f;
+
+	const float scale_x = 2.0f / (left + right);
+	const float offset_x = (left - right) * scale_x * 0.5f;
+	const float scale_y = 2.0f / (up + down);
+	const float offset_y = (up - down) * scale_y * 0.5f;
+
+	for (int i = 0; i < 16; i++) {
+		r_matrix[i] = 0.0f;
+	}
+
+	r_matrix[0] = scale_x;
+	r_matrix[8] = offset_x * handedness;
+	r_matrix[5] = scale_y;
+	r_matrix[9] = -offset_y * handedness;
+
+	if (is_opengl) {
+		/* clip range is [-w, w] */
+		r_matrix[10] = -handedness * (farz + nearz) / (nearz - farz);
+		r_matrix[14] = 2.0f * farz * nearz / (nearz - farz);
+	}
+	else {
+		r_matrix[10] = -handedness * farz / (nearz - farz);
+		r_matrix[14] = farz * nearz / (nearz - farz);
+	}
+
+	r_matrix[11] = handedness;
+}
+
+/* Projection matrices of both eyes for the last few clipping setups.
+ * An entry is keyed on (nearz, farz, is_opengl, is_right_hand), each eye is computed the first
+ * time it is requested. All the entries are dropped when the field of view changes */
+class ProjectionCache
+{
+public:
+	enum { SIZE = 4 };
+
+	ProjectionCache() :
+		m_next(0)
+	{
+		this->invalidate();
+	}
+
+	/* the field of view or the render description changed */
+	void invalidate()
+	{
+		for (int i = 0; i < SIZE; i++) {
+			this->m_entries[i].valid = 0;
+			this->m_entries[i].is_used = false;
+		}
+		this->m_next = 0;
+	}
+
+	/* point r_matrix to the cached matrix of the eye,
+	 * return true if it needs to be computed, and mark it as valid */
+	bool acquire(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float **r_matrix)
+	{
+		Entry *entry = this->lookup(nearz, farz, is_opengl, is_right_hand);
+
+		if (entry == NULL) {
+			/* replace the oldest setup */
+			entry = &this->m_entries[this->m_next];
+			this->m_next = (this->m_next + 1) % SIZE;
+
+			entry->nearz = nearz;
+			entry->farz = farz;
+			entry->is_opengl = is_opengl;
+			entry->is_right_hand = is_right_hand;
+			entry->is_used = true;
+			entry->valid = 0;
+		}
+
+		*r_matrix = entry->matrix[eye];
+
+		if (entry->valid & (1u << eye)) {
+			return false;
+		}
+
+		entry->valid |= (1u << eye);
+		return true;
+	}
+
+private:
+	struct Entry
+	{
+		float nearz;
+		float farz;
+		bool is_opengl;
+		bool is_right_hand;
+		bool is_used;
+		unsigned int valid; /* bit per eye */
+		float matrix[2][16];
+	};
+
+	Entry *lookup(const float nearz, const float farz, const bool is_opengl, const bool is_right_hand)
+	{
+		for (int i = 0; i < SIZE; i++) {
+			Entry *entry = &this->m_entries[i];
+
+			if (entry->is_used &&
+			    entry->nearz == nearz &&
+			    entry->farz == farz &&
+			    entry->is_opengl == is_opengl &&
+			    entry->is_right_hand == is_right_hand)
+			{
+				return entry;
+			}
+		}
+		return NULL;
+	}
+
+	Entry m_entries[SIZE];
+	int m_next;
+};
+
+#endif /* __PROJECTION_CACHE_H__ */
@@ -0,0 +1,156 @@
+#include "Replay.h"
+#include "Simulated.h"
+
+ReplayImpl::ReplayImpl(const bool is_realtime) :BackendImpl()
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+
+	for (int eye = 0; eye < 2; eye++) {
+		this->m_width[eye] = config.width[eye];
+		this->m_height[eye] = config.height[eye];
+		memcpy(this->m_fov[eye], config.fov[eye], sizeof(this->m_fov[eye]));
+	}
+
+	this->m_is_realtime = is_realtime;
+	this->m_index = 0;
+	this->m_offset = 0.0;
+}
+
+bool ReplayImpl::open(const char *path)
+{
+	if (!this->m_reader.open(path)) {
+		return false;
+	}
+
+	/* start from the beginning of the recording */
+	this->seek(this->m_reader.getCount() ? this->m_reader.getRecord(0).time : 0.0);
+	return true;
+}
+
+bool ReplayImpl::setup(const unsigned int, const unsigned int)
+{
+	/* nothing is displayed */
+	return true;
+}
+
+double ReplayImpl::getWallTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double ReplayImpl::getTime()
+{
+	if (this->m_is_realtime) {
+		return getWallTime() + this->m_offset;
+	}
+
+	/* time of the last returned sample */
+	const unsigned long long count = this->m_reader.getCount();
+	const unsigned long long index = this->m_index;
+
+	if (count == 0) {
+		return 0.0;
+	}
+	return this->m_reader.getRecord(index ? (index < count ? index : count) - 1 : 0).time;
+}
+
+bool ReplayImpl::sampleTracking(const unsigned int frame, PoseSample *r_sample)
+{
+	const unsigned long long count = this->m_reader.getCount();
+	const unsigned long long index = this->m_index;
+	unsigned long long next = index + 1;
+
+	if (this->m_is_realtime) {
+		/* every sample recorded until now is passed, the latest one is returned */
+		const double time = this->getTime();
+
+		next = index;
+		while (next < count && this->m_reader.getRecord(next).time <= time) {
+			next++;
+		}
+
+		if (next == 0) {
+			/* before the first sample */
+			next = 1;
+		}
+		else if (next == index && index == count) {
+			/* the last sample was already returned */
+			next = count + 1;
+		}
+	}
+
+	if (next > count) {
+		/* end of the recording */
+		memset(r_sample, 0, sizeof(PoseSample));
+		r_sample->frame = frame;
+		return false;
+	}
+
+	traceRecordToSample(this->m_reader.getRecord(next - 1), r_sample);
+	r_sample->frame = frame;
+
+	this->m_index = next;
+	return r_sample->status != 0;
+}
+
+bool ReplayImpl::frameReady()
+{
+	const unsigned long long index = this->m_index;
+
+	if (this->m_is_realtime && index < this->m_reader.getCount()) {
+		/* the recording paces the frames, wait until its next sample is due */
+		const double wait = this->m_reader.getRecord(index).time - this->getTime();
+
+		if (wait > 0.0) {
+			std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+		}
+	}
+	return true;
+}
+
+bool ReplayImpl::reCenter()
+{
+	/* the poses are the recorded ones */
+	return false;
+}
+
+void ReplayImpl::computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+{
+	fovProjectionMatrix(this->m_fov[eye], nearz, farz, is_opengl, is_right_hand, r_matrix);
+}
+
+bool ReplayImpl::seek(const double time)
+{
+	/* the samples are recorded in order */
+	unsigned long long first = 0, last = this->m_reader.getCount();
+
+	while (first < last) {
+		const unsigned long long middle = first + (last - first) / 2;
+
+		if (this->m_reader.getRecord(middle).time < time) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+
+	this->m_index = first;
+	this->m_offset = time - getWallTime();
+	return first < this->m_reader.getCount();
+}
+
+Replay::Replay(const char *path, const bool is_realtime) :
+	m_is_realtime(is_realtime)
+{
+	this->initializeImplementation();
+
+	if (!static_cast<ReplayImpl *>(this->m_me)->open(path)) {
+		throw "Trace could not be opened";
+	}
+}
+
+void Replay::initializeImplementation() {
+	m_me = new ReplayImpl(this->m_is_realtime);
+}
@@ -0,0 +1,74 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include "Backend.h"
+#include "Trace.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#if !defined(DllExport)
+#define DllExport   __declspec( dllexport )
+#endif
+
+#else
+#define DllExport
+#endif
+
+/* Device playing back a recorded trace (see Trace.h).
+ * In realtime the samples are returned when their recorded time is reached, and frameReady
+ * waits for the next sample to be due. Otherwise every tracking query returns the next
+ * recorded sample, so the same trace always produces the same frames.
+ * The trace has no display description, the resolution and field of view are the simulated ones */
+class DllExport ReplayImpl : public BackendImpl
+{
+public:
+	ReplayImpl(const bool is_realtime);
+
+	/* map the trace, return false if it is not a valid trace file */
+	bool open(const char *path);
+
+	bool setup(const unsigned int color_texture_left, const unsigned int color_texture_right);
+
+	bool sampleTracking(const unsigned int frame, PoseSample *r_sample);
+
+	double getTime();
+
+	bool frameReady(void);
+
+	bool reCenter(void);
+
+	void computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
+
+	/* continue from the first sample recorded at or after time */
+	bool seek(const double time);
+
+	unsigned long long getSampleCount() const { return this->m_reader.getCount(); }
+
+	/* index of the next sample to be returned */
+	unsigned long long getPosition() const { return this->m_index; }
+
+private:
+	static double getWallTime();
+
+	TraceReader m_reader;
+	bool m_is_realtime;
+	float m_fov[2][4];
+
+	std::atomic<unsigned long long> m_index;
+	std::atomic<double> m_offset; /* from the wall clock to the trace time, in realtime */
+};
+
+class DllExport Replay : public Backend
+{
+public:
+	/* throws if the trace can't be opened, like the hardware backends do when there is no device */
+	Replay(const char *path, const bool is_realtime);
+
+protected:
+	virtual void initializeImplementation();
+
+private:
+	bool m_is_realtime;
+};
+
+#endif /* __REPLAY_H__ */
@@ -0,0 +1,96 @@
+#ifndef __RESOLUTION_GOVERNOR_H__
+#define __RESOLUTION_GOVERNOR_H__
+
+#include <math.h>
+
+#define RESOLUTION_FILTER 0.25 /* weight of the newest frame time */
+#define RESOLUTION_MAX_DROP 0.25f /* share of the density lost in one frame at most */
+#define RESOLUTION_HYSTERESIS 0.05f /* room needed before rising */
+#define RESOLUTION_RISE_STEP 0.02f /* density gained in one frame at most */
+
+/* Dynamic resolution: the pixel density of the eyes that keeps the frame time within the budget.
+ *
+ * The cost of a frame is assumed proportional to its pixels, the square of the density.
+ * The filtered frame time is scaled with the density it was measured at, so a change is not
+ * measured again before the frames rendered with it come back. The density drops at once when the
+ * frame is over budget, and rises in small steps once there is room for more, so a busy scene does
+ * not flicker between two resolutions */
+class ResolutionGovernor
+{
+public:
+	ResolutionGovernor() :
+		m_min_scale(0.5f),
+		m_max_scale(1.0f),
+		m_utilization(0.9f),
+		m_scale(1.0f),
+		m_time(-1.0)
+	{}
+
+	/* densities relative to the recommended one of the device, the utilization is the share of the
+	 * frame time the frame may take */
+	void configure(const float min_scale, const float max_scale, const float utilization)
+	{
+		this->m_max_scale = max_scale > 0.0f ? max_scale : 1.0f;
+		this->m_min_scale = (min_scale > 0.0f && min_scale < this->m_max_scale) ? min_scale : this->m_max_scale;
+		this->m_utilization = (utilization > 0.0f && utilization <= 1.0f) ? utilization : 0.9f;
+		this->reset();
+	}
+
+	/* back to the highest density, and forget the frame times */
+	void reset()
+	{
+		this->m_scale = this->m_max_scale;
+		this->m_time = -1.0;
+	}
+
+	/* density for the next frame, after one took frame_time seconds at the current density */
+	float update(const double frame_time, const double period)
+	{
+		if (period <= 0.0 || frame_time <= 0.0) {
+			return this->m_scale;
+		}
+
+		if (this->m_time < 0.0 || frame_time > period) {
+			/* a missed frame is not averaged out */
+			this->m_time = frame_time;
+		}
+		else {
+			this->m_time += RESOLUTION_FILTER * (frame_time - this->m_time);
+		}
+
+		const double budget = this->m_utilization * period;
+		const float ideal = this->m_scale * (float)sqrt(budget / this->m_time);
+		float scale = this->m_scale;
+
+		if (ideal < this->m_scale) {
+			scale = fmaxf(ideal, this->m_scale * (1.0f - RESOLUTION_MAX_DROP));
+		}
+		else if (ideal > this->m_scale * (1.0f + RESOLUTION_HYSTERESIS)) {
+			scale = fminf(ideal, this->m_scale + RESOLUTION_RISE_STEP);
+		}
+
+		scale = fminf(fmaxf(scale, this->m_min_scale), this->m_max_scale);
+
+		/* expected time of the frames at the new density */
+		this->m_time *= (scale * scale) / (this->m_scale * this->m_scale);
+		this->m_scale = scale;
+		return scale;
+	}
+
+	float getScale() const { return this->m_scale; }
+	float getMinScale() const { return this->m_min_scale; }
+	float getMaxScale() const { return this->m_max_scale; }
+
+	/* share of the highest density, for the viewports in textures allocated at the highest one */
+	float getFraction() const { return this->m_scale / this->m_max_scale; }
+
+private:
+	float m_min_scale;
+	float m_max_scale;
+	float m_utilization;
+
+	float m_scale;
+	double m_time; /* filtered frame time, at the current density. Negative before the first frame */
+};
+
+#endif /* __RESOLUTION_GOVERNOR_H__ */
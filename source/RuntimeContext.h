@@ -0,0 +1,109 @@
+#ifndef __RUNTIME_CONTEXT_H__
+#define __RUNTIME_CONTEXT_H__
+
+#include <mutex>
+
+/* the initialization of a device runtime, e.g. ovr_Initialize and ovr_Shutdown */
+struct RuntimeFunctions
+{
+	bool (*initialize)(void);
+	void (*shutdown)(void);
+};
+
+/* Runtime of a device SDK shared by all the sessions of the process.
+ *
+ * Every session holds a reference. The runtime is initialized by the first one, and stays
+ * initialized once the last is released, so creating and deleting sessions (as the Python wrapper
+ * does at every reload) doesn't initialize it again. It is shut down by shutdownIdle (for a plugin,
+ * HMD_pluginShutdownIdle), or when the context is destroyed with the library holding it, at the end
+ * of the process since the plugins are never unloaded. A failed initialization is tried again by
+ * the next session */
+class RuntimeContext
+{
+public:
+	RuntimeContext(const RuntimeFunctions &functions) :
+		m_functions(functions),
+		m_references(0),
+		m_initializations(0),
+		m_is_initialized(false)
+	{}
+
+	~RuntimeContext()
+	{
+		if (this->m_is_initialized) {
+			this->m_functions.shutdown();
+		}
+	}
+
+	/* false if the runtime can't be initialized, there is no reference to release then */
+	bool acquire()
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+
+		if (!this->m_is_initialized) {
+			if (!this->m_functions.initialize()) {
+				return false;
+			}
+
+			this->m_is_initialized = true;
+			this->m_initializations++;
+		}
+
+		this->m_references++;
+		return true;
+	}
+
+	void release()
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+
+		if (this->m_references > 0) {
+			this->m_references--;
+		}
+	}
+
+	/* shut the runtime down if no session holds it, true if it is not initialized anymore */
+	bool shutdownIdle()
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+
+		if (this->m_references > 0) {
+			return false;
+		}
+
+		if (this->m_is_initialized) {
+			this->m_functions.shutdown();
+			this->m_is_initialized = false;
+		}
+		return true;
+	}
+
+	bool isInitialized()
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		return this->m_is_initialized;
+	}
+
+	unsigned int getReferences()
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		return this->m_references;
+	}
+
+	/* times the runtime was initialized */
+	unsigned int getInitializations()
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		return this->m_initializations;
+	}
+
+private:
+	RuntimeFunctions m_functions;
+
+	std::mutex m_mutex;
+	unsigned int m_references;
+	unsigned int m_initializations;
+	bool m_is_initialized;
+};
+
+#endif /* __RUNTIME_CONTEXT_H__ */
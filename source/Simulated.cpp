@@ -0,0 +1,525 @@
+#include "Simulated.h"
+
+#include <math.h>
+
+#define PI 3.14159265358979323846
+
+/* rotation around y, then x, then z, same convention as poseYawPitchRoll */
+static void quaternionFromYawPitchRoll(const float yaw, const float pitch, const float roll, float *r_q)
+{
+	const float qy[4] = { cosf(yaw * 0.5f), 0.0f, sinf(yaw * 0.5f), 0.0f };
+	const float qx[4] = { cosf(pitch * 0.5f), sinf(pitch * 0.5f), 0.0f, 0.0f };
+	const float qz[4] = { cosf(roll * 0.5f), 0.0f, 0.0f, sinf(roll * 0.5f) };
+	float qyx[4];
+
+	poseMultiply(qy, qx, qyx);
+	poseMultiply(qyx, qz, r_q);
+}
+
+/* uniform in [0, 1), only depends on the seed, the sensor tick and the channel */
+static double noiseUniform(const unsigned int seed, const unsigned long long tick, const unsigned int channel)
+{
+	/* splitmix64 */
+	unsigned long long z = tick * 0x9E3779B97F4A7C15ull + ((unsigned long long)seed << 32) + channel * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z = z ^ (z >> 31);
+
+	return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* approximately normal, zero mean and unit standard deviation */
+static float noiseNormal(const unsigned int seed, const unsigned long long tick, const unsigned int channel)
+{
+	double sum = 0.0;
+	for (unsigned int i = 0; i < 4; i++) {
+		sum += noiseUniform(seed, tick, channel * 4 + i);
+	}
+	return (float)((sum - 2.0) * sqrt(3.0));
+}
+
+SimulatedImpl::SimulatedImpl(const HMD_SimulatedConfig &config) :BackendImpl()
+{
+	HMD_SimulatedConfig defaults;
+	Simulated::getDefaultConfig(&defaults);
+
+	this->m_config = config;
+
+	if (this->m_config.sensor_rate <= 0.0f) {
+		this->m_config.sensor_rate = defaults.sensor_rate;
+	}
+
+	if (this->m_config.refresh_rate <= 0.0f) {
+		this->m_config.refresh_rate = defaults.refresh_rate;
+	}
+
+	for (int eye = 0; eye < 2; eye++) {
+		this->m_width[eye] = this->m_config.width[eye];
+		this->m_height[eye] = this->m_config.height[eye];
+	}
+
+	this->m_start = std::chrono::steady_clock::now();
+	this->m_vsync = 0;
+	this->m_recenter_yaw = 0.0f;
+	this->m_recenter_x = 0.0f;
+	this->m_recenter_z = 0.0f;
+	this->m_presented_frames = 0;
+	this->m_missed_frames = 0;
+	this->m_resolves = 0;
+
+	this->m_is_direct = false;
+	for (int eye = 0; eye < 2; eye++) {
+		this->m_is_acquired[eye] = false;
+		this->m_swap_chain_index[eye] = 0;
+	}
+
+	for (int layer = 0; layer < MAX_LAYERS; layer++) {
+		this->m_layer_index[layer] = 0;
+	}
+}
+
+bool SimulatedImpl::setup(const unsigned int color_texture_left, const unsigned int color_texture_right)
+{
+	/* nothing is displayed */
+	this->m_is_direct = (color_texture_left == 0 && color_texture_right == 0);
+	return true;
+}
+
+bool SimulatedImpl::setupSideBySide(const unsigned int color_texture)
+{
+	this->m_is_direct = (color_texture == 0);
+	this->m_is_side_by_side = true;
+	return true;
+}
+
+double SimulatedImpl::getTime()
+{
+	if (this->m_config.is_realtime) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - this->m_start).count();
+	}
+	return this->m_vsync / (double)this->m_config.refresh_rate;
+}
+
+bool SimulatedImpl::sampleTracking(const unsigned int frame, PoseSample *r_sample)
+{
+	/* latest sensor reading */
+	const unsigned long long tick = (unsigned long long)floor(this->getTime() * this->m_config.sensor_rate + 1e-6);
+	const double time = tick / (double)this->m_config.sensor_rate;
+
+	float orientation[4], position[3];
+	this->getMotion(time, orientation, position);
+
+	/* re-centered tracking origin */
+	const float recenter[4] = { cosf(-0.5f * this->m_recenter_yaw), 0.0f, sinf(-0.5f * this->m_recenter_yaw), 0.0f };
+	const float offset[3] = { position[0] - this->m_recenter_x, position[1], position[2] - this->m_recenter_z };
+
+	poseMultiply(recenter, orientation, r_sample->head_orientation);
+	poseRotate(recenter, offset, r_sample->head_position);
+
+	this->addNoise(tick, r_sample->head_orientation, r_sample->head_position);
+
+	for (int eye = 0; eye < 2; eye++) {
+		const float eye_offset[3] = { (eye ? 0.5f : -0.5f) * this->m_config.ipd, 0.0f, 0.0f };
+		float world_offset[3];
+
+		poseRotate(r_sample->head_orientation, eye_offset, world_offset);
+
+		memcpy(r_sample->orientation[eye], r_sample->head_orientation, sizeof(float[4]));
+		r_sample->position[eye][0] = r_sample->head_position[0] + world_offset[0];
+		r_sample->position[eye][1] = r_sample->head_position[1] + world_offset[1];
+		r_sample->position[eye][2] = r_sample->head_position[2] + world_offset[2];
+	}
+
+	r_sample->time = time;
+	r_sample->frame = frame;
+	r_sample->status = HMD_STATUS_ORIENTATION_TRACKED | HMD_STATUS_POSITION_TRACKED;
+	return true;
+}
+
+void SimulatedImpl::getMotion(const double time, float *r_orientation, float *r_position)
+{
+	const float t = (float)time;
+
+	switch (this->m_config.motion) {
+		case HMD_MOTION_LOOK_AROUND:
+		{
+			quaternionFromYawPitchRoll(
+				0.8f * sinf((float)(2.0 * PI * 0.2) * t),
+				0.35f * sinf((float)(2.0 * PI * 0.13) * t),
+				0.05f * sinf((float)(2.0 * PI * 0.31) * t),
+				r_orientation);
+
+			/* the eyes turn around the neck, a bit below and behind them */
+			const float neck[3] = { 0.0f, 0.1f, -0.1f };
+			float rotated[3];
+
+			poseRotate(r_orientation, neck, rotated);
+			r_position[0] = rotated[0] - neck[0];
+			r_position[1] = rotated[1] - neck[1];
+			r_position[2] = rotated[2] - neck[2];
+			break;
+		}
+		case HMD_MOTION_WALK:
+		{
+			/* 1 meter radius circle in 8 seconds, facing the walking direction */
+			const float radius = 1.0f;
+			const float angle = (float)(2.0 * PI / 8.0) * t;
+			const float bob = 0.02f * sinf((float)(2.0 * PI * 1.8) * t);
+
+			quaternionFromYawPitchRoll(angle - (float)(PI * 0.5), 0.0f, 0.0f, r_orientation);
+
+			r_position[0] = radius * sinf(angle);
+			r_position[1] = bob;
+			r_position[2] = radius * cosf(angle) - radius;
+			break;
+		}
+		case HMD_MOTION_STILL:
+		default:
+			r_orientation[0] = 1.0f;
+			r_orientation[1] = r_orientation[2] = r_orientation[3] = 0.0f;
+			r_position[0] = r_position[1] = r_position[2] = 0.0f;
+			break;
+	}
+}
+
+void SimulatedImpl::addNoise(const unsigned long long tick, float *r_orientation, float *r_position)
+{
+	const unsigned int seed = this->m_config.seed;
+
+	if (this->m_config.orientation_noise > 0.0f) {
+		const float omega[3] = {
+			this->m_config.orientation_noise * noiseNormal(seed, tick, 0),
+			this->m_config.orientation_noise * noiseNormal(seed, tick, 1),
+			this->m_config.orientation_noise * noiseNormal(seed, tick, 2),
+		};
+		const float orientation[4] = { r_orientation[0], r_orientation[1], r_orientation[2], r_orientation[3] };
+
+		/* small rotation of the noise angle */
+		poseIntegrate(orientation, omega, 1.0f, r_orientation);
+	}
+
+	if (this->m_config.position_noise > 0.0f) {
+		for (unsigned int i = 0; i < 3; i++) {
+			r_position[i] += this->m_config.position_noise * noiseNormal(seed, tick, 3 + i);
+		}
+	}
+}
+
+bool SimulatedImpl::frameReady()
+{
+	const double period = 1.0 / this->m_config.refresh_rate;
+
+	if (this->m_is_direct && this->m_samples > 1) {
+		/* resolved into the swap chains, and committed */
+		const int chains = this->m_is_side_by_side ? 1 : 2;
+
+		for (int chain = 0; chain < chains; chain++) {
+			this->m_swap_chain_index[chain] = (this->m_swap_chain_index[chain] + 1) % SWAP_CHAIN_LENGTH;
+			this->m_resolves++;
+		}
+	}
+
+	this->m_presented_frames++;
+
+	if (!this->m_config.is_realtime) {
+		/* the frame is always on time, and the clock jumps to its vsync */
+		this->m_vsync++;
+		return true;
+	}
+
+	/* the frame is displayed on the first vsync after its submission */
+	const unsigned long long vsync = (unsigned long long)floor(this->getTime() / period) + 1;
+	const unsigned long long last_vsync = this->m_vsync;
+
+	if (this->m_presented_frames > 1 && vsync > last_vsync + 1) {
+		/* the previous frame was repeated */
+		this->m_missed_frames += (unsigned int)(vsync - last_vsync - 1);
+	}
+
+	this->m_vsync = vsync;
+	std::this_thread::sleep_until(this->m_start + std::chrono::duration<double>(vsync * period));
+	return true;
+}
+
+bool SimulatedImpl::waitToBeginFrame(const unsigned int, HMD_FrameTiming *r_timing)
+{
+	const double period = this->getDisplayPeriod();
+
+	if (this->m_config.is_realtime) {
+		/* one frame on its way to the display at most */
+		std::this_thread::sleep_until(this->m_start + std::chrono::duration<double>(this->m_vsync * period));
+	}
+
+	/* rendered within a period, and displayed on the following vsync */
+	r_timing->should_render = 1;
+	r_timing->predicted_display_time = (floor(this->getTime() / period + 1e-6) + 1.0) * period;
+	r_timing->period = period;
+	return true;
+}
+
+bool SimulatedImpl::reCenter()
+{
+	const double time = floor(this->getTime() * this->m_config.sensor_rate + 1e-6) / this->m_config.sensor_rate;
+	float orientation[4], position[3], yaw, pitch, roll;
+
+	this->getMotion(time, orientation, position);
+	poseYawPitchRoll(orientation, &yaw, &pitch, &roll);
+
+	this->m_recenter_yaw = yaw;
+	this->m_recenter_x = position[0];
+	this->m_recenter_z = position[2];
+	return true;
+}
+
+bool SimulatedImpl::setPixelDensity(const float density)
+{
+	if (density <= 0.0f) {
+		return false;
+	}
+
+	for (int eye = 0; eye < 2; eye++) {
+		this->m_width[eye] = (unsigned int)(this->m_config.width[eye] * density + 0.5f);
+		this->m_height[eye] = (unsigned int)(this->m_config.height[eye] * density + 0.5f);
+	}
+	return true;
+}
+
+unsigned int SimulatedImpl::getMaxSamples()
+{
+	return MAX_SAMPLES;
+}
+
+double SimulatedImpl::getDisplayPeriod()
+{
+	return 1.0 / this->m_config.refresh_rate;
+}
+
+unsigned int SimulatedImpl::acquireEyeTexture(const int eye)
+{
+	if (!this->m_is_direct) {
+		return 0;
+	}
+
+	const int chain = this->m_is_side_by_side ? 0 : eye;
+
+	this->m_is_acquired[eye] = true;
+
+	if (this->m_samples > 1) {
+		/* after the names of the layer textures */
+		return 1 + (2 + MAX_LAYERS) * SWAP_CHAIN_LENGTH + chain;
+	}
+	return 1 + chain * SWAP_CHAIN_LENGTH + this->m_swap_chain_index[chain];
+}
+
+bool SimulatedImpl::releaseEyeTexture(const int eye)
+{
+	if (!this->m_is_acquired[eye]) {
+		return false;
+	}
+
+	this->m_is_acquired[eye] = false;
+
+	if (this->m_samples > 1) {
+		/* committed by frameReady after the resolve */
+		return true;
+	}
+
+	if (this->m_is_side_by_side && this->m_is_acquired[1 - eye]) {
+		/* the atlas is committed once both eyes are done with it */
+		return true;
+	}
+
+	/* committed, the next texture of the chain is the current one */
+	const int chain = this->m_is_side_by_side ? 0 : eye;
+	this->m_swap_chain_index[chain] = (this->m_swap_chain_index[chain] + 1) % SWAP_CHAIN_LENGTH;
+	return true;
+}
+
+bool SimulatedImpl::createLayerSwapChain(const int layer)
+{
+	const HMD_LayerDesc &desc = this->m_layers[layer].desc;
+
+	for (int image = 0; image < SWAP_CHAIN_LENGTH; image++) {
+		this->m_layer_pixels[layer][image].assign(desc.width * desc.height, 0);
+	}
+
+	this->m_layer_index[layer] = 0;
+	return true;
+}
+
+void SimulatedImpl::destroyLayerSwapChain(const int layer)
+{
+	for (int image = 0; image < SWAP_CHAIN_LENGTH; image++) {
+		std::vector<uint32_t>().swap(this->m_layer_pixels[layer][image]);
+	}
+}
+
+unsigned int SimulatedImpl::acquireLayerSwapChain(const int layer)
+{
+	/* after the names of the eye textures */
+	return 1 + (2 + layer) * SWAP_CHAIN_LENGTH + this->m_layer_index[layer];
+}
+
+bool SimulatedImpl::commitLayerSwapChain(const int layer)
+{
+	this->m_layers[layer].image = this->m_layer_index[layer];
+	this->m_layer_index[layer] = (this->m_layer_index[layer] + 1) % SWAP_CHAIN_LENGTH;
+	return true;
+}
+
+uint32_t *SimulatedImpl::getLayerPixels(const int layer)
+{
+	if (!this->isLayer(layer)) {
+		return nullptr;
+	}
+	return this->m_layer_pixels[layer][this->m_layer_index[layer]].data();
+}
+
+/* source over destination, non premultiplied */
+static uint32_t blendPixel(const uint32_t src, const uint32_t dst)
+{
+	const unsigned int alpha = src >> 24;
+	uint32_t result = 0;
+
+	for (int channel = 0; channel < 3; channel++) {
+		const unsigned int shift = channel * 8;
+		const unsigned int s = (src >> shift) & 0xff;
+		const unsigned int d = (dst >> shift) & 0xff;
+
+		result |= ((s * alpha + d * (255 - alpha) + 127) / 255) << shift;
+	}
+
+	const unsigned int dst_alpha = dst >> 24;
+	result |= (alpha + (dst_alpha * (255 - alpha) + 127) / 255) << 24;
+	return result;
+}
+
+void SimulatedImpl::composite(const int eye, const unsigned int width, const unsigned int height, uint32_t *r_pixels)
+{
+	const float *fov = this->m_config.fov[eye];
+	const PoseSample &sample = this->m_submit_sample;
+
+	for (int layer = 0; layer < MAX_LAYERS; layer++) {
+		const Layer &entry = this->m_submit_layers[layer];
+
+		if (!entry.is_used || !entry.is_committed) {
+			continue;
+		}
+
+		const HMD_LayerDesc &desc = entry.desc;
+		const uint32_t *texture = this->m_layer_pixels[layer][entry.image].data();
+
+		/* pose of the quad in the tracking space */
+		float orientation[4], position[3];
+
+		if (desc.is_head_locked) {
+			float offset[3];
+
+			poseMultiply(sample.head_orientation, desc.orientation, orientation);
+			poseRotate(sample.head_orientation, desc.position, offset);
+
+			for (int i = 0; i < 3; i++) {
+				position[i] = sample.head_position[i] + offset[i];
+			}
+		}
+		else {
+			memcpy(orientation, desc.orientation, sizeof(float[4]));
+			memcpy(position, desc.position, sizeof(float[3]));
+		}
+
+		/* the eye ray in the space of the quad */
+		const float inverse[4] = { orientation[0], -orientation[1], -orientation[2], -orientation[3] };
+		const float eye_offset[3] = {
+			sample.position[eye][0] - position[0],
+			sample.position[eye][1] - position[1],
+			sample.position[eye][2] - position[2],
+		};
+		float origin[3];
+		poseRotate(inverse, eye_offset, origin);
+
+		for (unsigned int y = 0; y < height; y++) {
+			for (unsigned int x = 0; x < width; x++) {
+				/* the eye looks down -z, the first row is at the top */
+				const float view[3] = {
+					-fov[2] + (x + 0.5f) / width * (fov[2] + fov[3]),
+					fov[0] - (y + 0.5f) / height * (fov[0] + fov[1]),
+					-1.0f,
+				};
+				float world[3], direction[3];
+
+				poseRotate(sample.orientation[eye], view, world);
+				poseRotate(inverse, world, direction);
+
+				if (fabsf(direction[2]) < 1e-6f) {
+					continue;
+				}
+
+				/* hit the plane of the quad in front of the eye */
+				const float t = -origin[2] / direction[2];
+
+				if (t <= 0.0f) {
+					continue;
+				}
+
+				const float u = (origin[0] + t * direction[0]) / desc.size[0] + 0.5f;
+				const float v = 0.5f - (origin[1] + t * direction[1]) / desc.size[1];
+
+				if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f) {
+					continue;
+				}
+
+				const uint32_t texel = texture[(unsigned int)(v * desc.height) * desc.width + (unsigned int)(u * desc.width)];
+				uint32_t &pixel = r_pixels[y * width + x];
+				pixel = blendPixel(texel, pixel);
+			}
+		}
+	}
+}
+
+void SimulatedImpl::computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+{
+	fovProjectionMatrix(this->m_config.fov[eye], nearz, farz, is_opengl, is_right_hand, r_matrix);
+}
+
+Simulated::Simulated(const HMD_SimulatedConfig *config)
+{
+	if (config) {
+		this->m_config = *config;
+	}
+	else {
+		Simulated::getDefaultConfig(&this->m_config);
+	}
+
+	this->initializeImplementation();
+}
+
+void Simulated::getDefaultConfig(HMD_SimulatedConfig *r_config)
+{
+	r_config->motion = HMD_MOTION_LOOK_AROUND;
+	r_config->seed = 1;
+	r_config->orientation_noise = 0.0005f;
+	r_config->position_noise = 0.0002f;
+
+	r_config->sensor_rate = 500.0f;
+	r_config->refresh_rate = 90.0f;
+	r_config->is_realtime = 1;
+
+	/* the left eye sees further to the left, and the right eye to the right */
+	const float fov[4] = { 1.3292f, 1.3292f, 1.0924f, 1.0586f };
+
+	for (int eye = 0; eye < 2; eye++) {
+		r_config->width[eye] = 1332;
+		r_config->height[eye] = 1586;
+
+		r_config->fov[eye][0] = fov[0];
+		r_config->fov[eye][1] = fov[1];
+		r_config->fov[eye][2] = eye ? fov[3] : fov[2];
+		r_config->fov[eye][3] = eye ? fov[2] : fov[3];
+	}
+
+	r_config->ipd = 0.064f;
+}
+
+void Simulated::initializeImplementation() {
+	m_me = new SimulatedImpl(this->m_config);
+}
@@ -0,0 +1,131 @@
+#ifndef __SIMULATED_H__
+#define __SIMULATED_H__
+
+#include "Backend.h"
+
+#include <stdint.h>
+#include <vector>
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#if !defined(DllExport)
+#define DllExport   __declspec( dllexport )
+#endif
+
+#else
+#define DllExport
+#endif
+
+/* Device without hardware: scripted head motion sampled at the sensor rate,
+ * and frame pacing against a virtual vsync.
+ * The poses only depend on the configuration and on the sample times, two runs with the
+ * same configuration produce the same poses for the same frames when the clock is not realtime */
+class DllExport SimulatedImpl final : public BackendImpl
+{
+public:
+	SimulatedImpl(const HMD_SimulatedConfig &config);
+
+	bool setup(const unsigned int color_texture_left, const unsigned int color_texture_right);
+
+	bool setupSideBySide(const unsigned int color_texture);
+
+	bool sampleTracking(const unsigned int frame, PoseSample *r_sample);
+
+	double getTime();
+
+	bool frameReady(void);
+
+	/* in realtime, not before the last submitted frame is displayed */
+	bool waitToBeginFrame(const unsigned int frame, HMD_FrameTiming *r_timing);
+
+	bool reCenter(void);
+
+	/* the configured eye sizes are the ones of the density 1.0 */
+	bool setPixelDensity(const float density);
+
+	double getDisplayPeriod();
+
+	/* names in a virtual swap chain of SWAP_CHAIN_LENGTH textures per eye, or a single one shared
+	 * by both eyes side by side. There is no GL texture behind them.
+	 * With samples, the name of a multisampled texture per chain, resolved into the chain by frameReady */
+	unsigned int acquireEyeTexture(const int eye);
+
+	bool releaseEyeTexture(const int eye);
+
+	unsigned int getMaxSamples();
+
+	/* layers are kept in memory, SWAP_CHAIN_LENGTH images of RGBA pixels (0xAABBGGRR),
+	 * the first row at the top */
+	bool createLayerSwapChain(const int layer);
+
+	void destroyLayerSwapChain(const int layer);
+
+	unsigned int acquireLayerSwapChain(const int layer);
+
+	bool commitLayerSwapChain(const int layer);
+
+	/* pixels of the acquired layer texture, nullptr if there is no such layer */
+	uint32_t *getLayerPixels(const int layer);
+
+	/* blend the layers of the last submitted frame over the image of the eye,
+	 * as the compositor would with the pose the frame was rendered with */
+	void composite(const int eye, const unsigned int width, const unsigned int height, uint32_t *r_pixels);
+
+	void computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix);
+
+	/* head pose of the scripted motion at the given time, without noise nor re-centering */
+	void getMotion(const double time, float *r_orientation, float *r_position);
+
+	enum { SWAP_CHAIN_LENGTH = 3 };
+
+	/* frames submitted, and frames that missed their vsync */
+	unsigned int getPresentedFrames() const { return this->m_presented_frames; }
+	unsigned int getMissedFrames() const { return this->m_missed_frames; }
+
+	/* multisampled textures resolved into the swap chains */
+	unsigned int getResolves() const { return this->m_resolves; }
+
+	enum { MAX_SAMPLES = 8 };
+
+private:
+	void addNoise(const unsigned long long tick, float *r_orientation, float *r_position);
+
+	HMD_SimulatedConfig m_config;
+
+	std::chrono::steady_clock::time_point m_start;
+	std::atomic<unsigned long long> m_vsync; /* last presented vsync, it drives the clock when not realtime */
+
+	/* the tracking thread reads them while they are set */
+	std::atomic<float> m_recenter_yaw;
+	std::atomic<float> m_recenter_x;
+	std::atomic<float> m_recenter_z;
+
+	/* written by the thread submitting the frames */
+	std::atomic<unsigned int> m_presented_frames;
+	std::atomic<unsigned int> m_missed_frames;
+	std::atomic<unsigned int> m_resolves;
+
+	bool m_is_direct;
+	bool m_is_acquired[2];
+	unsigned int m_swap_chain_index[2];
+
+	std::vector<uint32_t> m_layer_pixels[MAX_LAYERS][SWAP_CHAIN_LENGTH];
+	unsigned int m_layer_index[MAX_LAYERS]; /* image the application renders into */
+};
+
+class DllExport Simulated : public Backend
+{
+public:
+	Simulated(const HMD_SimulatedConfig *config = nullptr);
+
+	/* default configuration, a seated headset of the Rift CV1 class */
+	static void getDefaultConfig(HMD_SimulatedConfig *r_config);
+
+protected:
+	virtual void initializeImplementation();
+
+private:
+	HMD_SimulatedConfig m_config;
+};
+
+#endif /* __SIMULATED_H__ */
@@ -0,0 +1,61 @@
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include <atomic>
+
+/* Single-producer, single-consumer bounded queue.
+ * Neither side ever waits: push fails when the queue is full, pop when it is empty.
+ * N must be a power of two */
+template <typename T, unsigned int N>
+class SpscQueue
+{
+public:
+	SpscQueue() :
+		m_head(0),
+		m_tail(0)
+	{
+		static_assert((N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+	}
+
+	/* only to be called from the producer thread */
+	bool push(const T &value)
+	{
+		const unsigned long long tail = this->m_tail.load(std::memory_order_relaxed);
+
+		if (tail - this->m_head.load(std::memory_order_acquire) == N) {
+			return false;
+		}
+
+		this->m_values[tail & (N - 1)] = value;
+		this->m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* only to be called from the consumer thread */
+	bool pop(T *r_value)
+	{
+		const unsigned long long head = this->m_head.load(std::memory_order_relaxed);
+
+		if (head == this->m_tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		*r_value = this->m_values[head & (N - 1)];
+		this->m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const
+	{
+		return this->m_head.load(std::memory_order_acquire) == this->m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	T m_values[N];
+
+	/* on their own cache lines, each one is written by a single side */
+	alignas(64) std::atomic<unsigned long long> m_head;
+	alignas(64) std::atomic<unsigned long long> m_tail;
+};
+
+#endif /* __SPSC_QUEUE_H__ */
@@ -18,24 +18,9 @@ class DllExport StubImpl : public BackendImpl
 public:
 	bool setup(const unsigned int, const unsigned int) { return false;  }
 
-	bool update(float *, float *, float *, float *) { return false; }
-
-	bool update(
-		float *, float *, float *, float *,
-		float *, float *, float *, float *)
-	{
-		return false;
-	}
-
-	bool update(
-		float *, float *, float *, float *, float *,
-		float *, float *, float *, float *, float *)
-	{
-		return false;
-	}
-
-	bool update(const bool, float *, float *)
+	bool sampleTracking(const unsigned int, PoseSample *r_sample)
 	{
+		memset(r_sample, 0, sizeof(PoseSample));
 		return false;
 	}
 
@@ -49,14 +34,19 @@ public:
 		return false;
 	}
 
-	void getProjectionMatrixLeft(const float, const float, const bool, const bool, float *) {}
-
-	void getProjectionMatrixRight(const float, const float, const bool, const bool, float *) {}
+	void computeProjectionMatrix(const int, const float, const float, const bool, const bool, float *r_matrix)
+	{
+		memset(r_matrix, 0, sizeof(float[16]));
+	}
 };
 
 class DllExport Stub : public Backend {
+public:
+	Stub() {
+		this->initializeImplementation();
+	}
+
 private:
-	StubImpl *m_me;
 	virtual void initializeImplementation() {
 		this->m_me = new StubImpl();
 	}
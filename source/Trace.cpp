@@ -0,0 +1,415 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* TraceFile */
+
+#if defined(_WIN32) || defined(_WIN64)
+
+TraceFile::TraceFile() :
+	m_data(nullptr),
+	m_size(0),
+	m_is_open(false),
+	m_is_writing(false),
+	m_file(INVALID_HANDLE_VALUE),
+	m_mapping(nullptr)
+{
+}
+
+bool TraceFile::open(const char *path, const bool is_writing)
+{
+	if (this->m_is_open) {
+		return false;
+	}
+
+	this->m_file = CreateFileA(
+		path,
+		is_writing ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		is_writing ? CREATE_ALWAYS : OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	if (this->m_file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	this->m_is_open = true;
+	this->m_is_writing = is_writing;
+
+	if (!is_writing) {
+		LARGE_INTEGER size;
+
+		if (!GetFileSizeEx(this->m_file, &size) || !this->map((size_t)size.QuadPart)) {
+			this->close();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TraceFile::map(const size_t size)
+{
+	if (size == 0) {
+		return true;
+	}
+
+	/* a writable mapping extends the file to its size */
+	const unsigned long long size64 = size;
+	this->m_mapping = CreateFileMappingA(
+		this->m_file, NULL,
+		this->m_is_writing ? PAGE_READWRITE : PAGE_READONLY,
+		(DWORD)(size64 >> 32), (DWORD)(size64 & 0xffffffff), NULL);
+
+	if (this->m_mapping == NULL) {
+		return false;
+	}
+
+	this->m_data = (char *)MapViewOfFile(this->m_mapping, this->m_is_writing ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+
+	if (this->m_data == NULL) {
+		CloseHandle(this->m_mapping);
+		this->m_mapping = nullptr;
+		return false;
+	}
+
+	this->m_size = size;
+	return true;
+}
+
+void TraceFile::unmap()
+{
+	if (this->m_data) {
+		UnmapViewOfFile(this->m_data);
+		this->m_data = nullptr;
+	}
+
+	if (this->m_mapping) {
+		CloseHandle(this->m_mapping);
+		this->m_mapping = nullptr;
+	}
+	this->m_size = 0;
+}
+
+void TraceFile::truncate(const size_t size)
+{
+	LARGE_INTEGER position;
+	position.QuadPart = size;
+
+	this->unmap();
+	SetFilePointerEx(this->m_file, position, NULL, FILE_BEGIN);
+	SetEndOfFile(this->m_file);
+	this->close();
+}
+
+void TraceFile::close()
+{
+	this->unmap();
+
+	if (this->m_file != INVALID_HANDLE_VALUE) {
+		CloseHandle(this->m_file);
+		this->m_file = INVALID_HANDLE_VALUE;
+	}
+	this->m_is_open = false;
+}
+
+#else
+
+TraceFile::TraceFile() :
+	m_data(nullptr),
+	m_size(0),
+	m_is_open(false),
+	m_is_writing(false),
+	m_file(-1)
+{
+}
+
+bool TraceFile::open(const char *path, const bool is_writing)
+{
+	if (this->m_is_open) {
+		return false;
+	}
+
+	this->m_file = ::open(path, is_writing ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+
+	if (this->m_file < 0) {
+		return false;
+	}
+
+	this->m_is_open = true;
+	this->m_is_writing = is_writing;
+
+	if (!is_writing) {
+		struct stat st;
+
+		if (fstat(this->m_file, &st) != 0 || !this->map((size_t)st.st_size)) {
+			this->close();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TraceFile::map(const size_t size)
+{
+	if (size == 0) {
+		return true;
+	}
+
+	if (this->m_is_writing && ftruncate(this->m_file, (off_t)size) != 0) {
+		return false;
+	}
+
+	void *data = mmap(NULL, size, this->m_is_writing ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, this->m_file, 0);
+
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	this->m_data = (char *)data;
+	this->m_size = size;
+	return true;
+}
+
+void TraceFile::unmap()
+{
+	if (this->m_data) {
+		munmap(this->m_data, this->m_size);
+		this->m_data = nullptr;
+	}
+	this->m_size = 0;
+}
+
+void TraceFile::truncate(const size_t size)
+{
+	this->unmap();
+
+	if (ftruncate(this->m_file, (off_t)size) != 0) {
+		/* the header count still tells the valid records */
+	}
+	this->close();
+}
+
+void TraceFile::close()
+{
+	this->unmap();
+
+	if (this->m_file >= 0) {
+		::close(this->m_file);
+		this->m_file = -1;
+	}
+	this->m_is_open = false;
+}
+
+#endif
+
+TraceFile::~TraceFile()
+{
+	this->close();
+}
+
+bool TraceFile::reserve(const size_t size)
+{
+	if (!this->m_is_writing) {
+		return false;
+	}
+
+	if (size <= this->m_size) {
+		return true;
+	}
+
+	/* the records are kept by the file, remapping does not lose them */
+	this->unmap();
+	return this->map(size);
+}
+
+/* TraceWriter */
+
+TraceWriter::TraceWriter() :
+	m_queue(nullptr),
+	m_queue_memory(nullptr),
+	m_is_open(false),
+	m_is_adding(false),
+	m_is_running(false),
+	m_count(0),
+	m_dropped(0)
+{
+}
+
+TraceWriter::~TraceWriter()
+{
+	this->close();
+}
+
+bool TraceWriter::open(const char *path)
+{
+	if (this->m_is_open) {
+		return false;
+	}
+
+	if (!this->m_file.open(path, true) ||
+	    !this->m_file.reserve(sizeof(TraceHeader) + GROW_RECORDS * sizeof(TraceRecord)))
+	{
+		this->m_file.close();
+		return false;
+	}
+
+	TraceHeader *header = (TraceHeader *)this->m_file.data();
+	memcpy(header->magic, TRACE_MAGIC, sizeof(header->magic));
+	header->version = TRACE_VERSION;
+	header->record_size = sizeof(TraceRecord);
+	header->count = 0;
+	header->dropped = 0;
+
+	/* operator new ignores the cache line alignment of the queue before C++17 */
+	this->m_queue_memory = malloc(sizeof(Queue) + alignof(Queue));
+
+	if (!this->m_queue_memory) {
+		this->m_file.close();
+		return false;
+	}
+
+	const uintptr_t address = ((uintptr_t)this->m_queue_memory + alignof(Queue) - 1) & ~(uintptr_t)(alignof(Queue) - 1);
+	this->m_queue = new ((void *)address) Queue();
+	this->m_count = 0;
+	this->m_dropped = 0;
+
+	this->m_is_running = true;
+	this->m_thread = std::thread(&TraceWriter::flushLoop, this);
+	this->m_is_open = true;
+	return true;
+}
+
+void TraceWriter::close()
+{
+	if (!this->m_is_open) {
+		return;
+	}
+
+	/* no add() can start from now on, wait for the one in progress */
+	this->m_is_open = false;
+	while (this->m_is_adding) {
+		std::this_thread::yield();
+	}
+
+	this->m_is_running = false;
+	this->m_thread.join();
+
+	this->m_file.truncate(sizeof(TraceHeader) + (size_t)this->m_count * sizeof(TraceRecord));
+
+	this->m_queue->~Queue();
+	this->m_queue = nullptr;
+
+	free(this->m_queue_memory);
+	this->m_queue_memory = nullptr;
+}
+
+void TraceWriter::add(const PoseSample &sample)
+{
+	this->m_is_adding = true;
+
+	if (this->m_is_open) {
+		TraceRecord record;
+		traceRecordFromSample(sample, &record);
+
+		if (!this->m_queue->push(record)) {
+			this->m_dropped++;
+		}
+	}
+
+	this->m_is_adding = false;
+}
+
+void TraceWriter::flushLoop()
+{
+	while (this->m_is_running) {
+		if (this->flush() == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	/* what was queued before closing */
+	while (this->flush() != 0) {
+	}
+}
+
+unsigned int TraceWriter::flush()
+{
+	TraceRecord record;
+	unsigned int written = 0;
+
+	while (this->m_queue->pop(&record)) {
+		const size_t offset = sizeof(TraceHeader) + (size_t)this->m_count * sizeof(TraceRecord);
+
+		if (offset + sizeof(TraceRecord) > this->m_file.size() &&
+		    !this->m_file.reserve(this->m_file.size() + GROW_RECORDS * sizeof(TraceRecord)))
+		{
+			this->m_dropped++;
+			continue;
+		}
+
+		memcpy(this->m_file.data() + offset, &record, sizeof(record));
+		this->m_count++;
+		written++;
+	}
+
+	if (written != 0) {
+		/* a session cut short is still readable up to here */
+		TraceHeader *header = (TraceHeader *)this->m_file.data();
+		header->count = this->m_count;
+		header->dropped = this->m_dropped;
+	}
+	return written;
+}
+
+/* TraceReader */
+
+bool TraceReader::open(const char *path)
+{
+	if (!this->m_file.open(path, false)) {
+		return false;
+	}
+
+	const TraceHeader *header = (const TraceHeader *)this->m_file.data();
+
+	if (this->m_file.size() < sizeof(TraceHeader) ||
+	    memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != TRACE_VERSION ||
+	    header->record_size != sizeof(TraceRecord))
+	{
+		this->m_file.close();
+		return false;
+	}
+	return true;
+}
+
+unsigned long long TraceReader::getCount() const
+{
+	const TraceHeader *header = (const TraceHeader *)this->m_file.data();
+	const unsigned long long available = (this->m_file.size() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+
+	return header->count < available ? header->count : available;
+}
+
+unsigned long long TraceReader::getDropped() const
+{
+	return ((const TraceHeader *)this->m_file.data())->dropped;
+}
+
+const TraceRecord &TraceReader::getRecord(const unsigned long long index) const
+{
+	return ((const TraceRecord *)(this->m_file.data() + sizeof(TraceHeader)))[index];
+}
@@ -0,0 +1,177 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include "Pose.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#if !defined(DllExport)
+#define DllExport   __declspec( dllexport )
+#endif
+
+#else
+#define DllExport
+#endif
+
+/* Tracking session file: a TraceHeader followed by TraceHeader::count TraceRecord,
+ * little-endian, in the order they were sampled */
+
+#define TRACE_MAGIC "HMDTRACE"
+#define TRACE_VERSION 1
+
+struct TraceHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size; /* sizeof(TraceRecord) */
+	uint64_t count; /* records written so far, updated while recording */
+	uint64_t dropped; /* records lost because the writer was behind */
+};
+
+struct TraceRecord
+{
+	uint32_t frame;
+	uint32_t status; /* eHMDStatus */
+	double time; /* predicted display time */
+
+	float head_orientation[4]; /* w, x, y, z */
+	float head_position[3];
+	float orientation[2][4];
+	float position[2][3];
+};
+
+static_assert(sizeof(TraceHeader) == 32, "TraceHeader layout is part of the file format");
+static_assert(sizeof(TraceRecord) == 104, "TraceRecord layout is part of the file format");
+
+static inline void traceRecordFromSample(const PoseSample &sample, TraceRecord *r_record)
+{
+	r_record->frame = sample.frame;
+	r_record->status = sample.status;
+	r_record->time = sample.time;
+
+	memcpy(r_record->head_orientation, sample.head_orientation, sizeof(r_record->head_orientation));
+	memcpy(r_record->head_position, sample.head_position, sizeof(r_record->head_position));
+	memcpy(r_record->orientation, sample.orientation, sizeof(r_record->orientation));
+	memcpy(r_record->position, sample.position, sizeof(r_record->position));
+}
+
+static inline void traceRecordToSample(const TraceRecord &record, PoseSample *r_sample)
+{
+	r_sample->frame = record.frame;
+	r_sample->status = record.status;
+	r_sample->time = record.time;
+
+	memcpy(r_sample->head_orientation, record.head_orientation, sizeof(record.head_orientation));
+	memcpy(r_sample->head_position, record.head_position, sizeof(record.head_position));
+	memcpy(r_sample->orientation, record.orientation, sizeof(record.orientation));
+	memcpy(r_sample->position, record.position, sizeof(record.position));
+}
+
+/* file mapped in memory, grown on demand */
+class DllExport TraceFile
+{
+public:
+	TraceFile();
+	~TraceFile();
+
+	bool open(const char *path, const bool is_writing);
+	void close();
+
+	bool isOpen() const { return this->m_is_open; }
+
+	/* make sure size bytes are mapped, only when writing */
+	bool reserve(const size_t size);
+
+	/* shrink the file to size bytes and close it, only when writing */
+	void truncate(const size_t size);
+
+	char *data() const { return this->m_data; }
+	size_t size() const { return this->m_size; }
+
+private:
+	bool map(const size_t size);
+	void unmap();
+
+	char *m_data;
+	size_t m_size;
+	bool m_is_open;
+	bool m_is_writing;
+
+#if defined(_WIN32) || defined(_WIN64)
+	void *m_file;
+	void *m_mapping;
+#else
+	int m_file;
+#endif
+};
+
+/* Appends the tracking samples to a trace file.
+ * add() only copies the sample in a queue, a background thread writes them to the mapped file */
+class DllExport TraceWriter
+{
+public:
+	TraceWriter();
+	~TraceWriter();
+
+	bool open(const char *path);
+
+	/* write the pending records, and close the file */
+	void close();
+
+	bool isOpen() const { return this->m_is_open; }
+
+	/* never blocks, the sample is dropped (and counted) when the queue is full.
+	 * Only one thread at a time, the one sampling the tracking */
+	void add(const PoseSample &sample);
+
+	unsigned long long getCount() const { return this->m_count; }
+	unsigned long long getDropped() const { return this->m_dropped; }
+
+private:
+	enum { QUEUE_SIZE = 4096, GROW_RECORDS = 4096 };
+
+	typedef SpscQueue<TraceRecord, QUEUE_SIZE> Queue;
+
+	void flushLoop();
+
+	/* move the queued records to the file, return the number of records written */
+	unsigned int flush();
+
+	TraceFile m_file;
+	Queue *m_queue;
+	void *m_queue_memory; /* m_queue is constructed in it, aligned by hand */
+	std::thread m_thread;
+
+	std::atomic<bool> m_is_open;
+	std::atomic<bool> m_is_adding; /* add() is in progress */
+	std::atomic<bool> m_is_running;
+
+	std::atomic<unsigned long long> m_count;
+	std::atomic<unsigned long long> m_dropped;
+};
+
+/* Read-only access to the records of a trace file */
+class DllExport TraceReader
+{
+public:
+	bool open(const char *path);
+	void close() { this->m_file.close(); }
+
+	bool isOpen() const { return this->m_file.isOpen(); }
+
+	unsigned long long getCount() const;
+	unsigned long long getDropped() const;
+
+	const TraceRecord &getRecord(const unsigned long long index) const;
+
+private:
+	TraceFile m_file;
+};
+
+#endif /* __TRACE_H__ */
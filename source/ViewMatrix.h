@@ -0,0 +1,163 @@
+#ifndef __VIEW_MATRIX_H__
+#define __VIEW_MATRIX_H__
+
+#include "Pose.h"
+
+#include <float.h>
+
+#if !defined(BRIDGE_NO_SIMD)
+#if defined(__AVX__)
+#define BRIDGE_VIEW_MATRIX_AVX
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BRIDGE_VIEW_MATRIX_SSE
+#include <xmmintrin.h>
+#endif
+#endif
+
+/* Column-major view matrices of both eyes, built straight from the orientation and position.
+ *
+ * Column c of the rotation is the row c of the orientation matrix,
+ * and the translation is -(p.x * C0 + p.y * C1 + p.z * C2) */
+
+static inline void poseStereoViewMatrixScalar(const PoseSample &sample, const bool is_right_hand, float r_matrix[2][16])
+{
+	poseViewMatrix(sample.orientation[0], sample.position[0], is_right_hand, r_matrix[0]);
+	poseViewMatrix(sample.orientation[1], sample.position[1], is_right_hand, r_matrix[1]);
+}
+
+#if defined(BRIDGE_VIEW_MATRIX_SSE) || defined(BRIDGE_VIEW_MATRIX_AVX)
+
+/* lanes of a quaternion loaded as (w, x, y, z) */
+enum { QW = 0, QX = 1, QY = 2, QZ = 3 };
+
+#define VM_SWIZZLE(v, a, b, c) _mm_shuffle_ps(v, v, _MM_SHUFFLE(QW, c, b, a))
+#define VM_SWIZZLE_256(v, a, b, c) _mm256_shuffle_ps(v, v, _MM_SHUFFLE(QW, c, b, a))
+
+#endif
+
+#if defined(BRIDGE_VIEW_MATRIX_SSE)
+
+static inline void poseStereoViewMatrix(const PoseSample &sample, const bool is_right_hand, float r_matrix[2][16])
+{
+	/* left-handed flips the side and forward axes, lane 3 clears the w row */
+	const float side = is_right_hand ? 1.0f : -1.0f;
+	const __m128 hand = _mm_setr_ps(side, 1.0f, side, 0.0f);
+
+	const __m128 one0 = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
+	const __m128 one1 = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+	const __m128 one2 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+	const __m128 a0 = _mm_setr_ps(-1.0f, 1.0f, 1.0f, 0.0f), b0 = _mm_setr_ps(-1.0f, -1.0f, 1.0f, 0.0f);
+	const __m128 a1 = _mm_setr_ps(1.0f, -1.0f, 1.0f, 0.0f), b1 = _mm_setr_ps(1.0f, -1.0f, -1.0f, 0.0f);
+	const __m128 a2 = _mm_setr_ps(1.0f, 1.0f, -1.0f, 0.0f), b2 = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 0.0f);
+	const __m128 w_row = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+	for (int eye = 0; eye < 2; eye++) {
+		const __m128 q = _mm_loadu_ps(sample.orientation[eye]);
+
+		/* 2 / |q|^2 normalizes the quaternion within the products */
+		__m128 norm = _mm_mul_ps(q, q);
+		norm = _mm_add_ps(norm, _mm_shuffle_ps(norm, norm, _MM_SHUFFLE(2, 3, 0, 1)));
+		norm = _mm_add_ps(norm, _mm_shuffle_ps(norm, norm, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m128 q2 = _mm_mul_ps(q, _mm_div_ps(_mm_set1_ps(2.0f), _mm_max_ps(norm, _mm_set1_ps(FLT_MIN))));
+
+		__m128 c0 = _mm_add_ps(one0, _mm_add_ps(
+			_mm_mul_ps(_mm_mul_ps(VM_SWIZZLE(q, QY, QX, QX), VM_SWIZZLE(q2, QY, QY, QZ)), a0),
+			_mm_mul_ps(_mm_mul_ps(VM_SWIZZLE(q, QZ, QW, QW), VM_SWIZZLE(q2, QZ, QZ, QY)), b0)));
+
+		__m128 c1 = _mm_add_ps(one1, _mm_add_ps(
+			_mm_mul_ps(_mm_mul_ps(VM_SWIZZLE(q, QX, QX, QY), VM_SWIZZLE(q2, QY, QX, QZ)), a1),
+			_mm_mul_ps(_mm_mul_ps(VM_SWIZZLE(q, QW, QZ, QW), VM_SWIZZLE(q2, QZ, QZ, QX)), b1)));
+
+		__m128 c2 = _mm_add_ps(one2, _mm_add_ps(
+			_mm_mul_ps(_mm_mul_ps(VM_SWIZZLE(q, QX, QY, QX), VM_SWIZZLE(q2, QZ, QZ, QX)), a2),
+			_mm_mul_ps(_mm_mul_ps(VM_SWIZZLE(q, QW, QW, QY), VM_SWIZZLE(q2, QY, QX, QY)), b2)));
+
+		c0 = _mm_mul_ps(c0, hand);
+		c1 = _mm_mul_ps(c1, hand);
+		c2 = _mm_mul_ps(c2, hand);
+
+		const float *p = sample.position[eye];
+		__m128 t = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(c0, _mm_set1_ps(p[0])),
+			_mm_mul_ps(c1, _mm_set1_ps(p[1]))),
+			_mm_mul_ps(c2, _mm_set1_ps(p[2])));
+		t = _mm_sub_ps(w_row, t);
+
+		_mm_storeu_ps(r_matrix[eye] + 0, c0);
+		_mm_storeu_ps(r_matrix[eye] + 4, c1);
+		_mm_storeu_ps(r_matrix[eye] + 8, c2);
+		_mm_storeu_ps(r_matrix[eye] + 12, t);
+	}
+}
+
+#elif defined(BRIDGE_VIEW_MATRIX_AVX)
+
+/* both eyes at once, the left eye in the low and the right eye in the high 128-bit lane */
+static inline void poseStereoViewMatrix(const PoseSample &sample, const bool is_right_hand, float r_matrix[2][16])
+{
+	const float side = is_right_hand ? 1.0f : -1.0f;
+	const __m256 hand = _mm256_setr_ps(side, 1.0f, side, 0.0f, side, 1.0f, side, 0.0f);
+
+	const __m256 one0 = _mm256_setr_ps(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+	const __m256 one1 = _mm256_setr_ps(0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+	const __m256 one2 = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+	const __m256 a0 = _mm256_setr_ps(-1.0f, 1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 1.0f, 0.0f);
+	const __m256 b0 = _mm256_setr_ps(-1.0f, -1.0f, 1.0f, 0.0f, -1.0f, -1.0f, 1.0f, 0.0f);
+	const __m256 a1 = _mm256_setr_ps(1.0f, -1.0f, 1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 0.0f);
+	const __m256 b1 = _mm256_setr_ps(1.0f, -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, -1.0f, 0.0f);
+	const __m256 a2 = _mm256_setr_ps(1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f, 0.0f);
+	const __m256 b2 = _mm256_setr_ps(-1.0f, 1.0f, -1.0f, 0.0f, -1.0f, 1.0f, -1.0f, 0.0f);
+	const __m256 w_row = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+	const __m256 q = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(sample.orientation[0])), _mm_loadu_ps(sample.orientation[1]), 1);
+
+	__m256 norm = _mm256_mul_ps(q, q);
+	norm = _mm256_add_ps(norm, _mm256_shuffle_ps(norm, norm, _MM_SHUFFLE(2, 3, 0, 1)));
+	norm = _mm256_add_ps(norm, _mm256_shuffle_ps(norm, norm, _MM_SHUFFLE(1, 0, 3, 2)));
+	const __m256 q2 = _mm256_mul_ps(q, _mm256_div_ps(_mm256_set1_ps(2.0f), _mm256_max_ps(norm, _mm256_set1_ps(FLT_MIN))));
+
+	__m256 c0 = _mm256_add_ps(one0, _mm256_add_ps(
+		_mm256_mul_ps(_mm256_mul_ps(VM_SWIZZLE_256(q, QY, QX, QX), VM_SWIZZLE_256(q2, QY, QY, QZ)), a0),
+		_mm256_mul_ps(_mm256_mul_ps(VM_SWIZZLE_256(q, QZ, QW, QW), VM_SWIZZLE_256(q2, QZ, QZ, QY)), b0)));
+
+	__m256 c1 = _mm256_add_ps(one1, _mm256_add_ps(
+		_mm256_mul_ps(_mm256_mul_ps(VM_SWIZZLE_256(q, QX, QX, QY), VM_SWIZZLE_256(q2, QY, QX, QZ)), a1),
+		_mm256_mul_ps(_mm256_mul_ps(VM_SWIZZLE_256(q, QW, QZ, QW), VM_SWIZZLE_256(q2, QZ, QZ, QX)), b1)));
+
+	__m256 c2 = _mm256_add_ps(one2, _mm256_add_ps(
+		_mm256_mul_ps(_mm256_mul_ps(VM_SWIZZLE_256(q, QX, QY, QX), VM_SWIZZLE_256(q2, QZ, QZ, QX)), a2),
+		_mm256_mul_ps(_mm256_mul_ps(VM_SWIZZLE_256(q, QW, QW, QY), VM_SWIZZLE_256(q2, QY, QX, QY)), b2)));
+
+	c0 = _mm256_mul_ps(c0, hand);
+	c1 = _mm256_mul_ps(c1, hand);
+	c2 = _mm256_mul_ps(c2, hand);
+
+	const float *pl = sample.position[0], *pr = sample.position[1];
+	__m256 t = _mm256_add_ps(_mm256_add_ps(
+		_mm256_mul_ps(c0, _mm256_setr_ps(pl[0], pl[0], pl[0], pl[0], pr[0], pr[0], pr[0], pr[0])),
+		_mm256_mul_ps(c1, _mm256_setr_ps(pl[1], pl[1], pl[1], pl[1], pr[1], pr[1], pr[1], pr[1]))),
+		_mm256_mul_ps(c2, _mm256_setr_ps(pl[2], pl[2], pl[2], pl[2], pr[2], pr[2], pr[2], pr[2])));
+	t = _mm256_sub_ps(w_row, t);
+
+	_mm_storeu_ps(r_matrix[0] + 0, _mm256_castps256_ps128(c0));
+	_mm_storeu_ps(r_matrix[0] + 4, _mm256_castps256_ps128(c1));
+	_mm_storeu_ps(r_matrix[0] + 8, _mm256_castps256_ps128(c2));
+	_mm_storeu_ps(r_matrix[0] + 12, _mm256_castps256_ps128(t));
+
+	_mm_storeu_ps(r_matrix[1] + 0, _mm256_extractf128_ps(c0, 1));
+	_mm_storeu_ps(r_matrix[1] + 4, _mm256_extractf128_ps(c1, 1));
+	_mm_storeu_ps(r_matrix[1] + 8, _mm256_extractf128_ps(c2, 1));
+	_mm_storeu_ps(r_matrix[1] + 12, _mm256_extractf128_ps(t, 1));
+}
+
+#else
+
+static inline void poseStereoViewMatrix(const PoseSample &sample, const bool is_right_hand, float r_matrix[2][16])
+{
+	poseStereoViewMatrixScalar(sample, is_right_hand, r_matrix);
+}
+
+#endif
+
+#endif /* __VIEW_MATRIX_H__ */
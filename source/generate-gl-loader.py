@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+"""
+Generates GLLoader.h and GLLoader.cpp: the GL entry points the bridge calls,
+each one resolved by its first call, instead of the whole of GLEW.
+
+Add the entry points and enums a backend needs to the tables below, and run:
+$ python3 generate-gl-loader.py
+"""
+
+import os
+import re
+
+# name, return type, parameters
+GL_FUNCTIONS = (
+    ("glBindFramebuffer", "void", "GLenum target, GLuint framebuffer"),
+    ("glBindTexture", "void", "GLenum target, GLuint texture"),
+    ("glBlitFramebuffer", "void", "GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter"),
+    ("glClear", "void", "GLbitfield mask"),
+    ("glDeleteFramebuffers", "void", "GLsizei n, const GLuint *framebuffers"),
+    ("glDeleteQueries", "void", "GLsizei n, const GLuint *ids"),
+    ("glDeleteSync", "void", "GLsync sync"),
+    ("glDeleteTextures", "void", "GLsizei n, const GLuint *textures"),
+    ("glDisable", "void", "GLenum cap"),
+    ("glEnable", "void", "GLenum cap"),
+    ("glFenceSync", "GLsync", "GLenum condition, GLbitfield flags"),
+    ("glFlush", "void", "void"),
+    ("glFramebufferTexture2D", "void", "GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level"),
+    ("glGenFramebuffers", "void", "GLsizei n, GLuint *framebuffers"),
+    ("glGenQueries", "void", "GLsizei n, GLuint *ids"),
+    ("glGenTextures", "void", "GLsizei n, GLuint *textures"),
+    ("glGenerateMipmap", "void", "GLenum target"),
+    ("glGetIntegerv", "void", "GLenum pname, GLint *data"),
+    ("glGetQueryObjectiv", "void", "GLuint id, GLenum pname, GLint *params"),
+    ("glGetQueryObjectui64v", "void", "GLuint id, GLenum pname, GLuint64 *params"),
+    ("glGetString", "const GLubyte *", "GLenum name"),
+    ("glGetStringi", "const GLubyte *", "GLenum name, GLuint index"),
+    ("glQueryCounter", "void", "GLuint id, GLenum target"),
+    ("glTexImage2D", "void", "GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels"),
+    ("glTexImage2DMultisample", "void", "GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations"),
+    ("glTexParameteri", "void", "GLenum target, GLenum pname, GLint param"),
+    ("glWaitSync", "void", "GLsync sync, GLbitfield flags, GLuint64 timeout"),
+    )
+
+# extensions of WGL, the core of WGL is in opengl32 and declared by windows.h
+WGL_FUNCTIONS = (
+    ("wglCreateContextAttribsARB", "HGLRC", "HDC hDC, HGLRC hShareContext, const int *attribList"),
+    ("wglSwapIntervalEXT", "BOOL", "int interval"),
+    )
+
+GL_ENUMS = (
+    ("GL_FALSE", "0"),
+    ("GL_TRUE", "1"),
+    ("GL_COLOR_BUFFER_BIT", "0x00004000"),
+    ("GL_TEXTURE_2D", "0x0DE1"),
+    ("GL_UNSIGNED_BYTE", "0x1401"),
+    ("GL_RGBA", "0x1908"),
+    ("GL_VERSION", "0x1F02"),
+    ("GL_EXTENSIONS", "0x1F03"),
+    ("GL_NEAREST", "0x2600"),
+    ("GL_LINEAR", "0x2601"),
+    ("GL_LINEAR_MIPMAP_LINEAR", "0x2703"),
+    ("GL_TEXTURE_MAG_FILTER", "0x2800"),
+    ("GL_TEXTURE_MIN_FILTER", "0x2801"),
+    ("GL_TEXTURE_WRAP_S", "0x2802"),
+    ("GL_TEXTURE_WRAP_T", "0x2803"),
+    ("GL_REPEAT", "0x2901"),
+    ("GL_RGBA8", "0x8058"),
+    ("GL_CLAMP_TO_EDGE", "0x812F"),
+    ("GL_NUM_EXTENSIONS", "0x821D"),
+    ("GL_QUERY_RESULT", "0x8866"),
+    ("GL_QUERY_RESULT_AVAILABLE", "0x8867"),
+    ("GL_SRGB8_ALPHA8", "0x8C43"),
+    ("GL_DRAW_FRAMEBUFFER_BINDING", "0x8CA6"),
+    ("GL_READ_FRAMEBUFFER", "0x8CA8"),
+    ("GL_DRAW_FRAMEBUFFER", "0x8CA9"),
+    ("GL_READ_FRAMEBUFFER_BINDING", "0x8CAA"),
+    ("GL_COLOR_ATTACHMENT0", "0x8CE0"),
+    ("GL_FRAMEBUFFER", "0x8D40"),
+    ("GL_MAX_SAMPLES", "0x8D57"),
+    ("GL_FRAMEBUFFER_SRGB", "0x8DB9"),
+    ("GL_TIMESTAMP", "0x8E28"),
+    ("GL_TEXTURE_2D_MULTISAMPLE", "0x9100"),
+    ("GL_SYNC_GPU_COMMANDS_COMPLETE", "0x9117"),
+    ("GL_TIMEOUT_IGNORED", "0xFFFFFFFFFFFFFFFFull"),
+    )
+
+NOTICE = "/* generated by generate-gl-loader.py, do not edit */\n"
+
+
+def arguments(parameters):
+    """names of the parameters, to forward them"""
+    if parameters == "void":
+        return ""
+    return ", ".join(parameter.replace("*", " ").split()[-1] for parameter in parameters.split(","))
+
+
+def types(parameters):
+    """the parameters without their names, for the stubs that don't use them"""
+    if parameters == "void":
+        return parameters
+    return ", ".join(re.sub(r"\s*\w+$", "", parameter.strip()) for parameter in parameters.split(","))
+
+
+def declare(functions):
+    lines = []
+    for name, result, parameters in functions:
+        lines.append("typedef {0} (GLLOADER_APIENTRY *PFN_{1})({2});".format(result, name, parameters))
+        lines.append("extern PFN_{0} GLLoader_{0};".format(name))
+        lines.append("#define {0} GLLoader_{0}".format(name))
+        lines.append("")
+    return "\n".join(lines)
+
+
+def names(functions):
+    """the table of the names, for the tools that resolve every entry point"""
+    lines = ["const char *const GLLoader_names[GLLOADER_COUNT] = {"]
+    lines.extend("\t\"{0}\",".format(name) for name, result, parameters in functions)
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def define(functions):
+    lines = []
+    for name, result, parameters in functions:
+        call = "GLLoader_{0}({1})".format(name, arguments(parameters))
+        fallback = "" if result == "void" else "\treturn 0;\n"
+
+        lines.append("static {0} GLLOADER_APIENTRY missing_{1}({2})".format(result, name, types(parameters)))
+        lines.append("{")
+        lines.append(fallback + "}" if fallback else "}")
+        lines.append("")
+        lines.append("static {0} GLLOADER_APIENTRY load_{1}({2})".format(result, name, parameters))
+        lines.append("{")
+        lines.append("\tGLLoader_{0} = (PFN_{0})resolve(\"{0}\", (void *)missing_{0});".format(name))
+        lines.append("\t{0}{1};".format("" if result == "void" else "return ", call))
+        lines.append("}")
+        lines.append("")
+        lines.append("PFN_{0} GLLoader_{0} = load_{0};".format(name))
+        lines.append("")
+    return "\n".join(lines)
+
+
+HEADER = NOTICE + """
+#ifndef __GL_LOADER_H__
+#define __GL_LOADER_H__
+
+/* The GL entry points of the bridge, in place of GLEW: every one of them is resolved in the
+ * context current at its first call, and only if it is called. No system GL header is needed,
+ * none is to be included with this one.
+ *
+ * The entry points of GL 1.1 are the same in every context, the others are too as long as the
+ * contexts are of the same device (as GLEW assumes as well) */
+
+#if defined(__gl_h_) || defined(__GL_H__) || defined(__glew_h__)
+#error "GLLoader.h replaces the GL headers"
+#endif
+
+#include <stdint.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#define GLLOADER_APIENTRY __stdcall
+#else
+#define GLLOADER_APIENTRY
+#endif
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned int GLuint;
+typedef unsigned char GLubyte;
+typedef uint64_t GLuint64;
+typedef struct __GLsync *GLsync;
+
+{enums}
+
+/* entry points, resolved by their first call */
+
+{functions}
+#if defined(_WIN32) || defined(_WIN64)
+{wgl_functions}#endif
+
+/* names of the GL entry points above, WGL excluded */
+#define GLLOADER_COUNT {count}
+extern const char *const GLLoader_names[GLLOADER_COUNT];
+
+/* address of an entry point in the current context, nullptr if it has none */
+void *GLLoader_getProcAddress(const char *name);
+
+/* entry points resolved so far */
+unsigned int GLLoader_getResolved(void);
+
+/* the current context is at least of the version major.minor */
+bool GLLoader_isVersion(const int major, const int minor);
+
+/* the current context has the extension */
+bool GLLoader_hasExtension(const char *name);
+
+#endif /* __GL_LOADER_H__ */
+"""
+
+SOURCE = NOTICE + """
+#include "GLLoader.h"
+#include "Log.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <dlfcn.h>
+#endif
+
+static std::atomic<unsigned int> s_resolved(0);
+
+#if defined(_WIN32) || defined(_WIN64)
+
+void *GLLoader_getProcAddress(const char *name)
+{
+	void *proc = (void *)wglGetProcAddress(name);
+
+	/* some drivers return a small value instead of nullptr, GL 1.1 is only in opengl32 */
+	if ((uintptr_t)proc <= 3 || proc == (void *)-1) {
+		static HMODULE opengl = LoadLibraryA("opengl32.dll");
+		proc = opengl ? (void *)GetProcAddress(opengl, name) : nullptr;
+	}
+	return proc;
+}
+
+#else
+
+typedef void *(*PFN_getProcAddress)(const char *name);
+
+static void *openLibrary(const char *const *names)
+{
+	for (int i = 0; names[i]; i++) {
+		void *library = dlopen(names[i], RTLD_LAZY | RTLD_LOCAL);
+
+		if (library) {
+			return library;
+		}
+	}
+	return nullptr;
+}
+
+void *GLLoader_getProcAddress(const char *name)
+{
+#if defined(__APPLE__)
+	static const char *const gl_names[] = { "/System/Library/Frameworks/OpenGL.framework/OpenGL", nullptr };
+	static void *gl = openLibrary(gl_names);
+	return gl ? dlsym(gl, name) : nullptr;
+#else
+	/* the libraries of the vendor neutral dispatch, or of the driver */
+	static const char *const gl_names[] = { "libOpenGL.so.0", "libGL.so.1", nullptr };
+	static const char *const glx_names[] = { "libGL.so.1", "libGLX.so.0", nullptr };
+	static const char *const egl_names[] = { "libEGL.so.1", nullptr };
+
+	static void *gl = openLibrary(gl_names);
+	static void *glx = openLibrary(glx_names);
+	static void *egl = openLibrary(egl_names);
+	static PFN_getProcAddress glx_proc = glx ? (PFN_getProcAddress)dlsym(glx, "glXGetProcAddressARB") : nullptr;
+	static PFN_getProcAddress egl_proc = egl ? (PFN_getProcAddress)dlsym(egl, "eglGetProcAddress") : nullptr;
+
+	void *proc = gl ? dlsym(gl, name) : nullptr;
+
+	if (!proc && egl_proc) {
+		proc = egl_proc(name);
+	}
+
+	if (!proc && glx_proc) {
+		proc = glx_proc(name);
+	}
+	return proc;
+#endif
+}
+
+#endif
+
+/* the entry point, or the missing one that does nothing */
+static void *resolve(const char *name, void *missing)
+{
+	void *proc = GLLoader_getProcAddress(name);
+	s_resolved++;
+
+	if (!proc) {
+		BRIDGE_LOG_ERROR("GL entry point %s is missing", name);
+		return missing;
+	}
+	return proc;
+}
+
+unsigned int GLLoader_getResolved(void)
+{
+	return s_resolved;
+}
+
+bool GLLoader_isVersion(const int major, const int minor)
+{
+	const char *version = (const char *)glGetString(GL_VERSION);
+	int context_major = 0, context_minor = 0;
+
+	if (!version) {
+		return false;
+	}
+
+	/* "major.minor", after "OpenGL ES " on embedded systems */
+	while (*version && (*version < '0' || *version > '9')) {
+		version++;
+	}
+
+	if (sscanf(version, "%d.%d", &context_major, &context_minor) != 2) {
+		return false;
+	}
+	return context_major > major || (context_major == major && context_minor >= minor);
+}
+
+bool GLLoader_hasExtension(const char *name)
+{
+	if (GLLoader_isVersion(3, 0)) {
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		for (GLint i = 0; i < count; i++) {
+			const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, i);
+
+			if (extension && strcmp(extension, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/* a single string, separated by spaces */
+	const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+	const size_t length = strlen(name);
+
+	for (const char *found = extensions ? strstr(extensions, name) : nullptr; found; found = strstr(found + length, name)) {
+		const bool is_start = (found == extensions || found[-1] == ' ');
+		const bool is_end = (found[length] == ' ' || found[length] == '\\0');
+
+		if (is_start && is_end) {
+			return true;
+		}
+	}
+	return false;
+}
+
+{functions}
+{names}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+{wgl_functions}#endif
+"""
+
+
+def main():
+    directory = os.path.dirname(os.path.abspath(__file__))
+    enums = "\n".join("#define {0} {1}".format(name, value) for name, value in GL_ENUMS)
+
+    with open(os.path.join(directory, "GLLoader.h"), "w", newline="\n") as header:
+        header.write(HEADER
+                     .replace("{enums}", enums)
+                     .replace("{count}", str(len(GL_FUNCTIONS)))
+                     .replace("{functions}", declare(GL_FUNCTIONS))
+                     .replace("{wgl_functions}", declare(WGL_FUNCTIONS)))
+
+    with open(os.path.join(directory, "GLLoader.cpp"), "w", newline="\n") as source:
+        source.write(SOURCE
+                     .replace("{functions}", define(GL_FUNCTIONS))
+                     .replace("{names}", names(GL_FUNCTIONS))
+                     .replace("{wgl_functions}", define(WGL_FUNCTIONS)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,39 @@
+"""
+Cost of the Python wrapper per frame, driven by a recorded trace
+
+usage: python bench-replay.py trace [frames]
+"""
+
+import sys
+import time
+
+import bridge
+
+
+def bench_replay(filepath, frames):
+    from bridge.hmd.backend import FrameState
+    from bridge.hmd.replay import HMD
+
+    hmd = HMD(filepath)
+    start = hmd.time
+
+    begin = time.perf_counter()
+    for i in range(frames):
+        if not hmd.frameState(FrameState.ORIENTATION | FrameState.POSITION):
+            # end of the recording, start over
+            hmd.seek(start)
+
+        hmd.getProjectionMatrixLeft(0.1, 100.0)
+        hmd.getProjectionMatrixRight(0.1, 100.0)
+        hmd.frameReady()
+
+    elapsed = time.perf_counter() - begin
+    print("{0} frames, per frame: {1:.2f} us".format(frames, elapsed * 1e6 / frames))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    bench_replay(sys.argv[1], int(sys.argv[2]) if len(sys.argv) > 2 else 100000)
@@ -0,0 +1,99 @@
+/* Call overhead of the bridge: through the C API and the runtime dispatch of HMD, Backend and
+ * BackendImpl, against the same simulated device bound at compile time with HMDT, and through
+ * the HMDStatic_ API when the library is built with STATIC_BACKEND=Simulated.
+ *
+ * The size of the eye is the dispatch alone, update is the whole pose path.
+ *
+ * usage: bench_dispatch [calls] */
+
+#include "HMD_Bridge_API.h"
+#include "HMDT.h"
+#include "Simulated.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Pose
+{
+	float orientation[2][4];
+	float position[2][3];
+};
+
+/* nanoseconds per call */
+template <typename Call>
+static double measure(const int calls, Call call)
+{
+	Pose pose = {};
+	float checksum = 0.0f;
+
+	const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < calls; i++) {
+		checksum += call(&pose);
+	}
+	const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+	if (checksum == 12345.0f) {
+		printf("(checksum %g)\n", checksum);
+	}
+	return elapsed / calls;
+}
+
+int main(int argc, char **argv)
+{
+	const int calls = argc > 1 ? atoi(argv[1]) : 1000000;
+
+	/* the default configuration of the HMDStatic_ API, its clock is realtime */
+	HMD_SimulatedConfig config;
+	HMD_simulatedConfigDefault(&config);
+
+	HMD *hmd = HMD_newSimulated(&config);
+	HMDT<SimulatedImpl> bound(config);
+
+	/* read through a volatile pointer, the inlined call is not hoisted out of the loop */
+	HMDT<SimulatedImpl> *volatile bound_pointer = &bound;
+
+	printf("%d calls\n", calls);
+
+	printf("width, HMD_widthLeft: %.1f ns\n", measure(calls, [hmd](Pose *) {
+		return (float)HMD_widthLeft(hmd);
+	}));
+
+	printf("width, HMDT<SimulatedImpl>: %.1f ns\n", measure(calls, [bound_pointer](Pose *) {
+		return (float)bound_pointer->getWidthLeft();
+	}));
+
+	printf("update, HMD_update: %.1f ns\n", measure(calls, [hmd](Pose *r_pose) {
+		if (!HMD_update(hmd, r_pose->orientation[0], r_pose->position[0], r_pose->orientation[1], r_pose->position[1])) {
+			return 0.0f;
+		}
+		return r_pose->orientation[0][1] + r_pose->position[1][2];
+	}));
+
+	printf("update, HMDT<SimulatedImpl>: %.1f ns\n", measure(calls, [&bound](Pose *r_pose) {
+		if (!bound.update(r_pose->orientation[0], r_pose->position[0], r_pose->orientation[1], r_pose->position[1])) {
+			return 0.0f;
+		}
+		return r_pose->orientation[0][1] + r_pose->position[1][2];
+	}));
+
+#if defined STATIC_BACKEND
+	HMDStatic *hmd_static = HMDStatic_new();
+
+	printf("width, HMDStatic_widthLeft: %.1f ns\n", measure(calls, [hmd_static](Pose *) {
+		return (float)HMDStatic_widthLeft(hmd_static);
+	}));
+
+	printf("update, HMDStatic_update: %.1f ns\n", measure(calls, [hmd_static](Pose *r_pose) {
+		if (!HMDStatic_update(hmd_static, r_pose->orientation[0], r_pose->position[0], r_pose->orientation[1], r_pose->position[1])) {
+			return 0.0f;
+		}
+		return r_pose->orientation[0][1] + r_pose->position[1][2];
+	}));
+
+	HMDStatic_del(hmd_static);
+#endif
+
+	HMD_del(hmd);
+	return 0;
+}
@@ -0,0 +1,65 @@
+/* Bridge overhead per frame, through the C API: frame state, projection matrices and submission.
+ * The frames are driven by a recorded trace played as fast as possible, or by the simulated
+ * device with the virtual vsync not waited for.
+ *
+ * usage: bench_frame_state [frames] [trace] */
+
+#include "HMD_Bridge_API.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv)
+{
+	const int frames = argc > 1 ? atoi(argv[1]) : 1000000;
+	const char *trace_path = argc > 2 ? argv[2] : nullptr;
+	HMD *hmd;
+
+	if (trace_path) {
+		hmd = HMD_newReplay(trace_path, false);
+
+		if (!hmd) {
+			fprintf(stderr, "trace \"%s\" could not be opened\n", trace_path);
+			return 1;
+		}
+	}
+	else {
+		HMD_SimulatedConfig config;
+		HMD_simulatedConfigDefault(&config);
+		config.is_realtime = 0;
+
+		hmd = HMD_newSimulated(&config);
+	}
+
+	HMD_FrameState state;
+	float projection[2][16];
+	float checksum = 0.0f;
+	int loops = 0;
+
+	state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION | HMD_FRAME_VIEW_MATRIX;
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; i++) {
+		if (!HMD_frameState(hmd, &state) && trace_path) {
+			/* end of the recording, start over */
+			HMD_replaySeek(hmd, 0.0);
+			loops++;
+		}
+
+		HMD_projectionMatrices(hmd, 0.1f, 100.0f, projection[0], projection[1]);
+		HMD_frameReady(hmd);
+
+		checksum += state.view_matrix[0][12] + projection[1][8];
+	}
+	const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+	printf("%d frames, %s (checksum %g)\n", frames, trace_path ? "replay" : "simulated", checksum);
+	if (trace_path) {
+		printf("trace played %d times\n", loops);
+	}
+	printf("per frame: %.1f ns\n", elapsed / frames);
+
+	HMD_del(hmd);
+	return 0;
+}
@@ -0,0 +1,74 @@
+/* GL loading at backend construction: glewInit, that resolves every entry point GLEW knows,
+ * against the generated loader, that resolves the entry points of the bridge by their first call.
+ * Here the loader resolves all of them at once, the most it does over a session.
+ *
+ * The first run of each is cold (the loader opens the GL libraries then), the others are the
+ * average of the runs after it.
+ *
+ * usage: bench_gl_loader [runs] */
+
+#include "GLLoader.h"
+
+#include "egl_context.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* glew.h can't be included with GLLoader.h */
+extern "C" GLenum glewInit(void);
+
+/* microseconds of the first run, and of the average of the others */
+template <typename Load>
+static void measure(const char *name, const int runs, Load load)
+{
+	double first = 0.0, total = 0.0;
+
+	for (int run = 0; run < runs; run++) {
+		const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		load();
+		const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+		if (run == 0) {
+			first = elapsed;
+		}
+		else {
+			total += elapsed;
+		}
+	}
+
+	printf("%s: first %.1f us, then %.1f us\n", name, first, runs > 1 ? total / (runs - 1) : first);
+}
+
+int main(int argc, char **argv)
+{
+	const int runs = argc > 1 ? atoi(argv[1]) : 100;
+
+	/* compatibility context, GLEW 1.x reads the extensions of GL 2 */
+	if (!createEGLContext(NULL)) {
+		printf("no EGL context\n");
+		return 1;
+	}
+
+	printf("%d runs\n", runs);
+
+	char name[64];
+	snprintf(name, sizeof(name), "generated loader, %d entry points", GLLOADER_COUNT);
+
+	measure(name, runs, []() {
+		int found = 0;
+		for (const char *entry : GLLoader_names) {
+			found += GLLoader_getProcAddress(entry) != nullptr;
+		}
+
+		if (found != GLLOADER_COUNT) {
+			printf("%d entry points found\n", found);
+		}
+	});
+
+	measure("glewInit", runs, []() {
+		glewInit();
+	});
+
+	return 0;
+}
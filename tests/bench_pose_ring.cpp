@@ -0,0 +1,72 @@
+/* Contention benchmark of the pose ring: one writer publishing at the sensor rate
+ * (or as fast as possible) against several render threads reading the latest pose.
+ *
+ * usage: bench_pose_ring [readers] [writer_hz, 0 for unthrottled] [seconds] */
+
+#include "Pose.h"
+#include "PoseRing.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+	const int readers = argc > 1 ? atoi(argv[1]) : 2;
+	const double writer_hz = argc > 2 ? atof(argv[2]) : 0.0;
+	const double seconds = argc > 3 ? atof(argv[3]) : 2.0;
+
+	PoseRing<PoseSample, 16> ring;
+	std::atomic<bool> running(true);
+	std::vector<unsigned long long> reads(readers, 0);
+	std::vector<double> worst(readers, 0.0);
+
+	std::thread writer([&]() {
+		PoseSample sample = {};
+		std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+		while (running.load(std::memory_order_relaxed)) {
+			sample.frame++;
+			ring.publish(sample);
+
+			if (writer_hz > 0.0) {
+				next += std::chrono::nanoseconds((long long)(1e9 / writer_hz));
+				std::this_thread::sleep_until(next);
+			}
+		}
+	});
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < readers; i++) {
+		threads.push_back(std::thread([&, i]() {
+			PoseSample sample;
+			while (running.load(std::memory_order_relaxed)) {
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				ring.readLatest(&sample);
+				const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+				if (elapsed > worst[i]) {
+					worst[i] = elapsed;
+				}
+				reads[i]++;
+			}
+		}));
+	}
+
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+	running = false;
+
+	writer.join();
+	for (size_t i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+
+	printf("writer: %llu samples (%.0f Hz)\n", ring.count(), ring.count() / seconds);
+	for (int i = 0; i < readers; i++) {
+		printf("reader %d: %.1f Mreads/s, %.1f ns/read, worst %.0f ns\n",
+		       i, reads[i] / seconds * 1e-6, seconds * 1e9 / reads[i], worst[i]);
+	}
+	return 0;
+}
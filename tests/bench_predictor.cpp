@@ -0,0 +1,115 @@
+/* Prediction error versus CPU cost of the bridge-side predictors.
+ *
+ * The motion is a recorded-like head trajectory: slow drift, fast saccade-like
+ * turns and nodding, sampled at the sensor rate, predicted at several horizons.
+ *
+ * usage: bench_predictor [sensor_hz] [seconds] */
+
+#include "Predictor.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static void headMotion(const double t, PoseSample *r_sample)
+{
+	/* yaw sweeps with quick turns, pitch nods, a bit of roll, sway of the torso */
+	const double yaw = 0.6 * sin(0.7 * t) + 0.4 * tanh(4.0 * sin(0.25 * t));
+	const double pitch = 0.25 * sin(1.9 * t + 0.3) + 0.05 * sin(7.0 * t);
+	const double roll = 0.08 * sin(1.3 * t);
+
+	const float cy = (float)cos(yaw * 0.5), sy = (float)sin(yaw * 0.5);
+	const float cp = (float)cos(pitch * 0.5), sp = (float)sin(pitch * 0.5);
+	const float cr = (float)cos(roll * 0.5), sr = (float)sin(roll * 0.5);
+
+	/* yaw * pitch * roll */
+	const float qy[4] = { cy, 0.0f, sy, 0.0f };
+	const float qp[4] = { cp, sp, 0.0f, 0.0f };
+	const float qr[4] = { cr, 0.0f, 0.0f, sr };
+	float q[4];
+
+	poseMultiply(qy, qp, q);
+	poseMultiply(q, qr, r_sample->head_orientation);
+
+	r_sample->time = t;
+	r_sample->status = HMD_STATUS_ORIENTATION_TRACKED | HMD_STATUS_POSITION_TRACKED;
+	r_sample->head_position[0] = (float)(0.05 * sin(0.9 * t));
+	r_sample->head_position[1] = (float)(1.6 + 0.02 * sin(2.1 * t));
+	r_sample->head_position[2] = (float)(0.03 * sin(0.5 * t));
+
+	for (int eye = 0; eye < 2; eye++) {
+		memcpy(r_sample->orientation[eye], r_sample->head_orientation, sizeof(float[4]));
+		memcpy(r_sample->position[eye], r_sample->head_position, sizeof(float[3]));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const double sensor_hz = argc > 1 ? atof(argv[1]) : 1000.0;
+	const double seconds = argc > 2 ? atof(argv[2]) : 20.0;
+	const int count = (int)(sensor_hz * seconds);
+
+	std::vector<PoseSample> motion(count);
+	for (int i = 0; i < count; i++) {
+		headMotion(i / sensor_hz, &motion[i]);
+	}
+
+	const eHMDPredictor types[] = { HMD_PREDICTOR_NONE, HMD_PREDICTOR_CONSTANT_VELOCITY, HMD_PREDICTOR_ANGULAR_VELOCITY, HMD_PREDICTOR_CONSTANT_ACCELERATION };
+	const char *names[] = { "none", "constant velocity", "angular velocity", "constant acceleration" };
+	const double horizons[] = { 0.011, 0.022, 0.044 };
+
+	printf("%d samples at %.0f Hz\n", count, sensor_hz);
+	printf("%-22s %8s %12s %12s %12s %10s\n", "predictor", "horizon", "mean (deg)", "max (deg)", "mean (mm)", "ns/pred");
+
+	for (size_t h = 0; h < sizeof(horizons) / sizeof(horizons[0]); h++) {
+		for (size_t p = 0; p < sizeof(types) / sizeof(types[0]); p++) {
+			PoseHistory history;
+			Predictor predictor;
+			predictor.set(types[p], horizons[h]);
+
+			double angle_sum = 0.0, angle_max = 0.0, position_sum = 0.0, elapsed = 0.0;
+			int predictions = 0;
+
+			for (int i = 0; i < count; i++) {
+				history.add(motion[i]);
+
+				/* wait for the history to be filled by all the models */
+				if (i < 2) {
+					continue;
+				}
+
+				PoseSample prediction = motion[i];
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				predictor.predict(history, &prediction);
+				elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+				PoseSample truth;
+				headMotion(motion[i].time + horizons[h], &truth);
+
+				/* angle of the rotation between both, acos(dot) lacks precision for small angles */
+				const float truth_inv[4] = { truth.head_orientation[0], -truth.head_orientation[1], -truth.head_orientation[2], -truth.head_orientation[3] };
+				float delta[4];
+				poseMultiply(prediction.head_orientation, truth_inv, delta);
+
+				const double sin_half = sqrt((double)delta[1] * delta[1] + (double)delta[2] * delta[2] + (double)delta[3] * delta[3]);
+				const double angle = 2.0 * atan2(sin_half, fabs((double)delta[0])) * 180.0 / M_PI;
+
+				double distance = 0.0;
+				for (int k = 0; k < 3; k++) {
+					distance += (prediction.head_position[k] - truth.head_position[k]) * (prediction.head_position[k] - truth.head_position[k]);
+				}
+
+				angle_sum += angle;
+				angle_max = angle > angle_max ? angle : angle_max;
+				position_sum += sqrt(distance) * 1000.0;
+				predictions++;
+			}
+
+			printf("%-22s %6.0fms %12.4f %12.4f %12.4f %10.1f\n", names[p], horizons[h] * 1000.0,
+			       angle_sum / predictions, angle_max, position_sum / predictions, elapsed / predictions);
+		}
+	}
+	return 0;
+}
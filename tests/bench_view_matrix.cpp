@@ -0,0 +1,85 @@
+/* View matrices of both eyes: original LookAt path, scalar and SIMD kernels.
+ *
+ * usage: bench_view_matrix [iterations] */
+
+#include "ViewMatrix.h"
+
+#include "reference_view_matrix.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(BRIDGE_VIEW_MATRIX_AVX)
+static const char *kernel_name = "AVX";
+#elif defined(BRIDGE_VIEW_MATRIX_SSE)
+static const char *kernel_name = "SSE";
+#else
+static const char *kernel_name = "scalar fallback";
+#endif
+
+/* every matrix is kept, so no entry can be optimized away */
+template <typename Function>
+static double measure(const std::vector<PoseSample> &samples, const int iterations, Function function, float *r_checksum)
+{
+	std::vector<float> matrices(samples.size() * 32);
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		const size_t index = i % samples.size();
+		function(samples[index], (float (*)[16])&matrices[index * 32]);
+	}
+	const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+	float checksum = 0.0f;
+	for (size_t i = 0; i < matrices.size(); i++) {
+		checksum += matrices[i];
+	}
+
+	*r_checksum = checksum;
+	return elapsed / iterations;
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 10000000;
+
+	std::vector<PoseSample> samples(1024);
+	for (size_t i = 0; i < samples.size(); i++) {
+		PoseSample &sample = samples[i];
+		memset(&sample, 0, sizeof(sample));
+
+		const float angle = i * 0.01f;
+		for (int eye = 0; eye < 2; eye++) {
+			sample.orientation[eye][0] = cosf(angle);
+			sample.orientation[eye][1] = 0.3f * sinf(angle);
+			sample.orientation[eye][2] = 0.9f * sinf(angle);
+			sample.orientation[eye][3] = 0.3f * sinf(angle);
+			sample.position[eye][0] = eye ? 0.032f : -0.032f;
+			sample.position[eye][1] = 1.6f + 0.01f * sinf(angle);
+		}
+	}
+
+	float checksum[3];
+
+	const double reference = measure(samples, iterations, [](const PoseSample &sample, float matrix[2][16]) {
+		referenceViewMatrix(sample.orientation[0], sample.position[0], true, matrix[0]);
+		referenceViewMatrix(sample.orientation[1], sample.position[1], true, matrix[1]);
+	}, &checksum[0]);
+
+	const double scalar = measure(samples, iterations, [](const PoseSample &sample, float matrix[2][16]) {
+		poseStereoViewMatrixScalar(sample, true, matrix);
+	}, &checksum[1]);
+
+	const double kernel = measure(samples, iterations, [](const PoseSample &sample, float matrix[2][16]) {
+		poseStereoViewMatrix(sample, true, matrix);
+	}, &checksum[2]);
+
+	printf("both eyes, %d iterations (checksums %g %g %g)\n", iterations, checksum[0], checksum[1], checksum[2]);
+	printf("LookAt path: %6.2f ns\n", reference);
+	printf("scalar: %6.2f ns (%.2fx)\n", scalar, reference / scalar);
+	printf("%s kernel: %6.2f ns (%.2fx)\n", kernel_name, kernel, reference / kernel);
+	return 0;
+}
@@ -0,0 +1,22 @@
+/* Simulated device built as a plugin, loaded by test_plugins */
+
+#include "Plugin.h"
+#include "Simulated.h"
+
+#if !defined(TEST_PLUGIN_ABI)
+
+HMD_PLUGIN("Simulated", Simulated)
+
+#else
+
+/* built against another version of the bridge */
+static Backend *create(void) { return new Simulated(); }
+static void destroy(Backend *backend) { delete backend; }
+
+HMD_PLUGIN_EXPORT const HMD_Plugin *HMD_pluginEntry(void)
+{
+	static const HMD_Plugin plugin = { TEST_PLUGIN_ABI, "Simulated", create, destroy, nullptr };
+	return &plugin;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef __REFERENCE_VIEW_MATRIX_H__
+#define __REFERENCE_VIEW_MATRIX_H__
+
+#include <math.h>
+
+/* The original view matrix path of the Oculus backend: quaternion to rotation matrix,
+ * transform the up and forward vectors, Matrix4f::LookAtRH/LookAtLH, then transpose */
+
+static void referenceCross(const float *a, const float *b, float *r)
+{
+	r[0] = a[1] * b[2] - a[2] * b[1];
+	r[1] = a[2] * b[0] - a[0] * b[2];
+	r[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static void referenceNormalize(float *v)
+{
+	const float len = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	v[0] /= len;
+	v[1] /= len;
+	v[2] /= len;
+}
+
+static void referenceViewMatrix(const float *q, const float *pos, const bool is_right_hand, float *r_matrix)
+{
+	const float w = q[0], x = q[1], y = q[2], z = q[3];
+	const float ww = w * w, xx = x * x, yy = y * y, zz = z * z;
+
+	/* Matrix4f(Quatf) */
+	const float rot[3][3] = {
+		{ ww + xx - yy - zz, 2 * (x * y - w * z), 2 * (x * z + w * y) },
+		{ 2 * (x * y + w * z), ww - xx + yy - zz, 2 * (y * z - w * x) },
+		{ 2 * (x * z - w * y), 2 * (y * z + w * x), ww - xx - yy + zz },
+	};
+
+	float up[3], forward[3];
+	for (int i = 0; i < 3; i++) {
+		up[i] = rot[i][1];
+		forward[i] = -rot[i][2];
+	}
+
+	/* LookAt(eye, eye + forward, up) */
+	float axis_z[3], axis_x[3], axis_y[3];
+	for (int i = 0; i < 3; i++) {
+		axis_z[i] = is_right_hand ? -forward[i] : forward[i];
+	}
+	referenceNormalize(axis_z);
+	referenceCross(up, axis_z, axis_x);
+	referenceNormalize(axis_x);
+	referenceCross(axis_z, axis_x, axis_y);
+
+	const float *rows[3] = { axis_x, axis_y, axis_z };
+	float m[4][4];
+
+	for (int r = 0; r < 3; r++) {
+		m[r][0] = rows[r][0];
+		m[r][1] = rows[r][1];
+		m[r][2] = rows[r][2];
+		m[r][3] = -(rows[r][0] * pos[0] + rows[r][1] * pos[1] + rows[r][2] * pos[2]);
+	}
+	m[3][0] = m[3][1] = m[3][2] = 0.0f;
+	m[3][3] = 1.0f;
+
+	/* formatMatrix */
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			r_matrix[i * 4 + j] = m[j][i];
+}
+
+#endif /* __REFERENCE_VIEW_MATRIX_H__ */
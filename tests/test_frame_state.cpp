@@ -0,0 +1,154 @@
+/* HMD_FrameState: one tracking sample per frame, all representations from it */
+
+#include "Backend.h"
+
+#include "test_utils.h"
+
+/* backend with a known pose, counting the tracking queries */
+class CountingImpl : public FakeImpl
+{
+public:
+	int samples;
+	float yaw;
+
+	CountingImpl() : samples(0), yaw(1.5707963f) {}
+
+	bool sampleTracking(const unsigned int frame, PoseSample *r_sample)
+	{
+		/* rotation around +y */
+		const float orientation[4] = { cosf(this->yaw * 0.5f), 0.0f, sinf(this->yaw * 0.5f), 0.0f };
+
+		this->samples++;
+		memset(r_sample, 0, sizeof(PoseSample));
+		r_sample->frame = frame;
+		r_sample->time = frame / 90.0;
+		r_sample->status = HMD_STATUS_ORIENTATION_TRACKED | HMD_STATUS_POSITION_TRACKED;
+
+		for (int eye = 0; eye < 2; eye++) {
+			memcpy(r_sample->orientation[eye], orientation, sizeof(orientation));
+			r_sample->position[eye][0] = eye ? 0.032f : -0.032f;
+			r_sample->position[eye][1] = 1.6f;
+			r_sample->position[eye][2] = 0.5f;
+		}
+		return true;
+	}
+};
+
+static void test_single_sample(void)
+{
+	CountingImpl impl;
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_YAW_PITCH_ROLL | HMD_FRAME_POSITION | HMD_FRAME_VIEW_MATRIX;
+
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.samples == 1);
+	CHECK(state.frame == 0);
+
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.samples == 2);
+	CHECK(state.frame == 1);
+
+	for (int eye = 0; eye < 2; eye++) {
+		CHECK_NEAR(state.yaw_pitch_roll[eye][0], 1.5707963, 1e-5);
+		CHECK_NEAR(state.yaw_pitch_roll[eye][1], 0.0, 1e-5);
+		CHECK_NEAR(state.yaw_pitch_roll[eye][2], 0.0, 1e-5);
+		CHECK_NEAR(state.position[eye][1], 1.6, 1e-6);
+	}
+}
+
+static void test_view_matrix(void)
+{
+	CountingImpl impl;
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_VIEW_MATRIX;
+	CHECK(impl.getFrameState(&state));
+
+	/* the view matrix brings the eye position to the origin */
+	for (int eye = 0; eye < 2; eye++) {
+		const float *m = state.view_matrix[eye];
+		const float p[3] = { eye ? 0.032f : -0.032f, 1.6f, 0.5f };
+
+		for (int row = 0; row < 3; row++) {
+			CHECK_NEAR(m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row], 0.0, 1e-5);
+		}
+
+		/* 90 degrees yaw: looking down -x, so -x maps to -z in view space */
+		CHECK_NEAR(m[2], 1.0, 1e-5);
+		CHECK_NEAR(m[15], 1.0, 1e-6);
+	}
+
+	state.flags = HMD_FRAME_VIEW_MATRIX | HMD_FRAME_LEFT_HANDED;
+	CHECK(impl.getFrameState(&state));
+	CHECK_NEAR(state.view_matrix[0][2], -1.0, 1e-5);
+}
+
+static void test_legacy_update(void)
+{
+	CountingImpl impl;
+	float orientation[2][4], position[2][3], ypr[2][3];
+
+	CHECK(impl.update(
+		&ypr[0][0], &ypr[0][1], &ypr[0][2], orientation[0], position[0],
+		&ypr[1][0], &ypr[1][1], &ypr[1][2], orientation[1], position[1]));
+
+	CHECK(impl.samples == 1);
+	CHECK_NEAR(orientation[1][0], sqrtf(0.5f), 1e-6);
+	CHECK_NEAR(ypr[1][0], 1.5707963, 1e-5);
+
+	impl.setScale(10.0f);
+	CHECK(impl.update(orientation[0], position[0], orientation[1], position[1]));
+	CHECK_NEAR(position[0][1], 16.0, 1e-5);
+}
+
+static void test_cached_representations(void)
+{
+	CountingImpl impl;
+	HMD_FrameState state;
+	float view[2][16], inverse[2][16], ypr[2][3];
+
+	/* nothing to read before the first frame */
+	CHECK(!impl.getViewMatrix(true, view[0], view[1]));
+
+	state.flags = HMD_FRAME_VIEW_MATRIX | HMD_FRAME_INVERSE_VIEW_MATRIX;
+	CHECK(impl.getFrameState(&state));
+
+	/* reading the current frame does not query the tracking again */
+	CHECK(impl.getViewMatrix(true, view[0], view[1]));
+	CHECK(impl.getInverseViewMatrix(true, inverse[0], inverse[1]));
+	CHECK(impl.getYawPitchRoll(ypr[0], ypr[1]));
+	CHECK(impl.samples == 1);
+
+	for (int eye = 0; eye < 2; eye++) {
+		CHECK(memcmp(view[eye], state.view_matrix[eye], sizeof(view[eye])) == 0);
+		CHECK(memcmp(inverse[eye], state.inverse_view_matrix[eye], sizeof(inverse[eye])) == 0);
+
+		/* view * inverse == identity */
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				float sum = 0.0f;
+				for (int k = 0; k < 4; k++) {
+					sum += view[eye][k * 4 + i] * inverse[eye][j * 4 + k];
+				}
+				CHECK_NEAR(sum, i == j ? 1.0 : 0.0, 1e-5);
+			}
+		}
+	}
+
+	/* a new frame invalidates the cached values */
+	impl.yaw = 0.0f;
+	state.flags = 0;
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.getYawPitchRoll(ypr[0], ypr[1]));
+	CHECK(impl.getViewMatrix(true, view[0], view[1]));
+	CHECK_NEAR(ypr[0][0], 0.0, 1e-6);
+	CHECK_NEAR(view[0][0], 1.0, 1e-6);
+}
+
+int main(void)
+{
+	test_single_sample();
+	test_view_matrix();
+	test_legacy_update();
+	test_cached_representations();
+	return 0;
+}
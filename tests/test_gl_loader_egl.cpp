@@ -0,0 +1,115 @@
+/* the generated GL loader in a real context: headless EGL, e.g. Mesa llvmpipe on the CI machines */
+
+#include "GLLoader.h"
+
+#include "egl_context.h"
+#include "test_utils.h"
+
+#include <stdio.h>
+
+/* GL 3.3 context, false when the platform has none */
+static bool createContext(void)
+{
+	const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3, EGL_NONE };
+	return createEGLContext(attributes);
+}
+
+static void test_lazy(void)
+{
+	/* nothing is resolved until it is called */
+	CHECK(GLLoader_getResolved() == 0);
+
+	GLint binding = -1;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &binding);
+	CHECK(GLLoader_getResolved() == 1);
+	CHECK(binding == 0);
+
+	/* once */
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &binding);
+	CHECK(GLLoader_getResolved() == 1);
+	CHECK(binding == 0);
+}
+
+static void test_queries(void)
+{
+	CHECK(GLLoader_isVersion(3, 3));
+	CHECK(GLLoader_isVersion(1, 5));
+	CHECK(!GLLoader_isVersion(9, 0));
+	CHECK(!GLLoader_isVersion(99, 0));
+
+	CHECK(!GLLoader_hasExtension("GL_BRIDGE_not_an_extension"));
+	CHECK(!GLLoader_hasExtension("GL_ARB"));
+
+	/* not the reverse, eglGetProcAddress of Mesa has a stub for any name */
+	CHECK(GLLoader_getProcAddress("glBlitFramebuffer") != nullptr);
+}
+
+/* the calls of Oculus::frameReady, on entry points of GL 1.1 and after it */
+static void test_blit(void)
+{
+	const int size = 64;
+	GLuint textures[2], framebuffers[2];
+
+	glGenTextures(2, textures);
+	glGenFramebuffers(2, framebuffers);
+
+	for (int i = 0; i < 2; i++) {
+		glBindTexture(GL_TEXTURE_2D, textures[i]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[i], 0);
+	}
+
+	GLuint query;
+	glGenQueries(1, &query);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+	glBlitFramebuffer(0, 0, size, size, 0, 0, size, size, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glQueryCounter(query, GL_TIMESTAMP);
+
+	GLint binding = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &binding);
+	CHECK(binding == (GLint)framebuffers[1]);
+
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	CHECK(fence != nullptr);
+	glFlush();
+	glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+	glDeleteSync(fence);
+
+	/* the timestamp is there once the commands are done */
+	GLint available = 0;
+	for (int i = 0; i < 1000 && !available; i++) {
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+	}
+
+	GLuint64 timestamp = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &timestamp);
+	CHECK(timestamp > 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteQueries(1, &query);
+	glDeleteFramebuffers(2, framebuffers);
+	glDeleteTextures(2, textures);
+
+	/* each entry point resolved once: the 3 of the tests above, the 19 called here */
+	glBindTexture(GL_TEXTURE_2D, 0);
+	CHECK(GLLoader_getResolved() == 3 + 19);
+}
+
+int main(void)
+{
+	if (!createContext()) {
+		/* not a failure, the machine has no GL */
+		printf("no EGL context, skipped\n");
+		return TEST_SKIPPED;
+	}
+
+	test_lazy();
+	test_queries();
+	test_blit();
+	return 0;
+}
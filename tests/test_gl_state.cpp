@@ -0,0 +1,146 @@
+/* GL state shadowed by the bridge, against a fake context */
+
+#include "GLState.h"
+
+#include "test_utils.h"
+
+/* the fake context: current bindings and the calls it received */
+static unsigned int g_draw, g_read, g_texture;
+static bool g_srgb;
+static int g_binds, g_queries, g_caps;
+
+static void fakeBindFramebuffer(const unsigned int target, const unsigned int framebuffer)
+{
+	if (target != GL_READ_FRAMEBUFFER) {
+		g_draw = framebuffer;
+	}
+	if (target != GL_DRAW_FRAMEBUFFER) {
+		g_read = framebuffer;
+	}
+	g_binds++;
+}
+
+static void fakeBindTexture(const unsigned int, const unsigned int texture)
+{
+	g_texture = texture;
+	g_binds++;
+}
+
+static void fakeEnable(const unsigned int) { g_srgb = true; g_caps++; }
+static void fakeDisable(const unsigned int) { g_srgb = false; g_caps++; }
+
+static void fakeGetIntegerv(const unsigned int pname, int *r_data)
+{
+	*r_data = (int)(pname == GL_READ_FRAMEBUFFER_BINDING ? g_read : g_draw);
+	g_queries++;
+}
+
+static void reset(GLStateCache *r_state)
+{
+	GLStateFunctions functions;
+	functions.bindFramebuffer = fakeBindFramebuffer;
+	functions.bindTexture = fakeBindTexture;
+	functions.enable = fakeEnable;
+	functions.disable = fakeDisable;
+	functions.getIntegerv = fakeGetIntegerv;
+	r_state->setFunctions(functions);
+
+	g_draw = 3;
+	g_read = 4;
+	g_texture = 0;
+	g_srgb = false;
+	g_binds = g_queries = g_caps = 0;
+}
+
+/* what frameReady does for two eyes */
+static void submit(GLStateCache *state)
+{
+	state->begin();
+
+	for (unsigned int eye = 0; eye < 2; eye++) {
+		state->bindFramebuffer(GL_FRAMEBUFFER, 10);
+		state->setFramebufferSRGB(true);
+		state->bindFramebuffer(GL_READ_FRAMEBUFFER, 20 + eye);
+		state->countCalls(1);
+		state->bindFramebuffer(GL_FRAMEBUFFER, 10);
+		state->setFramebufferSRGB(false);
+	}
+
+	state->end();
+	state->endFrame();
+}
+
+static void test_redundant(void)
+{
+	GLStateCache state;
+	reset(&state);
+
+	state.begin();
+	CHECK(g_queries == 2);
+
+	/* already bound by the application */
+	state.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 3);
+	state.bindFramebuffer(GL_READ_FRAMEBUFFER, 4);
+	CHECK(g_binds == 0);
+
+	/* only the read binding changes */
+	state.bindFramebuffer(GL_FRAMEBUFFER, 3);
+	CHECK(g_binds == 1 && g_draw == 3 && g_read == 3);
+
+	state.bindTexture2D(5);
+	state.bindTexture2D(5);
+	CHECK(g_binds == 2 && g_texture == 5);
+
+	state.setFramebufferSRGB(true);
+	state.setFramebufferSRGB(true);
+	CHECK(g_caps == 1 && g_srgb);
+
+	/* the application bindings are back */
+	state.end();
+	CHECK(g_draw == 3 && g_read == 4);
+	CHECK(g_binds == 3);
+
+	/* the application may have changed it since */
+	state.begin();
+	state.bindTexture2D(5);
+	CHECK(g_binds == 4);
+	state.end();
+}
+
+static void test_application_bindings(void)
+{
+	GLStateCache state;
+	reset(&state);
+
+	submit(&state);
+	CHECK(g_queries == 2);
+	CHECK(g_draw == 3 && g_read == 4);
+	const unsigned int queried = state.getFrameCalls();
+
+	/* told by the application, the context is never queried */
+	state.setApplicationBindings(3, 4);
+	g_queries = 0;
+
+	for (int i = 0; i < 3; i++) {
+		submit(&state);
+	}
+	CHECK(g_queries == 0);
+	CHECK(g_draw == 3 && g_read == 4);
+	CHECK(state.getFrameCalls() == queried - 2);
+
+	/* every call of the frame is counted */
+	g_binds = g_caps = 0;
+	submit(&state);
+	CHECK(state.getFrameCalls() == (unsigned int)(g_binds + g_caps) + 2);
+
+	state.clearApplicationBindings();
+	submit(&state);
+	CHECK(g_queries == 2);
+}
+
+int main(void)
+{
+	test_redundant();
+	test_application_bindings();
+	return 0;
+}
@@ -0,0 +1,225 @@
+/* GPU timer queries of the bridge, against a fake context whose results come back late */
+
+#include "GLTimer.h"
+
+#include "test_utils.h"
+
+enum { MAX_QUERIES = 64 };
+
+/* the fake context: the GPU is g_latency frames behind, and every timestamp 1 ms after the previous */
+static unsigned long long g_timestamp[MAX_QUERIES + 1];
+static unsigned int g_issued[MAX_QUERIES + 1];
+static unsigned int g_frame, g_latency, g_step;
+static unsigned long long g_clock;
+static int g_generated, g_waits;
+
+static void fakeGenQueries(const int n, unsigned int *r_ids)
+{
+	for (int i = 0; i < n; i++) {
+		r_ids[i] = ++g_generated;
+	}
+}
+
+static void fakeDeleteQueries(const int n, const unsigned int *)
+{
+	g_generated -= n;
+}
+
+static void fakeQueryCounter(const unsigned int id, const unsigned int)
+{
+	g_clock += g_step;
+	g_timestamp[id] = g_clock;
+	g_issued[id] = g_frame;
+}
+
+static void fakeGetQueryObjectiv(const unsigned int id, const unsigned int, int *r_params)
+{
+	*r_params = (g_frame - g_issued[id]) >= g_latency ? 1 : 0;
+}
+
+static void fakeGetQueryObjectui64v(const unsigned int id, const unsigned int, unsigned long long *r_params)
+{
+	if ((g_frame - g_issued[id]) < g_latency) {
+		/* the result would stall the pipeline */
+		g_waits++;
+	}
+	*r_params = g_timestamp[id];
+}
+
+static void reset(GLTimer *r_timer, const unsigned int latency)
+{
+	GLTimerFunctions functions;
+	functions.genQueries = fakeGenQueries;
+	functions.deleteQueries = fakeDeleteQueries;
+	functions.queryCounter = fakeQueryCounter;
+	functions.getQueryObjectiv = fakeGetQueryObjectiv;
+	functions.getQueryObjectui64v = fakeGetQueryObjectui64v;
+	r_timer->setFunctions(functions);
+
+	g_frame = 0;
+	g_latency = latency;
+	g_step = 1000000;
+	g_clock = 0;
+	g_generated = g_waits = 0;
+}
+
+/* what frameReady does for two eyes */
+static void submit(GLTimer *timer)
+{
+	timer->beginFrame();
+	timer->begin(GLTimer::SUBMIT);
+
+	for (int eye = 0; eye < 2; eye++) {
+		timer->begin((GLTimer::eSection)eye);
+		timer->end((GLTimer::eSection)eye);
+	}
+
+	timer->end(GLTimer::SUBMIT);
+	timer->endFrame();
+	g_frame++;
+}
+
+static void test_late_results(void)
+{
+	GLTimer timer;
+	HMD_GPUStats stats;
+	reset(&timer, 2);
+
+	/* nothing is timed before the queries exist */
+	submit(&timer);
+	timer.getStats(&stats);
+	CHECK(stats.frames == 0);
+
+	timer.create();
+	CHECK(g_generated == GLTimer::FRAMES * GLTimer::SECTIONS * 2);
+
+	submit(&timer);
+	submit(&timer);
+	timer.getStats(&stats);
+	CHECK(stats.frames == 0);
+
+	/* read back two frames late, never waited for */
+	for (int i = 0; i < 10; i++) {
+		submit(&timer);
+	}
+	timer.getStats(&stats);
+	CHECK(stats.frames == 10);
+	CHECK(stats.dropped == 0);
+	CHECK(g_waits == 0);
+
+	/* 1 ms between the timestamps: the eyes take one, and the submission covers both eyes */
+	CHECK_NEAR(stats.eye[0].last, 0.001, 1e-9);
+	CHECK_NEAR(stats.eye[1].average, 0.001, 1e-9);
+	CHECK_NEAR(stats.submit.last, 0.005, 1e-9);
+	CHECK_NEAR(stats.submit.p99, 0.005, 1e-9);
+
+	timer.destroy();
+	CHECK(g_generated == 0);
+}
+
+static void test_dropped(void)
+{
+	GLTimer timer;
+	HMD_GPUStats stats;
+	reset(&timer, GLTimer::FRAMES + 2);
+
+	timer.create();
+
+	/* the GPU is further behind than the queries in flight */
+	for (int i = 0; i < 20; i++) {
+		submit(&timer);
+	}
+
+	timer.getStats(&stats);
+	CHECK(stats.frames == 0);
+	CHECK(stats.dropped == 20 - GLTimer::FRAMES);
+	CHECK(g_waits == 0);
+
+	/* it catches up */
+	g_latency = 1;
+	for (int i = 0; i < 10; i++) {
+		submit(&timer);
+	}
+	timer.getStats(&stats);
+	CHECK(stats.frames > 0);
+	CHECK(g_waits == 0);
+}
+
+static void test_percentile(void)
+{
+	GLTimer timer;
+	HMD_GPUStats stats;
+	reset(&timer, 1);
+
+	timer.create();
+
+	/* one frame in a hundred is ten times slower */
+	for (int i = 0; i < 201; i++) {
+		g_step = (i % 100 == 50) ? 10000000 : 1000000;
+		submit(&timer);
+	}
+
+	timer.getStats(&stats);
+	CHECK(stats.frames == 200);
+
+	/* over the last 128 frames, one of them slow */
+	CHECK_NEAR(stats.eye[0].p99, 0.001, 1e-9);
+	CHECK_NEAR(stats.eye[0].average, (127 * 0.001 + 0.01) / 128, 1e-9);
+
+	/* two slow frames of the window make the 99th percentile */
+	for (int i = 0; i < 100; i++) {
+		g_step = (i == 50 || i == 60) ? 10000000 : 1000000;
+		submit(&timer);
+	}
+	timer.getStats(&stats);
+	CHECK_NEAR(stats.eye[0].p99, 0.01, 1e-9);
+	CHECK_NEAR(stats.eye[0].last, 0.001, 1e-9);
+}
+
+static void test_sections(void)
+{
+	GLTimer timer;
+	HMD_GPUStats stats;
+	reset(&timer, 1);
+
+	timer.create();
+
+	/* side by side, a single copy */
+	for (int i = 0; i < 4; i++) {
+		timer.beginFrame();
+		timer.begin(GLTimer::SUBMIT);
+		timer.begin(GLTimer::EYE_LEFT);
+		timer.end(GLTimer::EYE_LEFT);
+		timer.end(GLTimer::SUBMIT);
+		timer.endFrame();
+		g_frame++;
+	}
+
+	timer.beginFrame();
+	timer.getStats(&stats);
+	CHECK(stats.frames == 4);
+	CHECK(stats.eye[0].average > 0.0);
+	CHECK(stats.eye[1].average == 0.0);
+	CHECK(stats.eye[1].p99 == 0.0);
+
+	/* outside of a frame nothing is issued */
+	const unsigned long long clock = g_clock;
+	timer.endFrame();
+	timer.begin(GLTimer::SUBMIT);
+	timer.end(GLTimer::SUBMIT);
+	CHECK(g_clock == clock);
+
+	timer.resetStats();
+	timer.getStats(&stats);
+	CHECK(stats.frames == 0);
+	CHECK(stats.submit.average == 0.0);
+}
+
+int main(void)
+{
+	test_late_results();
+	test_dropped();
+	test_percentile();
+	test_sections();
+	return 0;
+}
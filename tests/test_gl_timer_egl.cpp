@@ -0,0 +1,123 @@
+/* GPU timer queries in a real context: headless EGL, e.g. Mesa llvmpipe on the CI machines */
+
+#include "GLTimer.h"
+
+#include "egl_context.h"
+#include "test_utils.h"
+
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#include <stdio.h>
+
+static PFNGLGENQUERIESPROC s_glGenQueries;
+static PFNGLDELETEQUERIESPROC s_glDeleteQueries;
+static PFNGLQUERYCOUNTERPROC s_glQueryCounter;
+static PFNGLGETQUERYOBJECTIVPROC s_glGetQueryObjectiv;
+static PFNGLGETQUERYOBJECTUI64VPROC s_glGetQueryObjectui64v;
+static PFNGLGENFRAMEBUFFERSPROC s_glGenFramebuffers;
+static PFNGLBINDFRAMEBUFFERPROC s_glBindFramebuffer;
+static PFNGLFRAMEBUFFERTEXTURE2DPROC s_glFramebufferTexture2D;
+static PFNGLBLITFRAMEBUFFERPROC s_glBlitFramebuffer;
+
+/* GL 3.3 context, false when the platform has none */
+static bool createContext(void)
+{
+	const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3, EGL_NONE };
+
+	if (!createEGLContext(attributes)) {
+		return false;
+	}
+
+	s_glGenQueries = (PFNGLGENQUERIESPROC)eglGetProcAddress("glGenQueries");
+	s_glDeleteQueries = (PFNGLDELETEQUERIESPROC)eglGetProcAddress("glDeleteQueries");
+	s_glQueryCounter = (PFNGLQUERYCOUNTERPROC)eglGetProcAddress("glQueryCounter");
+	s_glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)eglGetProcAddress("glGetQueryObjectiv");
+	s_glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)eglGetProcAddress("glGetQueryObjectui64v");
+	s_glGenFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)eglGetProcAddress("glGenFramebuffers");
+	s_glBindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)eglGetProcAddress("glBindFramebuffer");
+	s_glFramebufferTexture2D = (PFNGLFRAMEBUFFERTEXTURE2DPROC)eglGetProcAddress("glFramebufferTexture2D");
+	s_glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)eglGetProcAddress("glBlitFramebuffer");
+
+	return s_glGenQueries && s_glQueryCounter && s_glGetQueryObjectui64v && s_glBlitFramebuffer;
+}
+
+static unsigned int createFramebuffer(const int size)
+{
+	GLuint texture, framebuffer;
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	s_glGenFramebuffers(1, &framebuffer);
+	s_glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	s_glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+	return framebuffer;
+}
+
+static void test_blits(void)
+{
+	GLTimerFunctions functions;
+	functions.genQueries = [](const int n, unsigned int *r_ids) { s_glGenQueries(n, r_ids); };
+	functions.deleteQueries = [](const int n, const unsigned int *ids) { s_glDeleteQueries(n, ids); };
+	functions.queryCounter = [](const unsigned int id, const unsigned int target) { s_glQueryCounter(id, target); };
+	functions.getQueryObjectiv = [](const unsigned int id, const unsigned int pname, int *r_params) { s_glGetQueryObjectiv(id, pname, r_params); };
+	functions.getQueryObjectui64v = [](const unsigned int id, const unsigned int pname, unsigned long long *r_params) { s_glGetQueryObjectui64v(id, pname, (GLuint64 *)r_params); };
+
+	GLTimer timer;
+	timer.setFunctions(functions);
+	timer.create();
+
+	const int size = 512;
+	const unsigned int source[2] = { createFramebuffer(size), createFramebuffer(size) };
+	const unsigned int target = createFramebuffer(size);
+
+	/* frameReady: a blit per eye */
+	for (int frame = 0; frame < 32; frame++) {
+		timer.beginFrame();
+		timer.begin(GLTimer::SUBMIT);
+
+		for (int eye = 0; eye < 2; eye++) {
+			timer.begin((GLTimer::eSection)eye);
+			s_glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+			s_glBindFramebuffer(GL_READ_FRAMEBUFFER, source[eye]);
+			s_glBlitFramebuffer(0, 0, size, size, 0, 0, size, size, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			timer.end((GLTimer::eSection)eye);
+		}
+
+		timer.end(GLTimer::SUBMIT);
+		timer.endFrame();
+		glFlush();
+	}
+
+	CHECK(glGetError() == GL_NO_ERROR);
+
+	/* the last frames are read once the GPU is done with them */
+	glFinish();
+	timer.collect();
+
+	HMD_GPUStats stats;
+	timer.getStats(&stats);
+
+	CHECK(stats.frames + stats.dropped == 32);
+	CHECK(stats.frames >= GLTimer::FRAMES);
+	CHECK(stats.submit.last >= stats.eye[0].last);
+	CHECK(stats.submit.p99 >= stats.submit.average);
+	CHECK(stats.submit.average < 1.0);
+
+	timer.destroy();
+	CHECK(glGetError() == GL_NO_ERROR);
+}
+
+int main(void)
+{
+	if (!createContext()) {
+		/* not a failure, the machine has no GL */
+		printf("no EGL context, skipped\n");
+		return TEST_SKIPPED;
+	}
+
+	test_blits();
+	return 0;
+}
@@ -0,0 +1,313 @@
+/* Compositor layers: update rates, static images and the CPU composition of the simulated device */
+
+#include "Simulated.h"
+
+#include "test_utils.h"
+
+#include <vector>
+
+enum { SIZE = 64 };
+
+static const uint32_t BLACK = 0xff000000u;
+static const uint32_t RED = 0xff0000ffu;
+static const uint32_t GREEN = 0xff00ff00u;
+
+/* a still head at the origin, both eyes on it, 90 degrees of field of view */
+static void configure(HMD_SimulatedConfig *r_config)
+{
+	Simulated::getDefaultConfig(r_config);
+	r_config->is_realtime = 0;
+	r_config->motion = HMD_MOTION_STILL;
+	r_config->orientation_noise = 0.0f;
+	r_config->position_noise = 0.0f;
+	r_config->ipd = 0.0f;
+
+	for (int eye = 0; eye < 2; eye++) {
+		for (int i = 0; i < 4; i++) {
+			r_config->fov[eye][i] = 1.0f;
+		}
+	}
+}
+
+/* a square of a meter, a meter in front of the origin */
+static void describe(const unsigned int type, HMD_LayerDesc *r_desc)
+{
+	r_desc->type = type;
+	r_desc->width = 16;
+	r_desc->height = 16;
+	r_desc->size[0] = r_desc->size[1] = 1.0f;
+	r_desc->orientation[0] = 1.0f;
+	r_desc->orientation[1] = r_desc->orientation[2] = r_desc->orientation[3] = 0.0f;
+	r_desc->position[0] = r_desc->position[1] = 0.0f;
+	r_desc->position[2] = -1.0f;
+	r_desc->is_head_locked = 0;
+	r_desc->update_rate = 0.0f;
+}
+
+static void fill(SimulatedImpl &impl, const int layer, const uint32_t top, const uint32_t bottom)
+{
+	uint32_t *pixels = impl.getLayerPixels(layer);
+
+	for (int i = 0; i < 16 * 16; i++) {
+		pixels[i] = (i < 8 * 16) ? top : bottom;
+	}
+}
+
+static void present(SimulatedImpl &impl)
+{
+	HMD_FrameState state;
+	state.flags = 0;
+
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.presentFrame());
+}
+
+static std::vector<uint32_t> composite(SimulatedImpl &impl, const int eye)
+{
+	std::vector<uint32_t> pixels(SIZE * SIZE, BLACK);
+	impl.composite(eye, SIZE, SIZE, pixels.data());
+	return pixels;
+}
+
+static void test_update_rate(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+	config.refresh_rate = 90.0f;
+
+	SimulatedImpl impl(config);
+	HMD_LayerDesc desc;
+	describe(HMD_LAYER_QUAD, &desc);
+	desc.update_rate = 30.0f;
+
+	const int layer = impl.createLayer(&desc);
+	CHECK(layer == 0);
+	CHECK(impl.isLayerDue(layer));
+
+	/* a new texture of the chain at every commit */
+	const unsigned int first = impl.acquireLayerTexture(layer);
+	CHECK(first != 0);
+	CHECK(impl.releaseLayerTexture(layer));
+	CHECK(!impl.releaseLayerTexture(layer));
+	CHECK(!impl.isLayerDue(layer));
+
+	/* every third frame */
+	present(impl);
+	CHECK(!impl.isLayerDue(layer));
+	present(impl);
+	CHECK(!impl.isLayerDue(layer));
+	present(impl);
+	CHECK(impl.isLayerDue(layer));
+
+	const unsigned int second = impl.acquireLayerTexture(layer);
+	CHECK(second != 0 && second != first);
+	CHECK(impl.releaseLayerTexture(layer));
+
+	/* not the name of an eye texture */
+	CHECK(second > 2 * SimulatedImpl::SWAP_CHAIN_LENGTH);
+
+	/* without an update rate, every frame */
+	desc.update_rate = 0.0f;
+	const int every = impl.createLayer(&desc);
+	CHECK(every == 1);
+	CHECK(impl.acquireLayerTexture(every) != 0);
+	CHECK(impl.releaseLayerTexture(every));
+	CHECK(impl.isLayerDue(every));
+}
+
+static void test_static_image(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+	HMD_LayerDesc desc;
+	describe(HMD_LAYER_STATIC, &desc);
+	desc.update_rate = 90.0f;
+
+	const int layer = impl.createLayer(&desc);
+	CHECK(impl.isLayerDue(layer));
+	CHECK(impl.acquireLayerTexture(layer) != 0);
+	CHECK(impl.releaseLayerTexture(layer));
+
+	/* rendered once */
+	for (int i = 0; i < 10; i++) {
+		present(impl);
+		CHECK(!impl.isLayerDue(layer));
+	}
+	CHECK(impl.acquireLayerTexture(layer) == 0);
+	CHECK(!impl.releaseLayerTexture(layer));
+}
+
+static void test_composite(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+	HMD_LayerDesc desc;
+	describe(HMD_LAYER_QUAD, &desc);
+
+	const int layer = impl.createLayer(&desc);
+	CHECK(impl.acquireLayerTexture(layer) != 0);
+	fill(impl, layer, GREEN, RED);
+	CHECK(impl.releaseLayerTexture(layer));
+
+	/* not submitted yet */
+	std::vector<uint32_t> pixels = composite(impl, 0);
+	CHECK(pixels[32 * SIZE + 32] == BLACK);
+
+	present(impl);
+
+	/* the quad covers the middle half of the view, the top of the texture up */
+	for (int eye = 0; eye < 2; eye++) {
+		pixels = composite(impl, eye);
+		CHECK(pixels[20 * SIZE + 32] == GREEN);
+		CHECK(pixels[44 * SIZE + 32] == RED);
+		CHECK(pixels[32 * SIZE + 20] == GREEN || pixels[32 * SIZE + 20] == RED);
+		CHECK(pixels[32 * SIZE + 10] == BLACK);
+		CHECK(pixels[10 * SIZE + 32] == BLACK);
+		CHECK(pixels[0] == BLACK);
+	}
+
+	/* behind the eyes */
+	const float orientation[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+	const float behind[3] = { 0.0f, 0.0f, 1.0f };
+	CHECK(impl.setLayerPose(layer, orientation, behind));
+	present(impl);
+	pixels = composite(impl, 0);
+	CHECK(pixels[32 * SIZE + 32] == BLACK);
+
+	/* translucent white over black */
+	const float ahead[3] = { 0.0f, 0.0f, -1.0f };
+	CHECK(impl.setLayerPose(layer, orientation, ahead));
+	CHECK(impl.acquireLayerTexture(layer) != 0);
+	fill(impl, layer, 0x80ffffffu, 0x80ffffffu);
+	CHECK(impl.releaseLayerTexture(layer));
+	present(impl);
+
+	pixels = composite(impl, 0);
+	const uint32_t pixel = pixels[32 * SIZE + 32];
+	CHECK((pixel >> 24) == 0xff);
+	CHECK_NEAR((double)(pixel & 0xff), 128.0, 1.0);
+	CHECK_NEAR((double)((pixel >> 8) & 0xff), 128.0, 1.0);
+
+	/* the pose is in the units of the application */
+	SimulatedImpl scaled(config);
+	scaled.setScale(100.0f);
+	desc.size[0] = desc.size[1] = 100.0f;
+	desc.position[2] = -100.0f;
+
+	const int centimeters = scaled.createLayer(&desc);
+	CHECK(scaled.acquireLayerTexture(centimeters) != 0);
+	fill(scaled, centimeters, GREEN, RED);
+	CHECK(scaled.releaseLayerTexture(centimeters));
+	present(scaled);
+
+	pixels = composite(scaled, 0);
+	CHECK(pixels[20 * SIZE + 32] == GREEN);
+	CHECK(pixels[32 * SIZE + 10] == BLACK);
+}
+
+static void test_head_locked(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+	config.motion = HMD_MOTION_LOOK_AROUND;
+
+	SimulatedImpl impl(config);
+	HMD_LayerDesc desc;
+	describe(HMD_LAYER_QUAD, &desc);
+	desc.size[0] = desc.size[1] = 0.2f;
+
+	/* below the head-locked one, it leaves the view while the head turns away */
+	const int world = impl.createLayer(&desc);
+	CHECK(impl.acquireLayerTexture(world) != 0);
+	fill(impl, world, GREEN, GREEN);
+	CHECK(impl.releaseLayerTexture(world));
+
+	desc.is_head_locked = 1;
+	const int hud = impl.createLayer(&desc);
+	CHECK(impl.acquireLayerTexture(hud) != 0);
+	fill(impl, hud, RED, RED);
+	CHECK(impl.releaseLayerTexture(hud));
+
+	bool is_world_moving = false;
+
+	for (int i = 0; i < 90; i++) {
+		present(impl);
+
+		const std::vector<uint32_t> pixels = composite(impl, 0);
+		CHECK(pixels[32 * SIZE + 32] == RED);
+		is_world_moving = is_world_moving || (pixels[32 * SIZE + 30] != GREEN);
+	}
+	CHECK(is_world_moving);
+}
+
+static void test_slots(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+	HMD_LayerDesc desc;
+	describe(HMD_LAYER_QUAD, &desc);
+
+	for (int layer = 0; layer < BackendImpl::MAX_LAYERS; layer++) {
+		CHECK(impl.createLayer(&desc) == layer);
+	}
+	CHECK(impl.createLayer(&desc) == -1);
+
+	CHECK(impl.destroyLayer(3));
+	CHECK(!impl.destroyLayer(3));
+	CHECK(!impl.isLayerDue(3));
+	CHECK(impl.acquireLayerTexture(3) == 0);
+	CHECK(impl.getLayerPixels(3) == nullptr);
+	CHECK(impl.createLayer(&desc) == 3);
+
+	CHECK(!impl.destroyLayer(-1));
+	CHECK(!impl.destroyLayer(BackendImpl::MAX_LAYERS));
+
+	desc.width = 0;
+	CHECK(impl.destroyLayer(0));
+	CHECK(impl.createLayer(&desc) == -1);
+}
+
+static void test_api(void)
+{
+	HMD *hmd = HMD_new(HMD::BACKEND_SIMULATED);
+	HMD_FrameState state;
+	HMD_LayerDesc desc;
+
+	describe(HMD_LAYER_QUAD, &desc);
+	state.flags = 0;
+
+	const int layer = HMD_layerCreate(hmd, &desc);
+	CHECK(layer == 0);
+	CHECK(HMD_layerDue(hmd, layer));
+	CHECK(HMD_layerAcquireTexture(hmd, layer) != 0);
+	CHECK(HMD_layerReleaseTexture(hmd, layer));
+
+	const float orientation[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+	const float position[3] = { 0.0f, -0.5f, -1.0f };
+	CHECK(HMD_layerPose(hmd, layer, orientation, position));
+
+	CHECK(HMD_setup(hmd, 0, 0));
+	CHECK(HMD_frameState(hmd, &state));
+	CHECK(HMD_frameReady(hmd));
+
+	CHECK(HMD_layerDestroy(hmd, layer));
+	CHECK(!HMD_layerPose(hmd, layer, orientation, position));
+	HMD_del(hmd);
+}
+
+int main(void)
+{
+	test_update_rate();
+	test_static_image();
+	test_composite();
+	test_head_locked();
+	test_slots();
+	test_api();
+	return 0;
+}
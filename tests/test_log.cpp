@@ -0,0 +1,214 @@
+/* the asynchronous log: sink, levels, and the calls compiled out below BRIDGE_LOG_LEVEL */
+
+/* as -DLOG_LEVEL=WARNING would, whatever the build uses */
+#undef BRIDGE_LOG_LEVEL
+#define BRIDGE_LOG_LEVEL 2
+
+#include "Log.h"
+
+#include "test_utils.h"
+
+#include <atomic>
+#include <mutex>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Message
+{
+	int level;
+	std::string text;
+};
+
+static std::mutex s_mutex;
+static std::vector<Message> s_messages;
+
+static void collect(const int level, const char *message, void *user_data)
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	Message collected;
+	collected.level = level;
+	collected.text = message;
+	s_messages.push_back(collected);
+
+	(*(int *)user_data)++;
+}
+
+static std::vector<Message> take(void)
+{
+	Log::flush();
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+	std::vector<Message> messages;
+	messages.swap(s_messages);
+	return messages;
+}
+
+static void test_threads(void)
+{
+	const int threads = 4, count = 50;
+	std::vector<std::thread> writers;
+
+	for (int thread = 0; thread < threads; thread++) {
+		writers.push_back(std::thread([thread, count]() {
+			for (int i = 0; i < count; i++) {
+				Log::write(HMD_LOG_INFO, "%d %d", thread, i);
+			}
+		}));
+	}
+
+	for (std::thread &writer : writers) {
+		writer.join();
+	}
+
+	const std::vector<Message> messages = take();
+	CHECK(messages.size() == threads * count);
+	CHECK(Log::getDropped() == 0);
+
+	/* in the order of each thread */
+	int next[threads] = { 0 };
+
+	for (const Message &message : messages) {
+		int thread, i;
+		CHECK(sscanf(message.text.c_str(), "%d %d", &thread, &i) == 2);
+		CHECK(thread >= 0 && thread < threads);
+		CHECK(i == next[thread]);
+		CHECK(message.level == HMD_LOG_INFO);
+		next[thread]++;
+	}
+}
+
+static void test_levels(void)
+{
+	int count = 0;
+
+	/* compiled out, the arguments are not evaluated */
+	BRIDGE_LOG_DEBUG("debug %d", count++);
+	BRIDGE_LOG_INFO("info %d", count++);
+	BRIDGE_LOG_WARNING("warning %d", 1);
+	BRIDGE_LOG_ERROR("error %d", 2);
+	CHECK(count == 0);
+
+	std::vector<Message> messages = take();
+	CHECK(messages.size() == 2);
+	CHECK(messages[0].level == HMD_LOG_WARNING && messages[0].text == "warning 1");
+	CHECK(messages[1].level == HMD_LOG_ERROR && messages[1].text == "error 2");
+
+	/* at runtime */
+	Log::setLevel(HMD_LOG_ERROR);
+	CHECK(Log::getLevel() == HMD_LOG_ERROR);
+	BRIDGE_LOG_WARNING("warning");
+	BRIDGE_LOG_ERROR("error");
+	CHECK(take().size() == 1);
+
+	Log::setLevel(HMD_LOG_NONE);
+	BRIDGE_LOG_ERROR("error");
+	CHECK(take().empty());
+
+	Log::setLevel(HMD_LOG_DEBUG);
+}
+
+static void test_long(void)
+{
+	char text[Log::MESSAGE_SIZE * 2];
+	memset(text, 'x', sizeof(text) - 1);
+	text[sizeof(text) - 1] = '\0';
+
+	BRIDGE_LOG_ERROR("%s", text);
+
+	const std::vector<Message> messages = take();
+	CHECK(messages.size() == 1);
+	CHECK(messages[0].text.size() == Log::MESSAGE_SIZE - 1);
+}
+
+static std::atomic<bool> s_is_blocked(false);
+
+static void block(const int level, const char *message, void *user_data)
+{
+	while (s_is_blocked) {
+		std::this_thread::yield();
+	}
+	collect(level, message, user_data);
+}
+
+/* write() never waits for the sink, what doesn't fit in the queue is dropped */
+static void test_full(void)
+{
+	int count = 0;
+	Log::setSink(block, &count);
+
+	s_is_blocked = true;
+	const int written = Log::QUEUE_SIZE * 2;
+
+	for (int i = 0; i < written; i++) {
+		Log::write(HMD_LOG_INFO, "%d", i);
+	}
+
+	const unsigned long long dropped = Log::getDropped();
+	CHECK(dropped > 0);
+
+	s_is_blocked = false;
+	const std::vector<Message> messages = take();
+
+	/* and reported */
+	CHECK(messages.size() == written - dropped + 1);
+	CHECK(messages.back().level == HMD_LOG_WARNING);
+	CHECK(strstr(messages.back().text.c_str(), "dropped") != nullptr);
+	CHECK(count == (int)messages.size());
+}
+
+/* nothing lost to the writers racing the shutdown */
+static void test_shutdown(void)
+{
+	const int threads = 4, count = 50;
+	int delivered = 0;
+	std::vector<std::thread> writers;
+
+	take();
+	Log::setSink(collect, &delivered);
+
+	for (int thread = 0; thread < threads; thread++) {
+		writers.push_back(std::thread([count]() {
+			for (int i = 0; i < count; i++) {
+				Log::write(HMD_LOG_INFO, "%d", i);
+			}
+		}));
+	}
+
+	Log::shutdown();
+
+	for (std::thread &writer : writers) {
+		writer.join();
+	}
+
+	Log::flush();
+	CHECK(delivered == threads * count);
+
+	/* without the log thread, delivered by write() */
+	BRIDGE_LOG_ERROR("after shutdown");
+	CHECK(delivered == threads * count + 1);
+
+	Log::shutdown();
+}
+
+int main(void)
+{
+	int count = 0;
+	Log::setSink(collect, &count);
+
+	test_threads();
+	test_levels();
+	test_long();
+	CHECK(count == 4 * 50 + 2 + 1 + 1);
+
+	test_full();
+
+	Log::setSink(nullptr, nullptr);
+	BRIDGE_LOG_WARNING("to the standard output");
+	Log::flush();
+
+	test_shutdown();
+	return 0;
+}
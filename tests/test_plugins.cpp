@@ -0,0 +1,86 @@
+/* Backend plugins: loaded when first requested, once, and only when built with the same ABI */
+
+#include "PluginLoader.h"
+
+#include "test_utils.h"
+
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <dlfcn.h>
+#endif
+
+/* the plugins of the tests are found with HMD_BRIDGE_PLUGIN_PATH */
+
+static void test_core(void)
+{
+#if !defined(_WIN32) && !defined(_WIN64) && defined(RTLD_NOLOAD)
+	/* the core library needs no GL */
+	CHECK(dlopen("libGL.so.1", RTLD_NOW | RTLD_NOLOAD) == nullptr);
+	CHECK(dlopen("libOpenGL.so.0", RTLD_NOW | RTLD_NOLOAD) == nullptr);
+#endif
+
+	/* built in, nothing is loaded */
+	HMD *hmd = HMD_new(HMD::BACKEND_SIMULATED);
+	CHECK(HMD_setup(hmd, 0, 0));
+	HMD_del(hmd);
+	CHECK(!PluginLoader::isLoaded("BridgeTestPlugin"));
+
+	/* without its plugin, a device is a stub */
+	hmd = HMD_new(HMD::BACKEND_OPENHMD);
+	CHECK(hmd != nullptr);
+	CHECK(!HMD_setup(hmd, 0, 0));
+	HMD_del(hmd);
+	CHECK(!PluginLoader::isLoaded("BridgeOpenHMD"));
+}
+
+static void test_load(void)
+{
+	CHECK(!PluginLoader::isLoaded("BridgeTestPlugin"));
+
+	const HMD_Plugin *plugin = PluginLoader::load("BridgeTestPlugin");
+	CHECK(plugin != nullptr);
+	CHECK(plugin->abi == HMD_PLUGIN_ABI);
+	CHECK(strcmp(plugin->name, "Simulated") == 0);
+	CHECK(PluginLoader::isLoaded("BridgeTestPlugin"));
+
+	/* once */
+	CHECK(PluginLoader::load("BridgeTestPlugin") == plugin);
+
+	/* the backend of the plugin behind the API */
+	HMD *hmd = HMD_newPlugin("BridgeTestPlugin");
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_ORIENTATION;
+
+	CHECK(hmd != nullptr);
+	CHECK(HMD_widthLeft(hmd) > 0);
+	CHECK(HMD_setup(hmd, 0, 0));
+	CHECK(HMD_frameState(hmd, &state));
+	CHECK(HMD_frameReady(hmd));
+	HMD_del(hmd);
+
+	/* without a runtime of its own */
+	CHECK(HMD_pluginShutdownIdle("BridgeTestPlugin"));
+}
+
+static void test_failures(void)
+{
+	CHECK(HMD_newPlugin("BridgeMissingPlugin") == nullptr);
+	CHECK(!PluginLoader::isLoaded("BridgeMissingPlugin"));
+	CHECK(HMD_pluginShutdownIdle("BridgeMissingPlugin"));
+
+	CHECK(PluginLoader::load(nullptr) == nullptr);
+	CHECK(PluginLoader::load("") == nullptr);
+
+	/* found, but of another ABI */
+	CHECK(HMD_newPlugin("BridgeTestPluginOld") == nullptr);
+	CHECK(!PluginLoader::isLoaded("BridgeTestPluginOld"));
+}
+
+int main(void)
+{
+	test_core();
+	test_load();
+	test_failures();
+	return 0;
+}
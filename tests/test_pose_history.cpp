@@ -0,0 +1,127 @@
+/* Pose history and the interpolated pose queries */
+
+#include "Backend.h"
+
+#include "test_utils.h"
+
+/* sample at the given time, rotating around +y at 1 rad/s and moving along +x at 1 m/s */
+static PoseSample makeSample(const double time)
+{
+	PoseSample sample;
+	memset(&sample, 0, sizeof(sample));
+
+	const float angle = (float)time;
+	const float q[4] = { cosf(angle * 0.5f), 0.0f, sinf(angle * 0.5f), 0.0f };
+
+	sample.time = time;
+	sample.status = HMD_STATUS_ORIENTATION_TRACKED | HMD_STATUS_POSITION_TRACKED;
+	memcpy(sample.head_orientation, q, sizeof(q));
+	sample.head_position[0] = (float)time;
+
+	for (int eye = 0; eye < 2; eye++) {
+		memcpy(sample.orientation[eye], q, sizeof(q));
+		sample.position[eye][0] = (float)time;
+	}
+	return sample;
+}
+
+static float yawOf(const float *q)
+{
+	float yaw, pitch, roll;
+	poseYawPitchRoll(q, &yaw, &pitch, &roll);
+	return yaw;
+}
+
+class HistoryImpl : public FakeImpl
+{
+public:
+	bool sampleTracking(const unsigned int frame, PoseSample *r_sample)
+	{
+		*r_sample = makeSample(frame * 0.1);
+		r_sample->frame = frame;
+		return true;
+	}
+};
+
+static void test_interpolation(void)
+{
+	PoseHistory history;
+	PoseSample sample;
+
+	CHECK(!history.getPoseAt(0.0, &sample));
+
+	for (int i = 0; i < 10; i++) {
+		history.add(makeSample(i * 0.1));
+	}
+
+	CHECK(history.getPoseAt(0.25, &sample));
+	CHECK_NEAR(sample.time, 0.25, 1e-9);
+	CHECK_NEAR(yawOf(sample.head_orientation), 0.25, 1e-4);
+	CHECK_NEAR(yawOf(sample.orientation[1]), 0.25, 1e-4);
+	CHECK_NEAR(sample.position[0][0], 0.25, 1e-5);
+
+	/* exact sample */
+	CHECK(history.getPoseAt(0.5, &sample));
+	CHECK_NEAR(yawOf(sample.orientation[0]), 0.5, 1e-4);
+
+	/* clamped outside of the history */
+	CHECK(history.getPoseAt(5.0, &sample));
+	CHECK_NEAR(sample.position[0][0], 0.9, 1e-5);
+	CHECK(history.getPoseAt(-1.0, &sample));
+	CHECK_NEAR(sample.position[0][0], 0.0, 1e-5);
+}
+
+static void test_capacity(void)
+{
+	PoseHistory history;
+	PoseSample sample;
+
+	for (int i = 0; i < PoseHistory::CAPACITY * 3; i++) {
+		history.add(makeSample(i * 0.01));
+	}
+
+	/* the oldest samples are gone, queries clamp to the oldest one still available */
+	CHECK(history.getPoseAt(0.0, &sample));
+	CHECK(sample.position[0][0] > (PoseHistory::CAPACITY * 2 - 1) * 0.01f);
+
+	CHECK(history.getPoseAt(3.005, &sample));
+	CHECK_NEAR(sample.position[1][0], 3.005, 1e-4);
+}
+
+static void test_slerp(void)
+{
+	/* q and -q are the same rotation, the interpolation takes the shortest path */
+	const float a[4] = { cosf(0.1f), 0.0f, sinf(0.1f), 0.0f };
+	const float b[4] = { -cosf(0.2f), 0.0f, -sinf(0.2f), 0.0f };
+	float q[4];
+
+	poseSlerp(a, b, 0.5f, q);
+	CHECK_NEAR(yawOf(q), 0.3, 1e-4);
+	CHECK_NEAR(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3], 1.0, 1e-6);
+}
+
+static void test_backend(void)
+{
+	HistoryImpl impl;
+	HMD_FrameState state;
+	float orientation[2][4], position[2][3];
+
+	state.flags = 0;
+	for (int i = 0; i < 5; i++) {
+		CHECK(impl.getFrameState(&state));
+	}
+
+	impl.setScale(2.0f);
+	CHECK(impl.getPoseAt(0.15, orientation[0], position[0], orientation[1], position[1]));
+	CHECK_NEAR(position[0][0], 0.3, 1e-5);
+	CHECK_NEAR(yawOf(orientation[1]), 0.15, 1e-4);
+}
+
+int main(void)
+{
+	test_interpolation();
+	test_capacity();
+	test_slerp();
+	test_backend();
+	return 0;
+}
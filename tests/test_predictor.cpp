@@ -0,0 +1,143 @@
+/* Bridge-side pose prediction models */
+
+#include "Backend.h"
+
+#include "test_utils.h"
+
+static const float axis[3] = { 0.26726124f, 0.80178373f, 0.53452248f };
+
+/* rotation of angle around axis, position at acceleration accel */
+static PoseSample makeSample(const double time, const double speed, const double spin, const double accel)
+{
+	PoseSample sample;
+	memset(&sample, 0, sizeof(sample));
+
+	const float angle = (float)(speed * time + 0.5 * spin * time * time);
+	const float s = sinf(angle * 0.5f);
+	const float q[4] = { cosf(angle * 0.5f), axis[0] * s, axis[1] * s, axis[2] * s };
+	const float x = (float)(0.2 * time + 0.5 * accel * time * time);
+
+	sample.time = time;
+	sample.status = HMD_STATUS_ORIENTATION_TRACKED | HMD_STATUS_POSITION_TRACKED;
+	memcpy(sample.head_orientation, q, sizeof(q));
+	sample.head_position[0] = x;
+
+	for (int eye = 0; eye < 2; eye++) {
+		memcpy(sample.orientation[eye], q, sizeof(q));
+		sample.position[eye][0] = x;
+		sample.position[eye][1] = 1.6f;
+	}
+	return sample;
+}
+
+static double angleBetween(const float *a, const float *b)
+{
+	const double dot = fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+	return 2.0 * acos(dot > 1.0 ? 1.0 : dot);
+}
+
+static double predictionError(const eHMDPredictor type, const double speed, const double spin, const double accel, double *r_position_error)
+{
+	const double dt = 1.0 / 90.0;
+	const double horizon = 0.05;
+
+	PoseHistory history;
+	Predictor predictor;
+	PoseSample prediction;
+
+	for (int i = 0; i < 10; i++) {
+		history.add(makeSample(i * dt, speed, spin, accel));
+	}
+
+	predictor.set(type, horizon);
+	CHECK(predictor.predict(history, &prediction));
+
+	const PoseSample truth = makeSample(9 * dt + horizon, speed, spin, accel);
+	CHECK_NEAR(prediction.time, truth.time, 1e-9);
+	CHECK_NEAR(prediction.position[1][1], 1.6, 1e-5);
+
+	*r_position_error = fabs(prediction.position[0][0] - truth.position[0][0]);
+	return angleBetween(prediction.orientation[0], truth.orientation[0]);
+}
+
+static void test_models(void)
+{
+	double position_error;
+
+	/* constant angular velocity and linear velocity */
+	CHECK(predictionError(HMD_PREDICTOR_ANGULAR_VELOCITY, 2.0, 0.0, 0.0, &position_error) < 1e-4);
+	CHECK(position_error < 1e-5);
+
+	CHECK(predictionError(HMD_PREDICTOR_CONSTANT_ACCELERATION, 2.0, 0.0, 0.0, &position_error) < 1e-4);
+	CHECK(position_error < 1e-5);
+
+	CHECK(predictionError(HMD_PREDICTOR_CONSTANT_VELOCITY, 2.0, 0.0, 0.0, &position_error) < 1e-2);
+	CHECK(position_error < 1e-5);
+
+	/* accelerating motion, only the constant acceleration model follows it */
+	const double cv = predictionError(HMD_PREDICTOR_ANGULAR_VELOCITY, 1.0, 8.0, 4.0, &position_error);
+	CHECK(position_error > 1e-3);
+
+	CHECK(predictionError(HMD_PREDICTOR_CONSTANT_ACCELERATION, 1.0, 8.0, 4.0, &position_error) < cv * 0.01);
+	CHECK(position_error < 1e-5);
+}
+
+static void test_not_enough_history(void)
+{
+	PoseHistory history;
+	Predictor predictor;
+	PoseSample prediction;
+
+	history.add(makeSample(0.0, 1.0, 0.0, 0.0));
+	history.add(makeSample(0.01, 1.0, 0.0, 0.0));
+
+	predictor.set(HMD_PREDICTOR_NONE, 0.05);
+	CHECK(!predictor.predict(history, &prediction));
+
+	predictor.set(HMD_PREDICTOR_CONSTANT_ACCELERATION, 0.05);
+	CHECK(!predictor.predict(history, &prediction));
+
+	predictor.set(HMD_PREDICTOR_CONSTANT_VELOCITY, 0.05);
+	CHECK(predictor.predict(history, &prediction));
+}
+
+class LinearImpl : public FakeImpl
+{
+public:
+	bool sampleTracking(const unsigned int frame, PoseSample *r_sample)
+	{
+		*r_sample = makeSample(frame * 0.01, 1.0, 0.0, 0.0);
+		r_sample->frame = frame;
+		return true;
+	}
+};
+
+static void test_backend(void)
+{
+	LinearImpl impl;
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_POSITION;
+
+	impl.setPredictor(HMD_PREDICTOR_ANGULAR_VELOCITY, 0.1);
+
+	/* the first frame has no history to predict from */
+	CHECK(impl.getFrameState(&state));
+	CHECK_NEAR(state.display_time, 0.0, 1e-9);
+
+	CHECK(impl.getFrameState(&state));
+	CHECK(state.frame == 1);
+	CHECK_NEAR(state.display_time, 0.11, 1e-9);
+	CHECK_NEAR(state.position[0][0], 0.2 * 0.11, 1e-5);
+
+	impl.setPredictor(HMD_PREDICTOR_NONE, 0.0);
+	CHECK(impl.getFrameState(&state));
+	CHECK_NEAR(state.display_time, 0.02, 1e-9);
+}
+
+int main(void)
+{
+	test_models();
+	test_not_enough_history();
+	test_backend();
+	return 0;
+}
@@ -0,0 +1,118 @@
+/* Projection matrices cached by the backend */
+
+#include "Backend.h"
+
+#include "test_utils.h"
+
+/* backend with a symmetric field of view, counting the projection computations */
+class ProjectionImpl : public BackendImpl
+{
+public:
+	int computed;
+	float tan_half_fov;
+
+	ProjectionImpl() : computed(0), tan_half_fov(1.0f) {}
+
+	bool setup(const unsigned int, const unsigned int) { return true; }
+	bool sampleTracking(const unsigned int, PoseSample *) { return false; }
+	bool frameReady(void) { return true; }
+	bool reCenter(void) { return true; }
+
+	void computeProjectionMatrix(const int eye, const float nearz, const float farz, const bool is_opengl, const bool is_right_hand, float *r_matrix)
+	{
+		/* right-handed looks down -z */
+		const float handedness = is_right_hand ? -1.0f : 1.0f;
+
+		this->computed++;
+		memset(r_matrix, 0, sizeof(float[16]));
+
+		r_matrix[0] = 1.0f / this->tan_half_fov;
+		r_matrix[5] = 1.0f / this->tan_half_fov;
+		r_matrix[8] = eye ? 0.1f : -0.1f;
+		r_matrix[10] = -handedness * (is_opengl ? (farz + nearz) : farz) / (nearz - farz);
+		r_matrix[11] = handedness;
+		r_matrix[14] = (is_opengl ? 2.0f : 1.0f) * farz * nearz / (nearz - farz);
+	}
+
+	/* the field of view changed */
+	void setFov(const float tan_half_fov)
+	{
+		this->tan_half_fov = tan_half_fov;
+		this->invalidateProjection();
+	}
+};
+
+static void test_cached(void)
+{
+	ProjectionImpl impl;
+	float left[16], right[16], matrix[16];
+
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	CHECK(impl.computed == 2);
+	CHECK_NEAR(left[8], -0.1, 1e-6);
+	CHECK_NEAR(right[8], 0.1, 1e-6);
+
+	/* same clipping, no new computation */
+	impl.getProjectionMatrixLeft(0.1f, 100.0f, true, true, matrix);
+	CHECK(memcmp(matrix, left, sizeof(matrix)) == 0);
+	impl.getProjectionMatrixRight(0.1f, 100.0f, true, true, matrix);
+	CHECK(memcmp(matrix, right, sizeof(matrix)) == 0);
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	CHECK(impl.computed == 2);
+
+	/* each eye is only computed when requested */
+	impl.getProjectionMatrixRight(0.5f, 100.0f, true, true, matrix);
+	CHECK(impl.computed == 3);
+	impl.getProjectionMatrixRight(0.5f, 100.0f, true, true, matrix);
+	CHECK(impl.computed == 3);
+}
+
+static void test_key(void)
+{
+	ProjectionImpl impl;
+	float left[16], right[16];
+
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	impl.getProjectionMatrices(0.1f, 100.0f, false, true, left, right);
+	impl.getProjectionMatrices(0.1f, 100.0f, true, false, left, right);
+	impl.getProjectionMatrices(0.1f, 50.0f, true, true, left, right);
+	CHECK(impl.computed == 8);
+
+	/* all four setups are kept */
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	impl.getProjectionMatrices(0.1f, 100.0f, false, true, left, right);
+	impl.getProjectionMatrices(0.1f, 100.0f, true, false, left, right);
+	impl.getProjectionMatrices(0.1f, 50.0f, true, true, left, right);
+	CHECK(impl.computed == 8);
+
+	/* a fifth one replaces the oldest */
+	impl.getProjectionMatrices(1.0f, 10.0f, true, true, left, right);
+	CHECK(impl.computed == 10);
+	impl.getProjectionMatrices(0.1f, 100.0f, false, true, left, right);
+	CHECK(impl.computed == 10);
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	CHECK(impl.computed == 12);
+}
+
+static void test_invalidate(void)
+{
+	ProjectionImpl impl;
+	float left[16], right[16];
+
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	CHECK_NEAR(left[0], 1.0, 1e-6);
+
+	impl.setFov(0.5f);
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+	CHECK(impl.computed == 4);
+	CHECK_NEAR(left[0], 2.0, 1e-6);
+	CHECK_NEAR(right[5], 2.0, 1e-6);
+}
+
+int main(void)
+{
+	test_cached();
+	test_key();
+	test_invalidate();
+	return 0;
+}
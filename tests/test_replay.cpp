@@ -0,0 +1,131 @@
+/* Play back of a recorded trace */
+
+#include "Replay.h"
+#include "Simulated.h"
+
+#include "test_utils.h"
+
+#include <stdio.h>
+
+#define TRACE_PATH "test_replay.hmdtrace"
+#define FRAMES 200
+
+/* record a simulated session, one sample per frame at 90 Hz */
+static void record(HMD_FrameState *r_states)
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+	config.is_realtime = 0;
+	config.motion = HMD_MOTION_WALK;
+
+	SimulatedImpl *impl = new SimulatedImpl(config);
+	CHECK(impl->startRecording(TRACE_PATH));
+
+	for (int i = 0; i < FRAMES; i++) {
+		r_states[i].flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION | HMD_FRAME_VIEW_MATRIX;
+		CHECK(impl->getFrameState(&r_states[i]));
+		CHECK(impl->frameReady());
+	}
+
+	impl->stopRecording();
+	delete impl;
+}
+
+static void test_as_fast_as_possible(const HMD_FrameState *states)
+{
+	ReplayImpl impl(false);
+	HMD_FrameState state;
+
+	CHECK(impl.open(TRACE_PATH));
+	CHECK(impl.getSampleCount() == FRAMES);
+
+	for (int i = 0; i < FRAMES; i++) {
+		state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION | HMD_FRAME_VIEW_MATRIX;
+		CHECK(impl.getFrameState(&state));
+		CHECK(impl.frameReady());
+
+		CHECK(state.display_time == states[i].display_time);
+		CHECK(impl.getTime() == states[i].display_time);
+		CHECK(memcmp(state.orientation, states[i].orientation, sizeof(state.orientation)) == 0);
+		CHECK(memcmp(state.position, states[i].position, sizeof(state.position)) == 0);
+		CHECK(memcmp(state.view_matrix, states[i].view_matrix, sizeof(state.view_matrix)) == 0);
+	}
+
+	/* end of the recording */
+	CHECK(!impl.getFrameState(&state));
+
+	/* back to the middle */
+	CHECK(impl.seek(states[100].display_time));
+	CHECK(impl.getPosition() == 100);
+	CHECK(impl.getFrameState(&state));
+	CHECK(memcmp(state.orientation, states[100].orientation, sizeof(state.orientation)) == 0);
+
+	/* in between two samples */
+	CHECK(impl.seek(states[10].display_time + 0.001));
+	CHECK(impl.getPosition() == 11);
+
+	CHECK(!impl.seek(states[FRAMES - 1].display_time + 1.0));
+}
+
+static void test_realtime(const HMD_FrameState *states)
+{
+	ReplayImpl impl(true);
+	HMD_FrameState state;
+	double previous = -1.0;
+	int frames = 0;
+
+	CHECK(impl.open(TRACE_PATH));
+
+	/* the last 100 ms of the recording */
+	CHECK(impl.seek(states[FRAMES - 10].display_time));
+
+	state.flags = HMD_FRAME_ORIENTATION;
+	while (impl.getFrameState(&state)) {
+		/* never ahead of the playback clock, never back in time */
+		CHECK(state.display_time <= impl.getTime());
+		CHECK(state.display_time >= previous);
+		previous = state.display_time;
+
+		CHECK(impl.frameReady());
+		CHECK(++frames < 1000);
+	}
+
+	CHECK(previous == states[FRAMES - 1].display_time);
+}
+
+static void test_api(const HMD_FrameState *states)
+{
+	CHECK(HMD_newReplay("does_not_exist.hmdtrace", false) == nullptr);
+
+	HMD *hmd = HMD_newReplay(TRACE_PATH, false);
+	HMD_FrameState state;
+	float orientation[2][4], position[2][3];
+
+	CHECK(hmd != nullptr);
+	CHECK(HMD_replaySeek(hmd, states[50].display_time));
+	CHECK(HMD_update(hmd, orientation[0], position[0], orientation[1], position[1]));
+	CHECK(memcmp(orientation, states[50].orientation, sizeof(orientation)) == 0);
+
+	state.flags = 0;
+	CHECK(HMD_frameState(hmd, &state));
+	CHECK(state.display_time == states[51].display_time);
+	HMD_del(hmd);
+
+	/* devices without a recording can't seek */
+	hmd = HMD_new(HMD::BACKEND_SIMULATED);
+	CHECK(!HMD_replaySeek(hmd, 0.0));
+	HMD_del(hmd);
+}
+
+int main(void)
+{
+	static HMD_FrameState states[FRAMES];
+
+	record(states);
+	test_as_fast_as_possible(states);
+	test_realtime(states);
+	test_api(states);
+
+	remove(TRACE_PATH);
+	return 0;
+}
@@ -0,0 +1,174 @@
+/* Dynamic resolution: convergence of the governor and the viewports of the simulated device */
+
+#include "ResolutionGovernor.h"
+#include "Simulated.h"
+
+#include "test_utils.h"
+
+static const double PERIOD = 1.0 / 90.0;
+
+/* GPU bound frame, its time proportional to the pixels */
+static double frameTime(const double full_time, const float scale)
+{
+	return full_time * scale * scale;
+}
+
+static void test_converge(void)
+{
+	ResolutionGovernor governor;
+	governor.configure(0.5f, 1.0f, 0.9f);
+	CHECK(governor.getScale() == 1.0f);
+
+	/* twice too heavy at full density */
+	const double full_time = 2.0 * 0.9 * PERIOD;
+
+	for (int i = 0; i < 60; i++) {
+		governor.update(frameTime(full_time, governor.getScale()), PERIOD);
+	}
+
+	const float scale = governor.getScale();
+	CHECK_NEAR(frameTime(full_time, scale), 0.9 * PERIOD, 0.05 * PERIOD);
+	CHECK(frameTime(full_time, scale) < PERIOD);
+
+	/* settled, it does not flicker */
+	for (int i = 0; i < 60; i++) {
+		governor.update(frameTime(full_time, governor.getScale()), PERIOD);
+		CHECK_NEAR(governor.getScale(), scale, 0.01);
+	}
+}
+
+static void test_spike(void)
+{
+	ResolutionGovernor governor;
+	governor.configure(0.5f, 1.0f, 0.9f);
+
+	const double light_time = 0.5 * PERIOD;
+
+	for (int i = 0; i < 10; i++) {
+		governor.update(frameTime(light_time, governor.getScale()), PERIOD);
+	}
+	CHECK(governor.getScale() == 1.0f);
+
+	/* a missed frame drops the density at once, by a bounded step */
+	governor.update(3.0 * PERIOD, PERIOD);
+	CHECK_NEAR(governor.getScale(), 1.0f - RESOLUTION_MAX_DROP, 1e-6);
+
+	/* down to the minimum at most */
+	for (int i = 0; i < 10; i++) {
+		governor.update(3.0 * PERIOD, PERIOD);
+	}
+	CHECK(governor.getScale() == 0.5f);
+
+	/* and back up in small steps, once the spike is filtered out */
+	for (int i = 0; i < 100; i++) {
+		const float scale = governor.getScale();
+		governor.update(frameTime(light_time, scale), PERIOD);
+		CHECK(governor.getScale() >= scale);
+		CHECK(governor.getScale() <= scale + RESOLUTION_RISE_STEP + 1e-6f);
+	}
+	CHECK(governor.getScale() == 1.0f);
+
+	/* no time, no change */
+	governor.update(0.0, PERIOD);
+	governor.update(PERIOD, 0.0);
+	CHECK(governor.getScale() == 1.0f);
+}
+
+static void test_supersampling(void)
+{
+	ResolutionGovernor governor;
+	governor.configure(0.8f, 1.5f, 0.9f);
+	CHECK(governor.getScale() == 1.5f);
+	CHECK(governor.getFraction() == 1.0f);
+
+	for (int i = 0; i < 100; i++) {
+		governor.update(frameTime(PERIOD, governor.getScale()), PERIOD);
+	}
+
+	/* 1.0 is exactly one period, the budget is below it */
+	CHECK(governor.getScale() < 1.0f);
+	CHECK(governor.getScale() >= 0.8f);
+	CHECK_NEAR(governor.getFraction(), governor.getScale() / 1.5f, 1e-6);
+}
+
+static void test_viewports(void)
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+	config.is_realtime = 0;
+
+	SimulatedImpl impl(config);
+	HMD_ResolutionConfig resolution = { 0.5f, 1.2f, 0.9f, 0.0 };
+	HMD_FrameState state;
+	state.flags = 0;
+
+	/* allocated at the highest density */
+	CHECK(impl.startDynamicResolution(&resolution));
+	CHECK(impl.getWidthLeft() == (int)(1332 * 1.2f + 0.5f));
+	CHECK(impl.getHeightRight() == (int)(1586 * 1.2f + 0.5f));
+	CHECK(impl.setupSideBySide(0));
+
+	int viewport[4];
+	impl.getEyeViewport(1, viewport);
+	CHECK(viewport[0] == impl.getWidthLeft());
+	CHECK(viewport[2] == impl.getWidthRight());
+
+	/* the GPU is twice too slow */
+	for (int i = 0; i < 60; i++) {
+		CHECK(impl.getFrameState(&state));
+		const float scale = impl.getResolutionScale();
+		impl.setGPUFrameTime(frameTime(2.0 * 0.9 * PERIOD / (1.2f * 1.2f), scale));
+		CHECK(impl.presentFrame());
+	}
+
+	const float scale = impl.getResolutionScale();
+	CHECK_NEAR(scale, 1.2f / sqrtf(2.0f), 0.03);
+
+	/* the right eye stays next to the whole left eye */
+	impl.getEyeViewport(1, viewport);
+	CHECK(viewport[0] == impl.getWidthLeft());
+	CHECK_NEAR(viewport[2], impl.getWidthRight() * scale / 1.2f, 1.0);
+	CHECK_NEAR(viewport[3], impl.getHeightRight() * scale / 1.2f, 1.0);
+
+	/* whole textures again */
+	impl.stopDynamicResolution();
+	impl.getEyeViewport(0, viewport);
+	CHECK(viewport[2] == impl.getWidthLeft());
+	CHECK(viewport[3] == impl.getHeightLeft());
+	CHECK(impl.getResolutionScale() == 1.2f);
+}
+
+static void test_api(void)
+{
+	HMD *hmd = HMD_new(HMD::BACKEND_SIMULATED);
+	HMD_ResolutionConfig resolution = { 0.5f, 1.0f, 0.0f, 0.0 };
+	HMD_FrameState state;
+	int viewport[4];
+
+	state.flags = 0;
+
+	CHECK(HMD_resolutionStart(hmd, &resolution));
+	CHECK(HMD_setup(hmd, 0, 0));
+	CHECK(HMD_resolutionScale(hmd) == 1.0f);
+
+	CHECK(HMD_frameState(hmd, &state));
+	HMD_resolutionGPUTime(hmd, 1.0);
+	CHECK(HMD_frameReady(hmd));
+	CHECK(HMD_resolutionScale(hmd) < 1.0f);
+
+	HMD_eyeViewport(hmd, 0, viewport);
+	CHECK(viewport[2] < (int)HMD_widthLeft(hmd));
+
+	HMD_resolutionStop(hmd);
+	HMD_del(hmd);
+}
+
+int main(void)
+{
+	test_converge();
+	test_spike();
+	test_supersampling();
+	test_viewports();
+	test_api();
+	return 0;
+}
@@ -0,0 +1,150 @@
+/* Device runtime shared by the sessions: initialized once, kept while idle, retried after a failure */
+
+#include "RuntimeContext.h"
+
+#include "test_utils.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/* fake libOVR */
+static std::atomic<int> s_initialize_calls(0);
+static std::atomic<int> s_shutdown_calls(0);
+static bool s_is_available = true;
+
+static bool fakeInitialize(void)
+{
+	s_initialize_calls++;
+	return s_is_available;
+}
+
+static void fakeShutdown(void)
+{
+	s_shutdown_calls++;
+}
+
+static const RuntimeFunctions s_functions = { fakeInitialize, fakeShutdown };
+
+static void reset(void)
+{
+	s_initialize_calls = 0;
+	s_shutdown_calls = 0;
+	s_is_available = true;
+}
+
+static void test_shared(void)
+{
+	reset();
+
+	{
+		RuntimeContext runtime(s_functions);
+		CHECK(!runtime.isInitialized());
+
+		/* two sessions, one initialization */
+		CHECK(runtime.acquire());
+		CHECK(runtime.acquire());
+		CHECK(runtime.getReferences() == 2);
+		CHECK(s_initialize_calls == 1);
+
+		CHECK(!runtime.shutdownIdle());
+		CHECK(runtime.isInitialized());
+
+		runtime.release();
+		runtime.release();
+		CHECK(runtime.getReferences() == 0);
+		CHECK(s_shutdown_calls == 0);
+
+		/* new sessions over and over */
+		for (int i = 0; i < 100; i++) {
+			CHECK(runtime.acquire());
+			runtime.release();
+		}
+		CHECK(s_initialize_calls == 1);
+		CHECK(runtime.getInitializations() == 1);
+		CHECK(s_shutdown_calls == 0);
+
+		/* a release too many is ignored */
+		runtime.release();
+		CHECK(runtime.getReferences() == 0);
+	}
+
+	/* shut down with the library holding it */
+	CHECK(s_shutdown_calls == 1);
+}
+
+static void test_shutdown_idle(void)
+{
+	reset();
+	RuntimeContext runtime(s_functions);
+
+	CHECK(runtime.shutdownIdle());
+	CHECK(s_shutdown_calls == 0);
+
+	CHECK(runtime.acquire());
+	runtime.release();
+	CHECK(runtime.shutdownIdle());
+	CHECK(s_shutdown_calls == 1);
+	CHECK(!runtime.isInitialized());
+
+	/* initialized again by the next session */
+	CHECK(runtime.acquire());
+	CHECK(s_initialize_calls == 2);
+	CHECK(runtime.getInitializations() == 2);
+	runtime.release();
+}
+
+static void test_failure(void)
+{
+	reset();
+	RuntimeContext runtime(s_functions);
+
+	s_is_available = false;
+	CHECK(!runtime.acquire());
+	CHECK(!runtime.acquire());
+	CHECK(runtime.getReferences() == 0);
+	CHECK(!runtime.isInitialized());
+	CHECK(s_initialize_calls == 2);
+
+	/* the runtime was started meanwhile */
+	s_is_available = true;
+	CHECK(runtime.acquire());
+	CHECK(runtime.getInitializations() == 1);
+	runtime.release();
+}
+
+static void test_threads(void)
+{
+	reset();
+
+	{
+		RuntimeContext runtime(s_functions);
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < 4; i++) {
+			threads.push_back(std::thread([&runtime] {
+				for (int j = 0; j < 1000; j++) {
+					CHECK(runtime.acquire());
+					runtime.release();
+				}
+			}));
+		}
+
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+
+		CHECK(runtime.getReferences() == 0);
+		CHECK(s_initialize_calls == 1);
+	}
+	CHECK(s_shutdown_calls == 1);
+}
+
+int main(void)
+{
+	test_shared();
+	test_shutdown_idle();
+	test_failure();
+	test_threads();
+	return 0;
+}
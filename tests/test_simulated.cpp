@@ -0,0 +1,446 @@
+/* Simulated device: deterministic motion, sensor rate, projection and vsync pacing */
+
+#include "Simulated.h"
+
+#include "test_utils.h"
+
+static void configure(HMD_SimulatedConfig *r_config)
+{
+	Simulated::getDefaultConfig(r_config);
+	r_config->is_realtime = 0;
+}
+
+static void test_deterministic(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl a(config), b(config);
+	HMD_FrameState state_a, state_b;
+	state_a.flags = state_b.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION;
+
+	for (int i = 0; i < 100; i++) {
+		CHECK(a.getFrameState(&state_a));
+		CHECK(b.getFrameState(&state_b));
+		CHECK(memcmp(state_a.orientation, state_b.orientation, sizeof(state_a.orientation)) == 0);
+		CHECK(memcmp(state_a.position, state_b.position, sizeof(state_a.position)) == 0);
+		CHECK(a.frameReady());
+		CHECK(b.frameReady());
+	}
+
+	/* another seed only changes the noise */
+	config.seed = 2;
+	SimulatedImpl c(config);
+	float orientation[4], position[3];
+
+	for (int i = 0; i < 100; i++) {
+		CHECK(c.getFrameState(&state_b));
+		CHECK(c.frameReady());
+	}
+
+	CHECK(memcmp(state_a.orientation, state_b.orientation, sizeof(state_a.orientation)) != 0);
+
+	c.getMotion(state_b.display_time, orientation, position);
+	for (int i = 0; i < 4; i++) {
+		CHECK_NEAR(state_b.orientation[0][i], orientation[i], 0.005);
+	}
+}
+
+static void test_rates(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+	config.sensor_rate = 60.0f;
+	config.refresh_rate = 90.0f;
+
+	SimulatedImpl impl(config);
+	HMD_FrameState state;
+	state.flags = 0;
+
+	for (int i = 0; i < 90; i++) {
+		const double vsync = i / 90.0;
+
+		CHECK_NEAR(impl.getTime(), vsync, 1e-9);
+		CHECK(impl.getFrameState(&state));
+
+		/* latest sensor reading before the vsync */
+		CHECK_NEAR(state.display_time, floor(vsync * 60.0 + 1e-6) / 60.0, 1e-9);
+		CHECK(impl.frameReady());
+	}
+
+	CHECK(impl.getPresentedFrames() == 90);
+	CHECK(impl.getMissedFrames() == 0);
+}
+
+static void test_eyes(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+	config.motion = HMD_MOTION_WALK;
+	config.orientation_noise = 0.0f;
+	config.position_noise = 0.0f;
+
+	SimulatedImpl impl(config);
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION;
+
+	CHECK(impl.getWidthLeft() == 1332);
+	CHECK(impl.getHeightRight() == 1586);
+
+	for (int i = 0; i < 300; i++) {
+		CHECK(impl.getFrameState(&state));
+
+		const float dx = state.position[1][0] - state.position[0][0];
+		const float dy = state.position[1][1] - state.position[0][1];
+		const float dz = state.position[1][2] - state.position[0][2];
+		CHECK_NEAR(sqrtf(dx * dx + dy * dy + dz * dz), 0.064, 1e-5);
+
+		CHECK(impl.frameReady());
+	}
+
+	/* walking in a circle stays on it */
+	const float x = 0.5f * (state.position[0][0] + state.position[1][0]);
+	const float z = 0.5f * (state.position[0][2] + state.position[1][2]) + 1.0f;
+	CHECK_NEAR(sqrtf(x * x + z * z), 1.0, 1e-4);
+}
+
+static void test_recenter(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+	config.orientation_noise = 0.0f;
+	config.position_noise = 0.0f;
+
+	SimulatedImpl impl(config);
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_YAW_PITCH_ROLL;
+
+	for (int i = 0; i < 100; i++) {
+		CHECK(impl.frameReady());
+	}
+
+	CHECK(impl.getFrameState(&state));
+	CHECK(fabsf(state.yaw_pitch_roll[0][0]) > 0.1f);
+
+	CHECK(impl.reCenter());
+	CHECK(impl.getFrameState(&state));
+	CHECK_NEAR(state.yaw_pitch_roll[0][0], 0.0, 1e-5);
+}
+
+static void test_projection(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+	float left[16], right[16];
+
+	impl.getProjectionMatrices(0.1f, 100.0f, true, true, left, right);
+
+	/* the eyes are mirrored */
+	CHECK_NEAR(left[0], right[0], 1e-6);
+	CHECK_NEAR(left[8], -right[8], 1e-6);
+	CHECK(left[8] != 0.0f);
+
+	/* the near and far planes map to -1 and 1 */
+	for (int i = 0; i < 2; i++) {
+		const float z = i ? -100.0f : -0.1f;
+		const float clip_z = left[10] * z + left[14];
+		const float clip_w = left[11] * z + left[15];
+		CHECK_NEAR(clip_z / clip_w, i ? 1.0 : -1.0, 1e-4);
+	}
+}
+
+static void test_direct_rendering(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+
+	/* copying from the application textures */
+	CHECK(impl.setup(1, 2));
+	CHECK(impl.acquireEyeTexture(0) == 0);
+	CHECK(!impl.releaseEyeTexture(0));
+
+	CHECK(impl.setup(0, 0));
+
+	const unsigned int left = impl.acquireEyeTexture(0);
+	const unsigned int right = impl.acquireEyeTexture(1);
+	CHECK(left != 0 && right != 0 && left != right);
+
+	/* the texture stays the same until it is released */
+	CHECK(impl.acquireEyeTexture(0) == left);
+	CHECK(impl.releaseEyeTexture(0));
+	CHECK(!impl.releaseEyeTexture(0));
+
+	/* presenting the frame releases the right eye */
+	CHECK(impl.presentFrame());
+	CHECK(!impl.releaseEyeTexture(1));
+
+	const unsigned int next_left = impl.acquireEyeTexture(0);
+	const unsigned int next_right = impl.acquireEyeTexture(1);
+	CHECK(next_left != left && next_right != right);
+	CHECK(impl.presentFrame());
+
+	/* the swap chain wraps around */
+	for (int i = 2; i < SimulatedImpl::SWAP_CHAIN_LENGTH; i++) {
+		impl.acquireEyeTexture(0);
+		CHECK(impl.presentFrame());
+	}
+	CHECK(impl.acquireEyeTexture(0) == left);
+}
+
+static void test_side_by_side(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+	config.width[1] = config.width[0] + 8;
+
+	SimulatedImpl impl(config);
+	int viewport[4];
+
+	/* separate textures */
+	impl.getEyeViewport(1, viewport);
+	CHECK(viewport[0] == 0 && viewport[1] == 0);
+	CHECK(viewport[2] == (int)config.width[1] && viewport[3] == (int)config.height[1]);
+
+	CHECK(impl.setupSideBySide(0));
+
+	/* the right eye is in the right half */
+	impl.getEyeViewport(0, viewport);
+	CHECK(viewport[0] == 0 && viewport[2] == (int)config.width[0]);
+	impl.getEyeViewport(1, viewport);
+	CHECK(viewport[0] == (int)config.width[0] && viewport[2] == (int)config.width[1]);
+
+	/* one texture for both eyes */
+	const unsigned int atlas = impl.acquireEyeTexture(0);
+	CHECK(atlas != 0);
+	CHECK(impl.acquireEyeTexture(1) == atlas);
+
+	/* still in use by the right eye */
+	CHECK(impl.releaseEyeTexture(0));
+	CHECK(impl.acquireEyeTexture(0) == atlas);
+
+	CHECK(impl.presentFrame());
+
+	const unsigned int next = impl.acquireEyeTexture(0);
+	CHECK(next != atlas);
+	CHECK(impl.acquireEyeTexture(1) == next);
+	CHECK(impl.presentFrame());
+}
+
+static void test_multisample(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+
+	CHECK(impl.getSamples() == 1);
+	CHECK(!impl.setSamples(SimulatedImpl::MAX_SAMPLES * 2));
+	CHECK(impl.getSamples() == 1);
+	CHECK(impl.setSamples(4));
+	CHECK(impl.getSamples() == 4);
+	CHECK(impl.setup(0, 0));
+
+	/* the same multisampled texture every frame, one per eye */
+	const unsigned int left = impl.acquireEyeTexture(0);
+	const unsigned int right = impl.acquireEyeTexture(1);
+	CHECK(left != 0 && right != 0 && left != right);
+	CHECK(impl.presentFrame());
+	CHECK(impl.getResolves() == 2);
+
+	CHECK(impl.acquireEyeTexture(0) == left);
+	CHECK(impl.acquireEyeTexture(1) == right);
+	CHECK(impl.presentFrame());
+	CHECK(impl.getResolves() == 4);
+
+	/* not the name of a swap chain texture */
+	CHECK(left > (2 + BackendImpl::MAX_LAYERS) * SimulatedImpl::SWAP_CHAIN_LENGTH);
+
+	/* side by side, a single resolve */
+	SimulatedImpl atlas(config);
+	CHECK(atlas.setSamples(2));
+	CHECK(atlas.setupSideBySide(0));
+	CHECK(atlas.acquireEyeTexture(0) == atlas.acquireEyeTexture(1));
+	CHECK(atlas.presentFrame());
+	CHECK(atlas.getResolves() == 1);
+
+	/* no samples is one */
+	CHECK(atlas.setSamples(0));
+	CHECK(atlas.getSamples() == 1);
+}
+
+static void test_realtime_pacing(void)
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+	/* slow enough for the wake up latency of the scheduler to stay well within a period */
+	config.refresh_rate = 100.0f;
+
+	SimulatedImpl impl(config);
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_VIEW_MATRIX;
+
+	/* the vsync the clock has reached, not the phase within it: that is the wake up latency of
+	 * the scheduler, not the pacing */
+	long long first = -1, last = -1;
+
+	for (int i = 0; i < 20; i++) {
+		CHECK(impl.getFrameState(&state));
+		CHECK(impl.frameReady());
+
+		/* released once the clock crosses a vsync after the previous one */
+		const long long vsync = (long long)floor(impl.getTime() * 100.0 + 1e-3);
+		CHECK(vsync > last);
+
+		if (first < 0) {
+			first = vsync;
+		}
+		last = vsync;
+	}
+
+	/* at most one frame per vsync */
+	CHECK(last - first >= 19);
+	CHECK(impl.getPresentedFrames() == 20);
+}
+
+static void test_frame_loop(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	SimulatedImpl impl(config);
+	HMD_FrameTiming timing;
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_VIEW_MATRIX;
+
+	for (int i = 0; i < 3; i++) {
+		CHECK(impl.waitFrame(&timing));
+		CHECK(timing.should_render);
+		CHECK_NEAR(timing.period, 1.0 / config.refresh_rate, 1e-9);
+
+		/* displayed on the vsync after the current one */
+		CHECK_NEAR(timing.predicted_display_time, (i + 1) / (double)config.refresh_rate, 1e-9);
+
+		CHECK(impl.beginFrame(&state));
+		CHECK(state.frame == timing.frame);
+		CHECK(state.frame == (unsigned int)i);
+		CHECK(impl.endFrame());
+	}
+
+	/* in realtime, the loop runs at the refresh rate and the frames are on time */
+	config.is_realtime = 1;
+	config.refresh_rate = 100.0f;
+	SimulatedImpl realtime(config);
+	double last = 0.0;
+
+	for (int i = 0; i < 10; i++) {
+		CHECK(realtime.waitFrame(&timing));
+
+		const double ahead = timing.predicted_display_time - realtime.getTime();
+		CHECK(ahead > 0.0 && ahead <= timing.period);
+		CHECK(i == 0 || timing.predicted_display_time > last);
+		last = timing.predicted_display_time;
+
+		CHECK(realtime.beginFrame(&state));
+		CHECK(realtime.endFrame());
+	}
+	CHECK(last >= 10 * timing.period);
+}
+
+static void test_async_submit(void)
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+	config.refresh_rate = 100.0f;
+
+	SimulatedImpl impl(config);
+	HMD_FrameState state;
+	HMD_SubmitStats stats;
+	state.flags = HMD_FRAME_VIEW_MATRIX;
+
+	CHECK(impl.setup(0, 0));
+	CHECK(impl.startAsyncSubmit());
+	CHECK(!impl.startAsyncSubmit());
+
+	/* the previous frame is still waiting for its vsync */
+	const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.acquireEyeTexture(0) != 0);
+	CHECK(impl.presentFrame());
+	CHECK(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(5));
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(impl.getFrameState(&state));
+		const unsigned int texture = impl.acquireEyeTexture(0);
+		CHECK(texture != 0);
+		CHECK(impl.presentFrame());
+		CHECK(impl.acquireEyeTexture(0) != texture);
+		CHECK(impl.releaseEyeTexture(0));
+	}
+
+	/* the frame in flight is submitted */
+	impl.stopAsyncSubmit();
+	CHECK(!impl.isSubmitThreaded());
+	CHECK(impl.getPresentedFrames() == 5);
+
+	impl.getSubmitStats(&stats);
+	CHECK(stats.frames == 5);
+	CHECK(stats.stalls >= 3);
+	/* not faster than the vsync, the upper bound is the scheduler's */
+	CHECK(stats.submit_interval > 0.5 / 100.0);
+	CHECK(stats.submit_time_average > 0.0);
+
+	/* back to submitting right away */
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.presentFrame());
+	impl.getSubmitStats(&stats);
+	CHECK(stats.frames == 6);
+	CHECK(stats.wait_time == stats.submit_time);
+}
+
+static void test_api(void)
+{
+	HMD_SimulatedConfig config;
+	HMD_simulatedConfigDefault(&config);
+	config.is_realtime = 0;
+
+	HMD *hmd = HMD_newSimulated(&config);
+	HMD_FrameState state;
+	float matrix[16];
+
+	state.flags = HMD_FRAME_VIEW_MATRIX;
+	CHECK(HMD_samplesSet(hmd, 4));
+	CHECK(HMD_samplesGet(hmd) == 4);
+	CHECK(HMD_setup(hmd, 0, 0));
+	CHECK(HMD_frameState(hmd, &state));
+	CHECK(HMD_frameReady(hmd));
+	CHECK(HMD_widthLeft(hmd) == 1332);
+
+	HMD_projectionMatrixLeft(hmd, 0.1f, 100.0f, matrix);
+	CHECK(matrix[0] > 0.0f);
+	HMD_del(hmd);
+
+	hmd = HMD_new(HMD::BACKEND_SIMULATED);
+	CHECK(HMD_frameState(hmd, &state));
+	HMD_del(hmd);
+}
+
+int main(void)
+{
+	test_deterministic();
+	test_rates();
+	test_eyes();
+	test_recenter();
+	test_projection();
+	test_direct_rendering();
+	test_side_by_side();
+	test_multisample();
+	test_realtime_pacing();
+	test_frame_loop();
+	test_async_submit();
+	test_api();
+	return 0;
+}
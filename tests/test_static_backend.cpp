@@ -0,0 +1,81 @@
+/* Backend bound at compile time: the same frames as the one dispatched at runtime */
+
+#include "HMDT.h"
+#include "Simulated.h"
+
+#include "test_utils.h"
+
+static void configure(HMD_SimulatedConfig *r_config)
+{
+	Simulated::getDefaultConfig(r_config);
+	r_config->is_realtime = 0;
+}
+
+static void test_same_frames(void)
+{
+	HMD_SimulatedConfig config;
+	configure(&config);
+
+	HMDT<SimulatedImpl> bound(config);
+	Simulated dispatched(&config);
+	HMD_FrameState state_bound, state_dispatched;
+	state_bound.flags = state_dispatched.flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION | HMD_FRAME_VIEW_MATRIX;
+
+	CHECK(bound.getWidthLeft() == dispatched.getWidthLeft());
+	CHECK(bound.getHeightRight() == dispatched.getHeightRight());
+	CHECK(bound.setup(0, 0));
+	CHECK(dispatched.setup(0, 0));
+
+	for (int i = 0; i < 100; i++) {
+		CHECK(bound.getFrameState(&state_bound));
+		CHECK(dispatched.getFrameState(&state_dispatched));
+		CHECK(state_bound.frame == state_dispatched.frame);
+		CHECK(memcmp(state_bound.orientation, state_dispatched.orientation, sizeof(state_bound.orientation)) == 0);
+		CHECK(memcmp(state_bound.position, state_dispatched.position, sizeof(state_bound.position)) == 0);
+		CHECK(memcmp(state_bound.view_matrix, state_dispatched.view_matrix, sizeof(state_bound.view_matrix)) == 0);
+		CHECK(bound.frameReady());
+		CHECK(dispatched.frameReady());
+	}
+
+	float bound_matrix[2][16], dispatched_matrix[2][16];
+	bound.getProjectionMatrices(0.1f, 100.0f, true, true, bound_matrix[0], bound_matrix[1]);
+	dispatched.getProjectionMatrices(0.1f, 100.0f, true, true, dispatched_matrix[0], dispatched_matrix[1]);
+	CHECK(memcmp(bound_matrix, dispatched_matrix, sizeof(bound_matrix)) == 0);
+
+	/* legacy routines, one frame each */
+	float orientation[2][4], position[2][3];
+	CHECK(bound.update(orientation[0], position[0], orientation[1], position[1]));
+	CHECK(memcmp(orientation, state_bound.orientation, sizeof(orientation)) != 0);
+	CHECK(bound.getFrameState(&state_bound));
+	CHECK(state_bound.frame == 101);
+
+	/* the other routines are the ones of the implementation */
+	CHECK(bound.getImpl().startTracking(1000.0f));
+}
+
+static void test_api(void)
+{
+#if defined STATIC_BACKEND
+	HMDStatic *hmd = HMDStatic_new();
+	HMD_FrameState state;
+	float view[2][16], projection[2][16];
+
+	state.flags = HMD_FRAME_ORIENTATION;
+
+	CHECK(HMDStatic_widthLeft(hmd) > 0);
+	CHECK(HMDStatic_setup(hmd, 0, 0));
+	CHECK(HMDStatic_frameState(hmd, &state));
+	CHECK(HMDStatic_viewMatrix(hmd, true, view[0], view[1]));
+	HMDStatic_projectionMatrices(hmd, 0.1f, 100.0f, projection[0], projection[1]);
+	CHECK(projection[0][0] > 0.0f);
+	CHECK(HMDStatic_frameReady(hmd));
+	HMDStatic_del(hmd);
+#endif
+}
+
+int main(void)
+{
+	test_same_frames();
+	test_api();
+	return 0;
+}
@@ -0,0 +1,158 @@
+/* Recording of the tracking samples to a trace file */
+
+#include "Simulated.h"
+#include "Trace.h"
+
+#include "test_utils.h"
+
+#include <stdio.h>
+
+#define TRACE_PATH "test_trace.hmdtrace"
+
+static void test_queue(void)
+{
+	SpscQueue<int, 4> queue;
+	int value;
+
+	CHECK(queue.empty());
+	CHECK(!queue.pop(&value));
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(queue.push(i));
+	}
+	CHECK(!queue.push(4));
+
+	CHECK(queue.pop(&value) && value == 0);
+	CHECK(queue.push(4));
+
+	for (int i = 1; i < 5; i++) {
+		CHECK(queue.pop(&value) && value == i);
+	}
+	CHECK(queue.empty());
+}
+
+static SimulatedImpl *newSimulated(const bool is_realtime)
+{
+	HMD_SimulatedConfig config;
+	Simulated::getDefaultConfig(&config);
+	config.is_realtime = is_realtime ? 1 : 0;
+	return new SimulatedImpl(config);
+}
+
+static void test_record(void)
+{
+	SimulatedImpl *impl = newSimulated(false);
+	HMD_FrameState states[500];
+
+	CHECK(impl->startRecording(TRACE_PATH));
+	CHECK(impl->isRecording());
+
+	for (int i = 0; i < 500; i++) {
+		states[i].flags = HMD_FRAME_ORIENTATION | HMD_FRAME_POSITION;
+		CHECK(impl->getFrameState(&states[i]));
+		CHECK(impl->frameReady());
+	}
+
+	impl->stopRecording();
+	CHECK(!impl->isRecording());
+
+	/* not recorded anymore */
+	HMD_FrameState state;
+	state.flags = 0;
+	CHECK(impl->getFrameState(&state));
+	delete impl;
+
+	TraceReader reader;
+	CHECK(reader.open(TRACE_PATH));
+	CHECK(reader.getCount() == 500);
+	CHECK(reader.getDropped() == 0);
+
+	for (int i = 0; i < 500; i++) {
+		const TraceRecord &record = reader.getRecord(i);
+
+		CHECK(record.frame == states[i].frame);
+		CHECK(record.time == states[i].display_time);
+		CHECK(record.status == (HMD_STATUS_ORIENTATION_TRACKED | HMD_STATUS_POSITION_TRACKED));
+		CHECK(memcmp(record.orientation, states[i].orientation, sizeof(record.orientation)) == 0);
+		CHECK(memcmp(record.position, states[i].position, sizeof(record.position)) == 0);
+	}
+	reader.close();
+}
+
+static void test_grow(void)
+{
+	SimulatedImpl *impl = newSimulated(false);
+	HMD_FrameState state;
+	state.flags = 0;
+
+	/* more than the queue and the initial mapping hold, as fast as possible */
+	CHECK(impl->startRecording(TRACE_PATH));
+	for (int i = 0; i < 20000; i++) {
+		CHECK(impl->getFrameState(&state));
+	}
+	impl->stopRecording();
+	delete impl;
+
+	TraceReader reader;
+	CHECK(reader.open(TRACE_PATH));
+	CHECK(reader.getCount() + reader.getDropped() == 20000);
+	CHECK(reader.getCount() > 4096);
+
+	/* the frames keep their order, even with some of them dropped */
+	for (unsigned long long i = 1; i < reader.getCount(); i++) {
+		CHECK(reader.getRecord(i).frame > reader.getRecord(i - 1).frame);
+	}
+	reader.close();
+}
+
+static void test_tracking_thread(void)
+{
+	SimulatedImpl *impl = newSimulated(true);
+
+	CHECK(impl->startRecording(TRACE_PATH));
+	CHECK(impl->startTracking(1000.0f));
+
+	for (int i = 0; i < 5; i++) {
+		HMD_FrameState state;
+		state.flags = HMD_FRAME_VIEW_MATRIX;
+		impl->getFrameState(&state);
+		impl->frameReady();
+	}
+
+	impl->stopTracking();
+	const unsigned long long samples = impl->getTrackingSampleCount();
+	impl->stopRecording();
+	delete impl;
+
+	/* every sample of the tracking thread, none of the render thread */
+	TraceReader reader;
+	CHECK(reader.open(TRACE_PATH));
+	CHECK(samples > 0);
+	CHECK(reader.getCount() + reader.getDropped() == samples);
+	reader.close();
+}
+
+static void test_invalid(void)
+{
+	TraceReader reader;
+	CHECK(!reader.open("does_not_exist.hmdtrace"));
+
+	FILE *file = fopen(TRACE_PATH, "wb");
+	fputs("not a trace file, but long enough for a header", file);
+	fclose(file);
+
+	CHECK(!reader.open(TRACE_PATH));
+	CHECK(!reader.isOpen());
+}
+
+int main(void)
+{
+	test_queue();
+	test_record();
+	test_grow();
+	test_tracking_thread();
+	test_invalid();
+
+	remove(TRACE_PATH);
+	return 0;
+}
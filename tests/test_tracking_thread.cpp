@@ -0,0 +1,155 @@
+/* Tracking thread and the sequence-locked pose ring it publishes to */
+
+#include "Backend.h"
+#include "Stub.h"
+
+#include "test_utils.h"
+
+#include <stddef.h>
+
+/* every field of the sample holds the same value, so torn reads are detectable */
+static void fillSample(PoseSample *r_sample, const unsigned int value)
+{
+	float *data = &r_sample->head_orientation[0];
+	const size_t count = (sizeof(PoseSample) - offsetof(PoseSample, head_orientation)) / sizeof(float);
+
+	r_sample->time = value;
+	r_sample->frame = value;
+	r_sample->status = HMD_STATUS_ORIENTATION_TRACKED;
+
+	for (size_t i = 0; i < count; i++) {
+		data[i] = (float)value;
+	}
+}
+
+static bool isConsistent(const PoseSample &sample)
+{
+	const float *data = &sample.head_orientation[0];
+	const size_t count = (sizeof(PoseSample) - offsetof(PoseSample, head_orientation)) / sizeof(float);
+
+	for (size_t i = 0; i < count; i++) {
+		if (data[i] != (float)sample.frame) {
+			return false;
+		}
+	}
+	return sample.time == sample.frame;
+}
+
+class ThreadedImpl : public FakeImpl
+{
+public:
+	std::atomic<unsigned int> samples;
+	std::thread::id sampler;
+
+	ThreadedImpl() : samples(0) {}
+
+	bool sampleTracking(const unsigned int, PoseSample *r_sample)
+	{
+		this->sampler = std::this_thread::get_id();
+		fillSample(r_sample, ++this->samples);
+		return true;
+	}
+};
+
+static void test_ring(void)
+{
+	PoseRing<PoseSample, 4> ring;
+	PoseSample sample;
+
+	CHECK(!ring.readLatest(&sample));
+
+	for (unsigned int i = 1; i <= 6; i++) {
+		fillSample(&sample, i);
+		ring.publish(sample);
+	}
+
+	CHECK(ring.count() == 6);
+	CHECK(ring.readLatest(&sample));
+	CHECK(sample.frame == 6);
+
+	/* the oldest values were overwritten */
+	CHECK(!ring.read(0, &sample));
+	CHECK(!ring.read(1, &sample));
+	CHECK(ring.read(2, &sample));
+	CHECK(sample.frame == 3);
+	CHECK(!ring.read(6, &sample));
+}
+
+static void test_concurrent_reads(void)
+{
+	PoseRing<PoseSample, 4> ring;
+	std::atomic<bool> running(true);
+
+	std::thread writer([&]() {
+		PoseSample sample;
+		for (unsigned int i = 1; running; i++) {
+			fillSample(&sample, i);
+			ring.publish(sample);
+		}
+	});
+
+	unsigned int last = 0;
+	for (int i = 0; i < 200000; i++) {
+		PoseSample sample;
+		if (ring.readLatest(&sample)) {
+			CHECK(isConsistent(sample));
+			CHECK(sample.frame >= last);
+			last = sample.frame;
+		}
+	}
+
+	running = false;
+	writer.join();
+}
+
+static void test_backend_thread(void)
+{
+	ThreadedImpl impl;
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_ORIENTATION;
+
+	CHECK(impl.startTracking(1000.0f));
+	CHECK(impl.isTrackingThreaded());
+	CHECK(!impl.startTracking(1000.0f));
+
+	while (impl.getTrackingSampleCount() < 3) {
+		std::this_thread::yield();
+	}
+
+	/* the render thread reads the published samples */
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.sampler != std::this_thread::get_id());
+	CHECK(state.orientation[0][0] >= 3.0f);
+
+	impl.stopTracking();
+	CHECK(!impl.isTrackingThreaded());
+
+	/* back to querying the tracking on the calling thread */
+	CHECK(impl.getFrameState(&state));
+	CHECK(impl.sampler == std::this_thread::get_id());
+}
+
+static void test_stub_backend(void)
+{
+	Stub stub;
+	HMD_FrameState state;
+	state.flags = HMD_FRAME_ORIENTATION;
+
+	CHECK(stub.startTracking(500.0f));
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	/* the stub never tracks, but the samples still flow through the ring */
+	CHECK(!stub.getFrameState(&state));
+	CHECK(state.status == 0);
+
+	/* the destructor stops the thread */
+}
+
+int main(void)
+{
+	test_ring();
+	test_concurrent_reads();
+	test_backend_thread();
+	test_stub_backend();
+	return 0;
+}
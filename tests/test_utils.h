@@ -0,0 +1,42 @@
+#ifndef __TEST_UTILS_H__
+#define __TEST_UTILS_H__
+
+#include "Backend.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* minimal assertion helpers, the tests return non-zero on the first failure */
+
+/* returned by a test that can't run on the machine, its SKIP_RETURN_CODE in CMake */
+#define TEST_SKIPPED 77
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			exit(1); \
+		} \
+	} while (0)
+
+#define CHECK_NEAR(a, b, eps) \
+	do { \
+		const double _a = (a), _b = (b); \
+		if (fabs(_a - _b) > (eps)) { \
+			fprintf(stderr, "%s:%d: check failed: %s == %s (%g != %g)\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+			exit(1); \
+		} \
+	} while (0)
+
+/* backend without a device, the fakes of the tests only provide the tracking */
+class FakeImpl : public BackendImpl
+{
+public:
+	bool setup(const unsigned int, const unsigned int) { return true; }
+	bool frameReady(void) { return true; }
+	bool reCenter(void) { return true; }
+	void computeProjectionMatrix(const int, const float, const float, const bool, const bool, float *) {}
+};
+
+#endif /* __TEST_UTILS_H__ */
@@ -0,0 +1,126 @@
+/* Stereo view matrix kernel against the scalar path and the original LookAt path */
+
+#include "ViewMatrix.h"
+
+#include "reference_view_matrix.h"
+#include "test_utils.h"
+
+#include <string.h>
+
+static unsigned int seed = 12345;
+
+static float random(const float min, const float max)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return min + (max - min) * ((seed >> 8) / 16777216.0f);
+}
+
+static void randomSample(PoseSample *r_sample, const float scale)
+{
+	memset(r_sample, 0, sizeof(PoseSample));
+
+	for (int eye = 0; eye < 2; eye++) {
+		float *q = r_sample->orientation[eye];
+		float len = 0.0f;
+
+		for (int i = 0; i < 4; i++) {
+			q[i] = random(-1.0f, 1.0f);
+			len += q[i] * q[i];
+		}
+
+		/* not exactly unit quaternions, like the ones coming from the devices */
+		len = sqrtf(len) / scale;
+		for (int i = 0; i < 4; i++) {
+			q[i] /= len;
+		}
+
+		for (int i = 0; i < 3; i++) {
+			r_sample->position[eye][i] = random(-5.0f, 5.0f);
+		}
+	}
+}
+
+static double maxDifference(const float *a, const float *b)
+{
+	double difference = 0.0;
+	for (int i = 0; i < 16; i++) {
+		const double d = fabs(a[i] - b[i]);
+		difference = d > difference ? d : difference;
+	}
+	return difference;
+}
+
+static void test_against_references(void)
+{
+	double scalar_max = 0.0, reference_max = 0.0;
+
+	for (int i = 0; i < 10000; i++) {
+		PoseSample sample;
+		randomSample(&sample, random(0.999f, 1.001f));
+
+		for (int hand = 0; hand < 2; hand++) {
+			const bool is_right_hand = hand == 1;
+			float kernel[2][16], scalar[2][16], reference[16];
+
+			poseStereoViewMatrix(sample, is_right_hand, kernel);
+			poseStereoViewMatrixScalar(sample, is_right_hand, scalar);
+
+			for (int eye = 0; eye < 2; eye++) {
+				referenceViewMatrix(sample.orientation[eye], sample.position[eye], is_right_hand, reference);
+
+				const double scalar_difference = maxDifference(kernel[eye], scalar[eye]);
+				const double reference_difference = maxDifference(kernel[eye], reference);
+
+				scalar_max = scalar_difference > scalar_max ? scalar_difference : scalar_max;
+				reference_max = reference_difference > reference_max ? reference_difference : reference_max;
+
+				/* the last row is exact */
+				CHECK(kernel[eye][3] == 0.0f && kernel[eye][7] == 0.0f && kernel[eye][11] == 0.0f && kernel[eye][15] == 1.0f);
+			}
+		}
+	}
+
+	/* translations up to ~9 m, a few ulps of difference */
+	printf("max difference: scalar %g, LookAt %g\n", scalar_max, reference_max);
+	CHECK(scalar_max < 1e-5);
+	CHECK(reference_max < 2e-5);
+}
+
+static void test_identity(void)
+{
+	PoseSample sample;
+	float matrix[2][16];
+
+	memset(&sample, 0, sizeof(sample));
+	sample.orientation[0][0] = sample.orientation[1][0] = 1.0f;
+	sample.position[1][0] = 0.064f;
+
+	poseStereoViewMatrix(sample, true, matrix);
+
+	for (int i = 0; i < 16; i++) {
+		CHECK(matrix[0][i] == ((i % 5) == 0 ? 1.0f : 0.0f));
+	}
+	CHECK_NEAR(matrix[1][12], -0.064, 1e-7);
+}
+
+int main(void)
+{
+#if defined(BRIDGE_VIEW_MATRIX_AVX)
+#if defined(__GNUC__)
+	/* test_view_matrix_avx is built whatever the machine */
+	if (!__builtin_cpu_supports("avx")) {
+		printf("no AVX, skipped\n");
+		return TEST_SKIPPED;
+	}
+#endif
+	printf("AVX kernel\n");
+#elif defined(BRIDGE_VIEW_MATRIX_SSE)
+	printf("SSE kernel\n");
+#else
+	printf("scalar kernel\n");
+#endif
+
+	test_identity();
+	test_against_references();
+	return 0;
+}